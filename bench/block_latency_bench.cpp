@@ -0,0 +1,227 @@
+// Per-block processing time distribution of the engine under host-like
+// stress, to catch deadline misses that averages hide: coefficient
+// redesigns on automation, parameter storms, denormal tails after silence,
+// mode switches and the first blocks of a fresh instance (page faults,
+// lazy initialisation), with and without the activation warm-up.
+//
+// Every scenario times each Engine::process call on its own and prints
+// p50/p99/p99.9/max in microseconds, next to the real-time budget of one
+// block and the number of blocks that used more than budgetFraction of it.
+//
+//   block_latency_bench [budgetFraction] [blockSize] [sampleRate] [seconds]
+//
+// Exits non-zero when any block crossed the threshold.
+//
+// "silence" guards the denormal cliff: without flush-to-zero in
+// Engine::process its p99 was about 5x that of "loud-after-silence".
+
+#include "engine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace SvenderBass;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Config {
+  double budgetFraction = 0.5;
+  int blockSize = 128;
+  double sampleRate = 48000.0;
+  double seconds = 5.0;
+};
+
+struct Run {
+  std::vector<double> us;
+  void add(Clock::time_point t0, Clock::time_point t1) {
+    us.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+  }
+};
+
+class Host {
+public:
+  explicit Host(const Config& cfg)
+      : cfg_(cfg), inL_(cfg.blockSize), inR_(cfg.blockSize), outL_(cfg.blockSize), outR_(cfg.blockSize) {
+    engine_ = std::make_unique<Engine>();
+    engine_->configure(cfg.sampleRate, cfg.blockSize);
+  }
+
+  Engine& engine() { return *engine_; }
+  float level = 0.5f;
+
+  // Parameter changes are applied inside the timed region, as the plugin
+  // applies them at the top of process().
+  template <class Params>
+  void block(Run& run, Params&& params) {
+    const int n = cfg_.blockSize;
+    for (int i = 0; i < n; ++i) {
+      phase_ += 2.0 * DSP::kPiD * 55.0 / cfg_.sampleRate;
+      inL_[i] = level * (float)(std::sin(phase_) + 0.3 * std::sin(7.1 * phase_));
+      inR_[i] = level * (float)std::sin(1.5 * phase_);
+    }
+    const auto t0 = Clock::now();
+    params(*engine_);
+    engine_->process(inL_.data(), inR_.data(), outL_.data(), outR_.data(), n);
+    const auto t1 = Clock::now();
+    run.add(t0, t1);
+
+    svender_dsp_meters m;
+    while (engine_->popMeters(m)) {}
+  }
+
+  int blocks() const { return (int)(cfg_.seconds * cfg_.sampleRate / cfg_.blockSize); }
+
+private:
+  Config cfg_;
+  std::unique_ptr<Engine> engine_;
+  std::vector<float> inL_, inR_, outL_, outR_;
+  double phase_ = 0.0;
+};
+
+void noParams(Engine&) {}
+
+// Two seconds of silence, in which filter and envelope state decays into
+// the denormal range, then a second at full scale; repeated. Only the
+// blocks of one phase are timed, so a slow phase is not averaged away by
+// the other.
+void silenceLoud(const Config& cfg, Run& r, bool timeSilence) {
+  Host h(cfg);
+  Run untimed;
+  const int period = (int)(cfg.sampleRate / cfg.blockSize);
+  for (int b = 0; b < h.blocks(); ++b) {
+    const bool loud = (b / period) % 3 == 2;
+    h.level = loud ? 1.0f : 0.0f;
+    h.block(loud == timeSilence ? untimed : r, noParams);
+  }
+}
+
+double percentile(std::vector<double>& v, double p) {
+  const size_t k = std::min(v.size() - 1, (size_t)std::floor(p * (double)(v.size() - 1) + 0.5));
+  std::nth_element(v.begin(), v.begin() + k, v.end());
+  return v[k];
+}
+
+struct Scenario {
+  const char* name;
+  void (*run)(const Config& cfg, Run& r);
+};
+
+const Scenario kScenarios[] = {
+  { "steady", [](const Config& cfg, Run& r) {
+      Host h(cfg);
+      for (int b = 0; b < h.blocks(); ++b) h.block(r, noParams);
+    } },
+  { "automation-every-param", [](const Config& cfg, Run& r) {
+      // Smooth automation on every continuous and stepped parameter.
+      Host h(cfg);
+      for (int b = 0; b < h.blocks(); ++b)
+        h.block(r, [&](Engine& e) {
+          for (int id = 0; id < SVENDER_PARAM_COUNT; ++id)
+            if (id != SVENDER_PARAM_TUNER)
+              e.setParam(id, 0.5 + 0.5 * std::sin(0.003 * b * (id + 1)));
+        });
+    } },
+  { "param-storm", [](const Config& cfg, Run& r) {
+      // Sixteen random points per parameter per block.
+      Host h(cfg);
+      std::mt19937 rng(3);
+      std::uniform_real_distribution<double> u(0.0, 1.0);
+      for (int b = 0; b < h.blocks(); ++b)
+        h.block(r, [&](Engine& e) {
+          for (int p = 0; p < 16; ++p)
+            for (int id = 0; id < SVENDER_PARAM_COUNT; ++id)
+              if (id != SVENDER_PARAM_TUNER)
+                e.setParam(id, u(rng));
+        });
+    } },
+  { "silence", [](const Config& cfg, Run& r) { silenceLoud(cfg, r, true); } },
+  { "loud-after-silence", [](const Config& cfg, Run& r) { silenceLoud(cfg, r, false); } },
+  { "mode-switches", [](const Config& cfg, Run& r) {
+      Host h(cfg);
+      for (int b = 0; b < h.blocks(); ++b)
+        h.block(r, [&](Engine& e) {
+          if (b % 5 == 0) e.setParam(SVENDER_PARAM_SAT_MODE, (b / 5 % 5) / 4.0);
+          if (b % 7 == 0) e.setParam(SVENDER_PARAM_CROSSOVER, (b / 7 % 5) / 4.0);
+          if (b % 11 == 0) e.setParam(SVENDER_PARAM_ULTRA_LOW, (b / 11) % 2);
+          if (b % 13 == 0) e.setParam(SVENDER_PARAM_ULTRA_HIGH, (b / 13) % 2);
+          if (b % 17 == 0) e.setParam(SVENDER_PARAM_TONE_STACK, (b / 17) % 2);
+        });
+    } },
+  { "cold-start", [](const Config& cfg, Run& r) {
+      // The first blocks of fresh instances, as after a session load.
+      constexpr int kInstances = 64;
+      constexpr int kBlocksEach = 8;
+      for (int i = 0; i < kInstances; ++i) {
+        Host h(cfg);
+        for (int b = 0; b < kBlocksEach; ++b) h.block(r, noParams);
+      }
+    } },
+  { "warm-start", [](const Config& cfg, Run& r) {
+      // The same, activated as the plugin does it, with Engine::warmUp.
+      constexpr int kInstances = 64;
+      constexpr int kBlocksEach = 8;
+      for (int i = 0; i < kInstances; ++i) {
+        Host h(cfg);
+        h.engine().warmUp();
+        for (int b = 0; b < kBlocksEach; ++b) h.block(r, noParams);
+      }
+    } },
+  { "rearm", [](const Config& cfg, Run& r) {
+      // Tracks armed mid-performance: instances deactivated while others
+      // ran, then reactivated (reset and warm-up) and timed on their first
+      // blocks. The other instances keep evicting their caches.
+      constexpr int kInstances = 16;
+      std::vector<std::unique_ptr<Host>> hosts;
+      for (int i = 0; i < kInstances; ++i)
+        hosts.push_back(std::make_unique<Host>(cfg));
+      Run untimed;
+      for (int round = 0; round < 32; ++round) {
+        Host& armed = *hosts[round % kInstances];
+        armed.engine().reset();
+        armed.engine().warmUp();
+        armed.block(r, noParams);
+        for (auto& h : hosts)
+          h->block(untimed, noParams);
+      }
+    } },
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Config cfg;
+  if (argc > 1) cfg.budgetFraction = std::atof(argv[1]);
+  if (argc > 2) cfg.blockSize = std::max(1, std::atoi(argv[2]));
+  if (argc > 3) cfg.sampleRate = std::atof(argv[3]);
+  if (argc > 4) cfg.seconds = std::atof(argv[4]);
+
+  const double budgetUs = 1e6 * cfg.blockSize / cfg.sampleRate;
+  const double limitUs = budgetUs * cfg.budgetFraction;
+
+  std::printf("# block %d @ %.0f Hz: budget %.1f us, flagging > %.0f%% (%.1f us)\n", cfg.blockSize,
+              cfg.sampleRate, budgetUs, 100.0 * cfg.budgetFraction, limitUs);
+  std::printf("scenario,blocks,p50_us,p99_us,p99.9_us,max_us,max_budget_fraction,over_limit\n");
+
+  int flagged = 0;
+  for (const Scenario& s : kScenarios) {
+    Run r;
+    s.run(cfg, r);
+    const int over = (int)std::count_if(r.us.begin(), r.us.end(), [&](double t) { return t > limitUs; });
+    const double maxUs = *std::max_element(r.us.begin(), r.us.end());
+    const double p50 = percentile(r.us, 0.5);
+    const double p99 = percentile(r.us, 0.99);
+    const double p999 = percentile(r.us, 0.999);
+    std::printf("%s,%zu,%.2f,%.2f,%.2f,%.2f,%.3f,%d\n", s.name, r.us.size(), p50, p99, p999, maxUs,
+                maxUs / budgetUs, over);
+    flagged += over;
+  }
+  return flagged ? 1 : 0;
+}
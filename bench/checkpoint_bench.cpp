@@ -0,0 +1,188 @@
+// Checkpointed renders (Engine::saveSnapshot / restoreSnapshot).
+//
+// One engine renders a bass line with stepped automation straight through
+// and saves a checkpoint every few seconds on the way. Then every chunk
+// between two checkpoints is rendered again, all at once on their own
+// threads, each by a fresh engine restored from the checkpoint at its start,
+// as a split render or a resumed job would. The chunks must reproduce the
+// straight render, audio and meter frames, bit for bit. Checkpoints fall
+// while EQ ramps, drive and sag are still moving.
+//
+// The bench prints the snapshot size, the time to save and restore one, and
+// the straight and chunked render times per frame, for stereo, mono, the
+// tone stack, the fixed internal rate and the pipelined chain.
+//
+//   checkpoint_bench [seconds] [blockSize] [chunkSeconds]
+//
+// Exits non-zero when any chunk differs from the straight render.
+
+#include "engine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace SvenderBass;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Scenario {
+  const char* name;
+  double sampleRate;
+  bool stereo;
+  bool toneStack;
+  bool fixedRate;
+  bool pipelined;
+};
+
+constexpr Scenario kScenarios[] = {
+  { "stereo",        48000.0, true,  false, false, false },
+  { "mono",          48000.0, false, false, false, false },
+  { "tone-stack",    48000.0, true,  true,  false, false },
+  { "internal-rate", 96000.0, true,  false, true,  false },
+  { "pipelined",     48000.0, true,  false, false, true  },
+};
+
+struct Chunk {
+  int begin = 0, end = 0;
+  std::vector<unsigned char> snapshot;
+  std::vector<float> l, r;
+  std::vector<svender_dsp_meters> meters;
+};
+
+double seconds(Clock::time_point t0) { return std::chrono::duration<double>(Clock::now() - t0).count(); }
+
+void setup(Engine& e, const Scenario& sc, int blockSize) {
+  e.setPipelined(sc.pipelined);
+  e.setFixedInternalRate(sc.fixedRate);
+  e.configure(sc.sampleRate, blockSize);
+  e.setParam(SVENDER_PARAM_TONE_STACK, sc.toneStack ? 1.0 : 0.0);
+}
+
+// A step on a few parameters every 0.7 s, keyed on the block start only, so
+// a resumed render replays exactly the changes the straight one saw.
+void automate(Engine& e, int n, int blockSize, double sampleRate) {
+  const int stepEvery = (int)(0.7 * sampleRate);
+  const int step = n / stepEvery;
+  if (n > 0 && (n - blockSize) / stepEvery == step)
+    return;
+  e.setParam(SVENDER_PARAM_DRIVE, 0.2 + 0.15 * (step % 5));
+  e.setParam(SVENDER_PARAM_BASS, 0.3 + 0.1 * (step % 4));
+  e.setParam(SVENDER_PARAM_MID, 0.7 - 0.15 * (step % 3));
+  e.setParam(SVENDER_PARAM_CROSSOVER, (step % 3) * 0.25);
+}
+
+// Renders [c.begin, c.end) from e's current state into c.
+void renderChunk(Engine& e, const Scenario& sc, int blockSize, const std::vector<float>& inL,
+                 const std::vector<float>& inR, Chunk& c) {
+  c.l.resize(c.end - c.begin);
+  c.r.resize(sc.stereo ? c.end - c.begin : 0);
+  for (int n = c.begin; n < c.end; n += blockSize) {
+    automate(e, n, blockSize, sc.sampleRate);
+    const int len = std::min(blockSize, c.end - n);
+    if (sc.stereo)
+      e.process(&inL[n], &inR[n], &c.l[n - c.begin], &c.r[n - c.begin], len);
+    else
+      e.processMono(&inL[n], &c.l[n - c.begin], len);
+    svender_dsp_meters m;
+    while (e.popMeters(m))
+      c.meters.push_back(m);
+  }
+}
+
+bool identical(const Chunk& a, const Chunk& b) {
+  return a.l == b.l && a.r == b.r && a.meters.size() == b.meters.size() &&
+         std::memcmp(a.meters.data(), b.meters.data(), a.meters.size() * sizeof(svender_dsp_meters)) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const double totalSeconds = argc > 1 ? std::atof(argv[1]) : 12.0;
+  const int blockSize = argc > 2 ? std::max(1, std::atoi(argv[2])) : 1024;
+  const double chunkSeconds = argc > 3 ? std::atof(argv[3]) : 2.5;
+
+  std::printf("# %.0f s, block %d, a checkpoint every %.1f s; %u hardware threads\n", totalSeconds, blockSize,
+              chunkSeconds, std::thread::hardware_concurrency());
+  std::printf("scenario,snapshot_bytes,save_us,restore_us,chunks,straight_ns_per_frame,chunked_ns_per_frame,"
+              "identical\n");
+
+  bool allSame = true;
+  for (const Scenario& sc : kScenarios) {
+    // A bass line with some dynamics: plucked notes, decaying.
+    const int frames = (int)(totalSeconds * sc.sampleRate);
+    std::vector<float> inL(frames), inR(frames);
+    const double noteLen = 0.25 * sc.sampleRate;
+    for (int i = 0; i < frames; ++i) {
+      const int note = (int)(i / noteLen);
+      const double t = (i - note * noteLen) / sc.sampleRate;
+      const double hz = 41.2 * std::pow(2.0, (note * 5 % 12) / 12.0);
+      const double env = std::exp(-t * 6.0);
+      inL[i] = (float)(0.6 * env * std::sin(2.0 * DSP::kPiD * hz * t));
+      inR[i] = (float)(0.5 * env * std::sin(2.0 * DSP::kPiD * hz * t + 0.3));
+    }
+
+    // Chunk edges on block boundaries, where a host could stop.
+    const int chunkFrames = std::max(1, (int)(chunkSeconds * sc.sampleRate) / blockSize) * blockSize;
+    std::vector<Chunk> straight;
+    for (int n = 0; n < frames; n += chunkFrames) {
+      straight.emplace_back();
+      straight.back().begin = n;
+      straight.back().end = std::min(frames, n + chunkFrames);
+    }
+
+    Engine e;
+    setup(e, sc, blockSize);
+    const size_t bytes = e.snapshotSize();
+    double saveTime = 0.0;
+    const auto t0 = Clock::now();
+    for (Chunk& c : straight) {
+      const auto s0 = Clock::now();
+      c.snapshot.resize(bytes);
+      e.saveSnapshot(c.snapshot.data(), bytes);
+      saveTime += seconds(s0);
+      renderChunk(e, sc, blockSize, inL, inR, c);
+    }
+    const double straightTime = seconds(t0);
+
+    std::vector<Chunk> resumed(straight.size());
+    std::vector<double> restoreTime(straight.size());
+    std::vector<char> restored(straight.size());
+    const auto t1 = Clock::now();
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < straight.size(); ++i) {
+      threads.emplace_back([&, i] {
+        Engine r;
+        setup(r, sc, blockSize);
+        resumed[i].begin = straight[i].begin;
+        resumed[i].end = straight[i].end;
+        const auto s0 = Clock::now();
+        restored[i] = r.restoreSnapshot(straight[i].snapshot.data(), straight[i].snapshot.size());
+        restoreTime[i] = seconds(s0);
+        renderChunk(r, sc, blockSize, inL, inR, resumed[i]);
+      });
+    }
+    for (auto& t : threads)
+      t.join();
+    const double chunkedTime = seconds(t1);
+
+    bool same = true;
+    double restoreSum = 0.0;
+    for (size_t i = 0; i < straight.size(); ++i) {
+      same = same && restored[i] && identical(straight[i], resumed[i]);
+      restoreSum += restoreTime[i];
+    }
+    allSame = allSame && same;
+    std::printf("%s,%zu,%.1f,%.1f,%zu,%.1f,%.1f,%s\n", sc.name, bytes, saveTime * 1e6 / straight.size(),
+                restoreSum * 1e6 / straight.size(), straight.size(), straightTime * 1e9 / frames,
+                chunkedTime * 1e9 / frames, same ? "yes" : "NO");
+  }
+  return allSame ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+// Many engine instances on many threads, as in a large session: how
+// throughput per instance holds up as threads are added.
+//
+// Instances are created back to back and dealt round robin to the threads,
+// so neighbouring heap allocations belong to different threads, the worst
+// case for false sharing. Each thread renders its instances block by block,
+// like a host's audio worker. For every thread count the bench prints the
+// cost per frame per instance, the aggregate real-time factor and the
+// scaling efficiency against one thread.
+//
+//   instance_scaling_bench [maxThreads] [instancesPerThread] [blockSize] [seconds]
+
+#include "engine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace SvenderBass;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Config {
+  int maxThreads = (int)std::max(1u, std::thread::hardware_concurrency());
+  int instancesPerThread = 8;
+  int blockSize = 128;
+  double seconds = 2.0;
+};
+
+// Wall time for `threads` workers rendering `cfg.seconds` of audio through
+// each of their instances.
+double run(const Config& cfg, int threads) {
+  const int numInstances = threads * cfg.instancesPerThread;
+  std::vector<std::unique_ptr<Engine>> engines;
+  for (int i = 0; i < numInstances; ++i) {
+    engines.push_back(std::make_unique<Engine>());
+    engines.back()->configure(48000.0, cfg.blockSize);
+    engines.back()->setParam(SVENDER_PARAM_DRIVE, 0.2 + 0.6 * (i % 5) / 4.0);
+    engines.back()->setParam(SVENDER_PARAM_SAT_MODE, (i % 5) / 4.0);
+  }
+
+  const int blocks = (int)(cfg.seconds * 48000.0 / cfg.blockSize);
+  std::atomic<int> ready {0};
+  std::atomic<bool> go {false};
+  std::vector<double> wall(threads);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      std::vector<Engine*> mine;
+      for (int i = t; i < numInstances; i += threads) mine.push_back(engines[i].get());
+      std::vector<float> inL(cfg.blockSize), inR(cfg.blockSize), outL(cfg.blockSize), outR(cfg.blockSize);
+      double phase = 0.0;
+
+      ready.fetch_add(1);
+      while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+
+      const auto t0 = Clock::now();
+      for (int b = 0; b < blocks; ++b) {
+        for (int i = 0; i < cfg.blockSize; ++i) {
+          phase += 2.0 * DSP::kPiD * 55.0 / 48000.0;
+          inL[i] = 0.5f * (float)std::sin(phase);
+          inR[i] = 0.4f * (float)std::sin(1.5 * phase);
+        }
+        for (Engine* e : mine) {
+          e->process(inL.data(), inR.data(), outL.data(), outR.data(), cfg.blockSize);
+          svender_dsp_meters m;
+          while (e->popMeters(m)) {}
+        }
+      }
+      wall[t] = std::chrono::duration<double>(Clock::now() - t0).count();
+    });
+  }
+  while (ready.load() < threads) std::this_thread::yield();
+  go.store(true, std::memory_order_release);
+  for (auto& w : workers) w.join();
+  return *std::max_element(wall.begin(), wall.end());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Config cfg;
+  if (argc > 1) cfg.maxThreads = std::max(1, std::atoi(argv[1]));
+  if (argc > 2) cfg.instancesPerThread = std::max(1, std::atoi(argv[2]));
+  if (argc > 3) cfg.blockSize = std::max(1, std::atoi(argv[3]));
+  if (argc > 4) cfg.seconds = std::atof(argv[4]);
+
+  std::printf("# %d instances per thread, block %d, %.1f s each; %u hardware threads; sizeof(Engine) %zu\n",
+              cfg.instancesPerThread, cfg.blockSize, cfg.seconds, std::thread::hardware_concurrency(), sizeof(Engine));
+  std::printf("threads,instances,ns_per_frame_per_instance,realtime_x,efficiency\n");
+
+  // 1, 2, 4, ... and maxThreads itself.
+  std::vector<int> counts;
+  for (int t = 1; t < cfg.maxThreads; t *= 2) counts.push_back(t);
+  counts.push_back(cfg.maxThreads);
+
+  double base = 0.0;
+  for (int threads : counts) {
+    const double wall = run(cfg, threads);
+    const int instances = threads * cfg.instancesPerThread;
+    const double frames = cfg.seconds * 48000.0;
+    // Per instance on its own thread: wall time shared by that thread's instances.
+    const double ns = wall * 1e9 / (frames * cfg.instancesPerThread);
+    if (threads == 1) base = ns;
+    std::printf("%d,%d,%.1f,%.1f,%.2f\n", threads, instances, ns, instances * cfg.seconds / wall, base / ns);
+  }
+  return 0;
+}
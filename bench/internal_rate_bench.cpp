@@ -0,0 +1,84 @@
+// High-rate sessions with and without the fixed internal rate
+// (Engine::setFixedInternalRate): CPU per host second and the tone.
+//
+// A steady 110 Hz sine goes through the driven default chain at each host
+// rate, once at the native rate and once resampled to 44.1/48 kHz. The
+// bench prints the cost and share of real time, the added latency, and the
+// fundamental level and harmonic levels (Goertzel) of the settled output.
+// With the fixed rate, the harmonics at 88.2 kHz and up should match the
+// 44.1/48 kHz rows; natively they drift with the rate.
+//
+//   internal_rate_bench [seconds] [blockSize]
+
+#include "engine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace SvenderBass;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double kToneHz = 110.0;
+
+// Level of the k-th harmonic in dB relative to a full-scale sine.
+double harmonicDb(const std::vector<float>& x, int begin, double sampleRate, int k) {
+  const double w = 2.0 * DSP::kPiD * kToneHz * k / sampleRate;
+  const double c = 2.0 * std::cos(w);
+  double s1 = 0.0, s2 = 0.0;
+  for (int i = begin; i < (int)x.size(); ++i) {
+    const double s0 = x[i] + c * s1 - s2;
+    s2 = s1;
+    s1 = s0;
+  }
+  const double power = s1 * s1 + s2 * s2 - c * s1 * s2;
+  const double amp = 2.0 * std::sqrt(std::max(power, 0.0)) / (x.size() - begin);
+  return 20.0 * std::log10(amp + 1e-12);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const double seconds = argc > 1 ? std::atof(argv[1]) : 4.0;
+  const int blockSize = argc > 2 ? std::max(1, std::atoi(argv[2])) : 256;
+
+  std::printf("# %.1f s of a %.0f Hz sine per run, block %d\n", seconds, kToneHz, blockSize);
+  std::printf("host_rate,internal_rate,latency,ns_per_frame,cpu_pct,h1_db,h2_db,h3_db,h5_db\n");
+
+  for (double rate : { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 }) {
+    for (int fixed = 0; fixed < 2; ++fixed) {
+      if (fixed && rate < 88200.0)
+        continue;
+      Engine e;
+      e.setFixedInternalRate(fixed != 0);
+      e.configure(rate, blockSize);
+      e.setParam(SVENDER_PARAM_DRIVE, 0.6);
+
+      const int frames = (int)(seconds * rate);
+      std::vector<float> in(frames), out(frames);
+      for (int i = 0; i < frames; ++i)
+        in[i] = (float)(0.5 * std::sin(2.0 * DSP::kPiD * kToneHz * i / rate));
+
+      const auto t0 = Clock::now();
+      for (int n = 0; n < frames; n += blockSize) {
+        e.processMono(&in[n], &out[n], std::min(blockSize, frames - n));
+        svender_dsp_meters m;
+        while (e.popMeters(m)) {}
+      }
+      const double wall = std::chrono::duration<double>(Clock::now() - t0).count();
+
+      const int settled = frames / 4;
+      std::printf("%.0f,%.0f,%d,%.1f,%.2f,%.2f,%.2f,%.2f,%.2f\n", rate, e.internalRate(), e.latencySamples(),
+                  wall * 1e9 / frames, 100.0 * wall / seconds, harmonicDb(out, settled, rate, 1),
+                  harmonicDb(out, settled, rate, 2), harmonicDb(out, settled, rate, 3),
+                  harmonicDb(out, settled, rate, 5));
+    }
+  }
+  return 0;
+}
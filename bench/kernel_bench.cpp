@@ -0,0 +1,157 @@
+// Throughput and equivalence of every compiled ISA variant of the hot
+// kernels (see kernels.h). Each variant runs the same input as the generic
+// table; the deviation column is the largest absolute output difference.
+// parallelBiquads runs the cascade's partial-fraction form on a stereo pair
+// (timed per frame, i.e. two cascade samples) and is checked against the
+// generic cascade. Exits 1 if any deviation exceeds its kernel's tolerance
+// (the same limits as tests/kernel_test.cpp).
+//
+//   kernel_bench [seconds-per-kernel]
+
+#include "kernels.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace SvenderBass;
+
+namespace {
+
+constexpr int kBlock = DSP::kControlInterval;
+constexpr int kLength = 1 << 16;
+
+struct Input {
+  std::vector<float> x;
+  std::vector<float> drive;
+};
+
+Input makeInput() {
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+  std::uniform_real_distribution<float> drv(1.0f, 40.0f);
+  Input in;
+  in.x.resize(kLength);
+  in.drive.resize(kLength);
+  for (int i = 0; i < kLength; ++i) {
+    in.x[i] = 0.6f * std::sin(0.013f * (float)i) + 0.1f * noise(rng);
+    in.drive[i] = drv(rng);
+  }
+  return in;
+}
+
+void makeCascade(DSP::Biquad* bq, float sr) {
+  bq[0].setLowShelf(sr, 40.0f, 2.0f);
+  bq[1].setPeaking(sr, 500.0f, -10.0f, 0.9f);
+  bq[2].setHighShelf(sr, 8000.0f, 9.0f);
+  bq[3].setLowShelf(sr, 40.0f, 6.0f);
+  bq[4].setPeaking(sr, 800.0f, 4.0f, 0.9f);
+  bq[5].setHighShelf(sr, 4000.0f, -3.0f);
+}
+
+std::vector<float> runCascade(const DSP::KernelTable& k, const Input& in) {
+  DSP::Biquad bq[6];
+  makeCascade(bq, 48000.0f);
+  std::vector<float> y = in.x;
+  for (int i = 0; i < kLength; i += kBlock)
+    k.biquadCascade(bq, 6, &y[i], kBlock);
+  return y;
+}
+
+std::vector<float> runParallel(const DSP::KernelTable& k, const Input& in) {
+  DSP::Biquad bq[6];
+  makeCascade(bq, 48000.0f);
+  DSP::ParallelBiquads pb;
+  if (!pb.design(bq, 6))
+    return {};
+  std::vector<float> l = in.x, r = in.x;
+  for (int i = 0; i < kLength; i += kBlock)
+    k.parallelBiquads(pb, &l[i], &r[i], kBlock);
+  l.insert(l.end(), r.begin(), r.end());
+  return l;
+}
+
+std::vector<float> runSaturate(const DSP::KernelTable& k, const Input& in) {
+  DSP::Oversampler4x os;
+  os.setSampleRate(48000.0f);
+  std::vector<float> y = in.x;
+  for (int i = 0; i < kLength; i += kBlock)
+    k.saturate4x(os, &y[i], &in.drive[i], kBlock);
+  return y;
+}
+
+std::vector<float> runStats(const DSP::KernelTable& k, const Input& in) {
+  // One peak/sum pair per control interval, as the engine's meters use it.
+  std::vector<float> y;
+  y.reserve(2 * kLength / kBlock);
+  for (int i = 0; i < kLength; i += kBlock) {
+    float peak = 0.0f, sumSq = 0.0f;
+    k.peakSumSquares(&in.x[i], kBlock, &peak, &sumSq);
+    y.push_back(peak);
+    y.push_back(sumSq);
+  }
+  return y;
+}
+
+double maxDiff(const std::vector<float>& a, const std::vector<float>& b) {
+  if (a.size() != b.size())
+    return INFINITY;
+  double m = 0.0;
+  for (size_t i = 0; i < a.size(); ++i)
+    m = std::max(m, (double)std::fabs(a[i] - b[i]));
+  return m;
+}
+
+template <class F>
+double nsPerSample(F&& run, double seconds) {
+  size_t samples = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  double elapsed = 0.0;
+  do {
+    run();
+    samples += kLength;
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  } while (elapsed < seconds);
+  return elapsed * 1e9 / (double)samples;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const double seconds = (argc > 1) ? std::atof(argv[1]) : 0.5;
+  const Input in = makeInput();
+  const DSP::KernelTable& ref = *DSP::kernelsFor(DSP::Isa::Generic);
+  const auto refCascade = runCascade(ref, in);
+  auto refPair = refCascade;
+  refPair.insert(refPair.end(), refCascade.begin(), refCascade.end());
+  const auto refSaturate = runSaturate(ref, in);
+  const auto refStats = runStats(ref, in);
+
+  std::printf("# active: %s\n", DSP::kernels().name);
+  std::printf("isa,kernel,ns_per_sample,max_abs_dev,tolerance\n");
+  int failed = 0;
+  for (int i = 0; i < (int)DSP::Isa::Count; ++i) {
+    const DSP::KernelTable* k = DSP::kernelsFor((DSP::Isa)i);
+    if (!k) {
+      std::printf("%s,unavailable,,\n", DSP::isaName((DSP::Isa)i));
+      continue;
+    }
+    const double cascadeNs = nsPerSample([&] { runCascade(*k, in); }, seconds);
+    const double parallelNs = nsPerSample([&] { runParallel(*k, in); }, seconds);
+    const double saturateNs = nsPerSample([&] { runSaturate(*k, in); }, seconds);
+    const double statsNs = nsPerSample([&] { runStats(*k, in); }, seconds);
+    const auto report = [&](const char* kernel, double ns, double dev, double tolerance) {
+      const bool ok = dev <= tolerance;
+      failed += ok ? 0 : 1;
+      std::printf("%s,%s,%.2f,%.3g,%.3g%s\n", k->name, kernel, ns, dev, tolerance, ok ? "" : ",FAIL");
+    };
+    report("biquadCascade6", cascadeNs, maxDiff(refCascade, runCascade(*k, in)), 1e-5);
+    report("parallelBiquads6x2", parallelNs, maxDiff(refPair, runParallel(*k, in)), 2e-3);
+    report("saturate4x", saturateNs, maxDiff(refSaturate, runSaturate(*k, in)), 1e-4);
+    report("peakSumSquares", statsNs, maxDiff(refStats, runStats(*k, in)), 1e-5);
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,120 @@
+// Offline render throughput, serial vs the pipelined chain
+// (Engine::setPipelined), for every saturation mode, stereo and mono.
+//
+// Both engines render the same input with the same automation, a step on a
+// few parameters every half second, as a long bounce would see it. The bench
+// prints ns/frame for each and the speedup, and compares the output and
+// the meter frames bit for bit.
+//
+//   offline_render_bench [seconds] [blockSize] [sampleRate]
+//
+// Exits non-zero when the pipelined render differs from the serial one.
+
+#include "engine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace SvenderBass;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Config {
+  double seconds = 20.0;
+  int blockSize = 4096;
+  double sampleRate = 48000.0;
+};
+
+const char* kModeNames[] = { "os4x", "adaa1-1x", "adaa1-2x", "adaa2-1x", "adaa2-2x" };
+
+struct Render {
+  std::vector<float> l, r;
+  std::vector<svender_dsp_meters> meters;
+  double nsPerFrame = 0.0;
+};
+
+Render render(const Config& cfg, bool pipelined, bool stereo, int mode, const std::vector<float>& inL,
+              const std::vector<float>& inR) {
+  Engine e;
+  e.setPipelined(pipelined);
+  e.configure(cfg.sampleRate, cfg.blockSize);
+  e.setParam(SVENDER_PARAM_SAT_MODE, mode / 4.0);
+
+  const int frames = (int)inL.size();
+  const int stepEvery = (int)(0.5 * cfg.sampleRate);
+  Render out;
+  out.l.resize(frames);
+  out.r.resize(stereo ? frames : 0);
+
+  const auto t0 = Clock::now();
+  for (int n = 0, step = -1; n < frames; n += cfg.blockSize) {
+    if (n / stepEvery != step) {
+      step = n / stepEvery;
+      e.setParam(SVENDER_PARAM_DRIVE, 0.2 + 0.15 * (step % 5));
+      e.setParam(SVENDER_PARAM_BASS, 0.3 + 0.1 * (step % 4));
+      e.setParam(SVENDER_PARAM_CROSSOVER, (step % 3) * 0.25);
+    }
+    const int len = std::min(cfg.blockSize, frames - n);
+    if (stereo)
+      e.process(&inL[n], &inR[n], &out.l[n], &out.r[n], len);
+    else
+      e.processMono(&inL[n], &out.l[n], len);
+    svender_dsp_meters m;
+    while (e.popMeters(m))
+      out.meters.push_back(m);
+  }
+  out.nsPerFrame = std::chrono::duration<double>(Clock::now() - t0).count() * 1e9 / frames;
+  return out;
+}
+
+bool identical(const Render& a, const Render& b) {
+  return a.l == b.l && a.r == b.r && a.meters.size() == b.meters.size() &&
+         std::memcmp(a.meters.data(), b.meters.data(), a.meters.size() * sizeof(svender_dsp_meters)) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Config cfg;
+  if (argc > 1) cfg.seconds = std::atof(argv[1]);
+  if (argc > 2) cfg.blockSize = std::max(1, std::atoi(argv[2]));
+  if (argc > 3) cfg.sampleRate = std::atof(argv[3]);
+
+  // A bass line with some dynamics: plucked notes, decaying.
+  const int frames = (int)(cfg.seconds * cfg.sampleRate);
+  std::vector<float> inL(frames), inR(frames);
+  const double noteLen = 0.25 * cfg.sampleRate;
+  for (int i = 0; i < frames; ++i) {
+    const int note = (int)(i / noteLen);
+    const double t = (i - note * noteLen) / cfg.sampleRate;
+    const double hz = 41.2 * std::pow(2.0, (note * 5 % 12) / 12.0);
+    const double env = std::exp(-t * 6.0);
+    inL[i] = (float)(0.6 * env * std::sin(2.0 * DSP::kPiD * hz * t));
+    inR[i] = (float)(0.5 * env * std::sin(2.0 * DSP::kPiD * hz * t + 0.3));
+  }
+
+  std::printf("# %.0f s at %.0f Hz, block %d; %u hardware threads\n", cfg.seconds, cfg.sampleRate, cfg.blockSize,
+              std::thread::hardware_concurrency());
+  std::printf("channels,mode,serial_ns_per_frame,pipelined_ns_per_frame,speedup,identical\n");
+
+  bool allSame = true;
+  for (int stereo = 1; stereo >= 0; --stereo) {
+    for (int mode = 0; mode < (int)DSP::SatMode::Count; ++mode) {
+      const Render serial = render(cfg, false, stereo, mode, inL, inR);
+      const Render piped = render(cfg, true, stereo, mode, inL, inR);
+      const bool same = identical(serial, piped);
+      allSame = allSame && same;
+      std::printf("%d,%s,%.1f,%.1f,%.2f,%s\n", stereo ? 2 : 1, kModeNames[mode], serial.nsPerFrame,
+                  piped.nsPerFrame, serial.nsPerFrame / piped.nsPerFrame, same ? "yes" : "NO");
+    }
+  }
+  return allSame ? 0 : 1;
+}
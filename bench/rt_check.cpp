@@ -0,0 +1,375 @@
+// Real-time safety check for the audio path (Linux).
+//
+// Interposes the allocator, the pthread blocking primitives and the common
+// blocking or kernel-entering libc calls. Any of them reached while an
+// AudioThreadScope is open on the calling thread is recorded with a short
+// backtrace. The scenarios drive the Engine exactly as Processor::process
+// does per block (parameter points -> setParam, process, then the tuner,
+// meter and spectrum reads), through automation, preset-style state jumps,
+// mode switches, tuner and analyzer use, mono and silence/loud edges.
+//
+//   rt_check [seconds-per-scenario]
+//
+// Exits non-zero on any violation.
+
+#include "engine.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <random>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+extern "C" {
+void* __libc_malloc(size_t);
+void* __libc_calloc(size_t, size_t);
+void* __libc_realloc(void*, size_t);
+void* __libc_memalign(size_t, size_t);
+void __libc_free(void*);
+}
+
+namespace {
+
+thread_local bool tl_audio = false;
+thread_local bool tl_inHook = false;
+
+constexpr int kMaxRecords = 64;
+constexpr int kMaxFrames = 12;
+
+struct Record {
+  const char* what;
+  const char* scenario;
+  int frames;
+  void* stack[kMaxFrames];
+};
+
+Record g_records[kMaxRecords];
+std::atomic<int> g_violations { 0 };
+const char* g_scenario = "";
+
+void violation(const char* what) {
+  if (!tl_audio || tl_inHook)
+    return;
+  tl_inHook = true;
+  const int i = g_violations.fetch_add(1, std::memory_order_relaxed);
+  if (i < kMaxRecords) {
+    Record& r = g_records[i];
+    r.what = what;
+    r.scenario = g_scenario;
+    r.frames = backtrace(r.stack, kMaxFrames);
+  }
+  tl_inHook = false;
+}
+
+// Marks the calling thread as the audio thread for its lifetime.
+struct AudioThreadScope {
+  AudioThreadScope() { tl_audio = true; }
+  ~AudioThreadScope() { tl_audio = false; }
+};
+
+// Resolved once at startup, before any scope opens: dlsym itself may
+// allocate.
+template <class F>
+F next(const char* name) {
+  return reinterpret_cast<F>(dlsym(RTLD_NEXT, name));
+}
+
+#define SVENDER_RT_HOOKS(X)                                                        \
+  X(pthread_mutex_lock, int, (pthread_mutex_t*))                                  \
+  X(pthread_mutex_trylock, int, (pthread_mutex_t*))                               \
+  X(pthread_rwlock_rdlock, int, (pthread_rwlock_t*))                              \
+  X(pthread_rwlock_wrlock, int, (pthread_rwlock_t*))                              \
+  X(pthread_cond_wait, int, (pthread_cond_t*, pthread_mutex_t*))                  \
+  X(pthread_cond_timedwait, int, (pthread_cond_t*, pthread_mutex_t*, const timespec*)) \
+  X(pthread_cond_signal, int, (pthread_cond_t*))                                  \
+  X(pthread_cond_broadcast, int, (pthread_cond_t*))                               \
+  X(pthread_create, int, (pthread_t*, const pthread_attr_t*, void* (*)(void*), void*)) \
+  X(pthread_join, int, (pthread_t, void**))                                       \
+  X(sem_wait, int, (sem_t*))                                                      \
+  X(sem_post, int, (sem_t*))                                                      \
+  X(read, ssize_t, (int, void*, size_t))                                          \
+  X(write, ssize_t, (int, const void*, size_t))                                   \
+  X(close, int, (int))                                                            \
+  X(nanosleep, int, (const timespec*, timespec*))                                 \
+  X(clock_nanosleep, int, (clockid_t, int, const timespec*, timespec*))           \
+  X(usleep, int, (useconds_t))                                                    \
+  X(sched_yield, int, ())                                                         \
+  X(mmap, void*, (void*, size_t, int, int, int, off_t))                           \
+  X(munmap, int, (void*, size_t))                                                 \
+  X(mprotect, int, (void*, size_t, int))                                          \
+  X(madvise, int, (void*, size_t, int))
+
+#define SVENDER_RT_DECLARE(name, ret, args) ret(*real_##name) args = nullptr;
+SVENDER_RT_HOOKS(SVENDER_RT_DECLARE)
+int (*real_open)(const char*, int, ...) = nullptr;
+int (*real_openat)(int, const char*, int, ...) = nullptr;
+long (*real_syscall)(long, ...) = nullptr;
+
+void resolveHooks() {
+#define SVENDER_RT_RESOLVE(name, ret, args) real_##name = next<ret(*) args>(#name);
+  SVENDER_RT_HOOKS(SVENDER_RT_RESOLVE)
+  real_open = next<int (*)(const char*, int, ...)>("open");
+  real_openat = next<int (*)(int, const char*, int, ...)>("openat");
+  real_syscall = next<long (*)(long, ...)>("syscall");
+
+  // First backtrace() loads the unwinder; do it here, not inside a hook.
+  void* warm[2];
+  backtrace(warm, 2);
+}
+
+} // namespace
+
+// Interposed entry points. They forward unconditionally; only the audio
+// thread records violations.
+extern "C" {
+
+void* malloc(size_t n) { violation("malloc"); return __libc_malloc(n); }
+void* calloc(size_t c, size_t n) { violation("calloc"); return __libc_calloc(c, n); }
+void* realloc(void* p, size_t n) { violation("realloc"); return __libc_realloc(p, n); }
+void free(void* p) { if (p) violation("free"); __libc_free(p); }
+void* memalign(size_t a, size_t n) { violation("memalign"); return __libc_memalign(a, n); }
+void* aligned_alloc(size_t a, size_t n) { violation("aligned_alloc"); return __libc_memalign(a, n); }
+int posix_memalign(void** p, size_t a, size_t n) {
+  violation("posix_memalign");
+  *p = __libc_memalign(a, n);
+  return *p ? 0 : ENOMEM;
+}
+
+#define SVENDER_RT_DEFINE(name, ret, params, call)                               \
+  ret name params {                                                                \
+    violation(#name);                                                              \
+    return real_##name call;                                                       \
+  }
+SVENDER_RT_DEFINE(pthread_mutex_lock, int, (pthread_mutex_t* m), (m))
+SVENDER_RT_DEFINE(pthread_mutex_trylock, int, (pthread_mutex_t* m), (m))
+SVENDER_RT_DEFINE(pthread_rwlock_rdlock, int, (pthread_rwlock_t* l), (l))
+SVENDER_RT_DEFINE(pthread_rwlock_wrlock, int, (pthread_rwlock_t* l), (l))
+SVENDER_RT_DEFINE(pthread_cond_wait, int, (pthread_cond_t* c, pthread_mutex_t* m), (c, m))
+SVENDER_RT_DEFINE(pthread_cond_timedwait, int, (pthread_cond_t* c, pthread_mutex_t* m, const timespec* t), (c, m, t))
+SVENDER_RT_DEFINE(pthread_cond_signal, int, (pthread_cond_t* c), (c))
+SVENDER_RT_DEFINE(pthread_cond_broadcast, int, (pthread_cond_t* c), (c))
+SVENDER_RT_DEFINE(pthread_create, int, (pthread_t* t, const pthread_attr_t* a, void* (*f)(void*), void* arg), (t, a, f, arg))
+SVENDER_RT_DEFINE(pthread_join, int, (pthread_t t, void** r), (t, r))
+SVENDER_RT_DEFINE(sem_wait, int, (sem_t* s), (s))
+SVENDER_RT_DEFINE(sem_post, int, (sem_t* s), (s))
+SVENDER_RT_DEFINE(read, ssize_t, (int fd, void* b, size_t n), (fd, b, n))
+SVENDER_RT_DEFINE(write, ssize_t, (int fd, const void* b, size_t n), (fd, b, n))
+SVENDER_RT_DEFINE(close, int, (int fd), (fd))
+SVENDER_RT_DEFINE(nanosleep, int, (const timespec* a, timespec* b), (a, b))
+SVENDER_RT_DEFINE(clock_nanosleep, int, (clockid_t c, int f, const timespec* a, timespec* b), (c, f, a, b))
+SVENDER_RT_DEFINE(usleep, int, (useconds_t u), (u))
+SVENDER_RT_DEFINE(sched_yield, int, (), ())
+SVENDER_RT_DEFINE(mmap, void*, (void* a, size_t n, int p, int f, int fd, off_t o), (a, n, p, f, fd, o))
+SVENDER_RT_DEFINE(munmap, int, (void* a, size_t n), (a, n))
+SVENDER_RT_DEFINE(mprotect, int, (void* a, size_t n, int p), (a, n, p))
+SVENDER_RT_DEFINE(madvise, int, (void* a, size_t n, int adv), (a, n, adv))
+
+int open(const char* path, int flags, ...) {
+  violation("open");
+  va_list ap;
+  va_start(ap, flags);
+  const int mode = va_arg(ap, int);
+  va_end(ap);
+  return real_open(path, flags, mode);
+}
+
+int openat(int dir, const char* path, int flags, ...) {
+  violation("openat");
+  va_list ap;
+  va_start(ap, flags);
+  const int mode = va_arg(ap, int);
+  va_end(ap);
+  return real_openat(dir, path, flags, mode);
+}
+
+// Raw syscall(2), e.g. futex waits from std::atomic::wait or std::mutex.
+long syscall(long nr, ...) {
+  violation("syscall");
+  va_list ap;
+  va_start(ap, nr);
+  long a[6];
+  for (long& v : a) v = va_arg(ap, long);
+  va_end(ap);
+  return real_syscall(nr, a[0], a[1], a[2], a[3], a[4], a[5]);
+}
+
+} // extern "C"
+
+using namespace SvenderBass;
+
+namespace {
+
+constexpr double kSampleRate = 48000.0;
+constexpr int kMaxBlock = 512;
+
+struct Host {
+  Engine engine;
+  std::vector<float> inL, inR, outL, outR;
+  std::mt19937 rng { 7 };
+  double phase = 0.0;
+  float level = 0.5f;
+
+  Host() : inL(kMaxBlock), inR(kMaxBlock), outL(kMaxBlock), outR(kMaxBlock) {
+    engine.configure(kSampleRate, kMaxBlock);
+  }
+
+  void fill(int n) {
+    for (int i = 0; i < n; ++i) {
+      phase += 2.0 * DSP::kPiD * 55.0 / kSampleRate;
+      inL[i] = level * (float)std::sin(phase);
+      inR[i] = level * (float)std::sin(1.5 * phase);
+    }
+  }
+
+  // One Processor::process call: automation points, the chain, then the
+  // reads that feed the tuner outputs and the telemetry blocks.
+  template <class Params>
+  void block(int n, bool mono, Params&& params) {
+    fill(n);
+    AudioThreadScope audio;
+    params(engine);
+    if (mono)
+      engine.processMono(inL.data(), outL.data(), n);
+    else
+      engine.process(inL.data(), inR.data(), outL.data(), outR.data(), n);
+
+    svender_dsp_tuner t;
+    engine.popTuner(t);
+    svender_dsp_meters m;
+    while (engine.popMeters(m)) {}
+    if (engine.analyzerEnabled()) {
+      svender_dsp_spectrum s;
+      engine.popSpectrum(s);
+    }
+  }
+};
+
+void noParams(Engine&) {}
+
+struct Scenario {
+  const char* name;
+  void (*run)(Host& h, int blocks);
+};
+
+const Scenario kScenarios[] = {
+  { "tone-stack-first-block", [](Host& h, int blocks) {
+      // First: the engine was just configured, the first in the process, and
+      // the stack goes on in its very first block.
+      for (int b = 0; b < blocks; ++b)
+        h.block(64, false, [&](Engine& e) { if (b == 0) e.setParam(SVENDER_PARAM_TONE_STACK, 1.0); });
+      h.engine.setParam(SVENDER_PARAM_TONE_STACK, 0.0);
+    } },
+  { "steady", [](Host& h, int blocks) {
+      for (int b = 0; b < blocks; ++b) h.block(64, false, noParams);
+    } },
+  { "automation-all-params", [](Host& h, int blocks) {
+      // Every parameter moves every block, at varying host block sizes.
+      std::uniform_int_distribution<int> size(1, kMaxBlock);
+      for (int b = 0; b < blocks; ++b) {
+        h.block(size(h.rng), false, [&](Engine& e) {
+          for (int id = 0; id < SVENDER_PARAM_COUNT; ++id) {
+            if (id == SVENDER_PARAM_TUNER) continue;
+            e.setParam(id, 0.5 + 0.5 * std::sin(0.01 * b * (id + 1)));
+          }
+        });
+      }
+    } },
+  { "state-jumps", [](Host& h, int blocks) {
+      // Preset-style loads: every parameter jumps at once.
+      std::uniform_real_distribution<double> u(0.0, 1.0);
+      for (int b = 0; b < blocks; ++b) {
+        h.block(128, false, [&](Engine& e) {
+          if (b % 25 != 0) return;
+          for (int id = 0; id < SVENDER_PARAM_COUNT; ++id)
+            e.setParam(id, id == SVENDER_PARAM_TUNER ? 0.0 : u(h.rng));
+        });
+      }
+    } },
+  { "mode-switches", [](Host& h, int blocks) {
+      for (int b = 0; b < blocks; ++b) {
+        h.block(96, false, [&](Engine& e) {
+          if (b % 7 == 0) e.setParam(SVENDER_PARAM_SAT_MODE, (b / 7 % 5) / 4.0);
+          if (b % 11 == 0) e.setParam(SVENDER_PARAM_CROSSOVER, (b / 11 % 5) / 4.0);
+          if (b % 13 == 0) e.setParam(SVENDER_PARAM_ULTRA_LOW, (b / 13) % 2);
+          if (b % 17 == 0) e.setParam(SVENDER_PARAM_ULTRA_HIGH, (b / 17) % 2);
+          if (b % 19 == 0) e.setParam(SVENDER_PARAM_MID_FREQ, (b / 19 % 5) / 4.0);
+          if (b % 23 == 0) e.setParam(SVENDER_PARAM_TONE_STACK, (b / 23) % 2);
+        });
+      }
+    } },
+  { "tuner", [](Host& h, int blocks) {
+      for (int b = 0; b < blocks; ++b) {
+        h.block(256, false, [&](Engine& e) {
+          if (b % 40 == 0) e.setParam(SVENDER_PARAM_TUNER, (b / 40) % 2);
+          if (b % 100 == 0) e.setParam(SVENDER_PARAM_TUNER_MUTE, (b / 100) % 2);
+        });
+      }
+      h.engine.setParam(SVENDER_PARAM_TUNER, 0.0);
+    } },
+  { "analyzer", [](Host& h, int blocks) {
+      h.engine.setAnalyzerEnabled(true); // message thread
+      for (int b = 0; b < blocks; ++b)
+        h.block(64, false, [&](Engine& e) { e.setParam(SVENDER_PARAM_DRIVE, 0.5 + 0.4 * std::sin(0.05 * b)); });
+      h.engine.setAnalyzerEnabled(false);
+    } },
+  { "mono", [](Host& h, int blocks) {
+      for (int b = 0; b < blocks; ++b)
+        h.block(200, true, [&](Engine& e) { e.setParam(SVENDER_PARAM_BASS, 0.5 + 0.5 * std::sin(0.02 * b)); });
+    } },
+  { "silence-loud", [](Host& h, int blocks) {
+      // Denormal tails in silence, then full-scale bursts.
+      for (int b = 0; b < blocks; ++b) {
+        h.level = (b / 200) % 2 ? 1.0f : 0.0f;
+        h.block(64, false, noParams);
+      }
+      h.level = 0.5f;
+    } },
+};
+
+// The first few records of a scenario; the rest usually repeat them.
+void printRecords(int first, int last) {
+  constexpr int kShown = 4;
+  for (int i = first; i < last && i < first + kShown && i < kMaxRecords; ++i) {
+    const Record& r = g_records[i];
+    std::fprintf(stderr, "  %s in %s\n", r.what, r.scenario);
+    std::fflush(stderr);
+    backtrace_symbols_fd(r.stack, r.frames, 2);
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  resolveHooks();
+  const double seconds = (argc > 1) ? std::atof(argv[1]) : 2.0;
+
+  Host host;
+  int failed = 0;
+  std::printf("scenario,blocks,violations\n");
+  for (const Scenario& s : kScenarios) {
+    g_scenario = s.name;
+    const int before = g_violations.load();
+    const int blocks = (int)(seconds * kSampleRate / 128.0);
+    s.run(host, blocks);
+    const int found = g_violations.load() - before;
+    std::printf("%s,%d,%d\n", s.name, blocks, found);
+    std::fflush(stdout);
+    if (found > 0) {
+      ++failed;
+      printRecords(before, before + found);
+    }
+  }
+  std::printf("# %s\n", failed ? "FAILED" : "ok");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,297 @@
+// Aliasing, THD and noise vs CPU for every saturation mode, on two stages:
+//
+//   saturator  DSP::Saturator alone (os4x is Oversampler4x + tubeSatMulti),
+//              drive as the raw tanh drive
+//   engine     the full Engine chain (EQ flat, full band, default cab),
+//              drive as the normalized Drive parameter
+//   engine_xover120  the same with the drive crossover at 120 Hz
+//
+// Each stage gets bin-centred sines and a logarithmic sweep. Output power is
+// split into the fundamental, in-band harmonics, aliases (harmonics above
+// Nyquist folded back) and everything else (noise floor); the three
+// distortion columns are in dB relative to the fundamental. ns_per_sample
+// is the stage's cost per mono sample.
+//
+// A distortion column is left empty when no bin falls in its class, so
+// there is nothing to measure: thd_db for a sine whose second harmonic is
+// already above Nyquist (14 kHz at 48 kHz), noise_db for the sweep, whose
+// widened component bands cover the whole spectrum.
+//
+//   saturation_bench [sampleRate]
+
+#include "engine.h"
+#include "kernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using namespace SvenderBass;
+
+namespace {
+
+constexpr int kFftSize = 16384;
+constexpr int kWarmup = 8192;
+constexpr double kTwoPi = 2.0 * 3.14159265358979323846;
+constexpr float kLevel = 0.5f;
+
+// Sweep analysis: short frames so the fundamental barely moves inside one.
+constexpr int kFrameSize = 1024;
+constexpr double kSweepSeconds = 8.0;
+constexpr double kSweepLoHz = 2000.0;
+constexpr double kSweepHiHz = 16000.0;
+
+const char* modeName(DSP::SatMode m) {
+  switch (m) {
+    case DSP::SatMode::Oversample4x: return "os4x";
+    case DSP::SatMode::Adaa1_1x:     return "adaa1-1x";
+    case DSP::SatMode::Adaa1_2x:     return "adaa1-2x";
+    case DSP::SatMode::Adaa2_1x:     return "adaa2-1x";
+    case DSP::SatMode::Adaa2_2x:     return "adaa2-2x";
+    default:                         return "?";
+  }
+}
+
+void fft(std::vector<std::complex<double>>& a) {
+  const size_t n = a.size();
+  for (size_t i = 1, j = 0; i < n; ++i) {
+    size_t bit = n >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) std::swap(a[i], a[j]);
+  }
+  for (size_t len = 2; len <= n; len <<= 1) {
+    const double ang = -kTwoPi / (double)len;
+    const std::complex<double> wl(std::cos(ang), std::sin(ang));
+    for (size_t i = 0; i < n; i += len) {
+      std::complex<double> w(1.0);
+      for (size_t k = 0; k < len / 2; ++k) {
+        const auto u = a[i + k];
+        const auto v = a[i + k + len / 2] * w;
+        a[i + k] = u + v;
+        a[i + k + len / 2] = u - v;
+        w *= wl;
+      }
+    }
+  }
+}
+
+// Power and number of bins per class, summed over one or more spectra.
+struct Powers {
+  double signal = 0.0, harmonics = 0.0, alias = 0.0, noise = 0.0;
+  int harmonicBins = 0, aliasBins = 0, noiseBins = 0;
+
+  static double db(double p, double ref) { return 10.0 * std::log10(std::max(p, 1e-30) / std::max(ref, 1e-30)); }
+  double thdDb() const { return db(harmonics, signal); }
+  double aliasDb() const { return db(alias, signal); }
+  double noiseDb() const { return db(noise, signal); }
+};
+
+enum BinClass : unsigned char { kNoise, kSignal, kHarmonic, kAlias, kSkip };
+
+// Classifies the bins of a size-n spectrum for a fundamental at bin f0
+// (fractional). Component h (1 = fundamental) covers +-width(h) bins around
+// its unfolded or folded position; earlier classes win.
+template <class Width>
+void classify(std::vector<BinClass>& cls, int n, double f0, Width&& width) {
+  const int half = n / 2;
+  cls.assign(half + 1, kNoise);
+  cls[0] = kSkip; // DC
+  auto mark = [&](double bin, int w, BinClass c) {
+    const int lo = std::max(0, (int)std::floor(bin) - w), hi = std::min(half, (int)std::ceil(bin) + w);
+    for (int b = lo; b <= hi; ++b)
+      if (cls[b] == kNoise) cls[b] = c;
+  };
+  mark(f0, width(1), kSignal);
+  for (int h = 2; h * f0 < half; ++h)
+    mark(h * f0, width(h), kHarmonic);
+  for (int h = 2; h * f0 < 64.0 * n; ++h) {
+    if (h * f0 < half) continue;
+    double b = std::fmod(h * f0, (double)n);
+    if (b > half) b = n - b;
+    mark(b, width(h), kAlias);
+  }
+}
+
+void accumulate(const std::vector<std::complex<double>>& a, const std::vector<BinClass>& cls, Powers& p) {
+  for (size_t b = 0; b < cls.size(); ++b) {
+    const double e = std::norm(a[b]);
+    switch (cls[b]) {
+      case kSignal:   p.signal += e; break;
+      case kHarmonic: p.harmonics += e; ++p.harmonicBins; break;
+      case kAlias:    p.alias += e; ++p.aliasBins; break;
+      case kNoise:    p.noise += e; ++p.noiseBins; break;
+      default: break;
+    }
+  }
+}
+
+// A mono processing stage under test.
+struct Stage {
+  virtual ~Stage() = default;
+  virtual void reset() = 0;
+  virtual void process(float* x, int n) = 0;
+};
+
+struct SaturatorStage : Stage {
+  DSP::SatMode mode;
+  float sr, drive;
+  DSP::Saturator sat;
+  std::vector<float> drives;
+
+  SaturatorStage(DSP::SatMode m, float sampleRate, float d) : mode(m), sr(sampleRate), drive(d) { reset(); }
+  void reset() override {
+    sat = DSP::Saturator();
+    sat.setSampleRate(sr);
+    sat.setMode(mode);
+  }
+  void process(float* x, int n) override {
+    drives.assign(n, drive);
+    DSP::saturateBlock(sat, x, drives.data(), n);
+  }
+};
+
+struct EngineStage : Stage {
+  DSP::SatMode mode;
+  float sr, drive;
+  std::unique_ptr<Engine> engine;
+
+  // Configured once: reconfiguring restarts the engine's worker threads.
+  EngineStage(DSP::SatMode m, float sampleRate, float d, int crossover) : mode(m), sr(sampleRate), drive(d) {
+    engine = std::make_unique<Engine>();
+    engine->configure(sr, kFftSize);
+    engine->setParam(SVENDER_PARAM_SAT_MODE, (double)mode / 4.0);
+    engine->setParam(SVENDER_PARAM_DRIVE, drive);
+    engine->setParam(SVENDER_PARAM_CROSSOVER, crossover / 4.0);
+  }
+  void reset() override { engine->reset(); }
+  void process(float* x, int n) override { engine->processMono(x, x, n); }
+};
+
+// Sine on bin k0, rectangular window: every component sits on a bin.
+Powers measureSine(Stage& st, int k0) {
+  st.reset();
+  std::vector<float> y(kWarmup + kFftSize);
+  for (int i = 0; i < (int)y.size(); ++i)
+    y[i] = kLevel * (float)std::sin(kTwoPi * k0 * (double)(i - kWarmup) / kFftSize);
+  for (int i = 0; i < (int)y.size(); i += kFftSize)
+    st.process(&y[i], std::min(kFftSize, (int)y.size() - i));
+
+  std::vector<std::complex<double>> a(y.begin() + kWarmup, y.end());
+  fft(a);
+  std::vector<BinClass> cls;
+  classify(cls, kFftSize, k0, [](int) { return 0; });
+  Powers p;
+  accumulate(a, cls, p);
+  return p;
+}
+
+// Exponential sweep, Blackman-Harris frames; each component's band widens
+// with how far it moves within a frame.
+Powers measureSweep(Stage& st, float sr) {
+  st.reset();
+  const int n = (int)(kSweepSeconds * sr);
+  const double rate = std::log(kSweepHiHz / kSweepLoHz) / kSweepSeconds;
+  std::vector<float> y(n);
+  for (int i = 0; i < n; ++i) {
+    const double t = i / (double)sr;
+    y[i] = kLevel * (float)std::sin(kTwoPi * kSweepLoHz * (std::exp(rate * t) - 1.0) / rate);
+  }
+  for (int i = 0; i < n; i += kFrameSize)
+    st.process(&y[i], std::min(kFrameSize, n - i));
+
+  std::vector<double> window(kFrameSize);
+  for (int i = 0; i < kFrameSize; ++i) {
+    const double x = kTwoPi * i / kFrameSize;
+    window[i] = 0.35875 - 0.48829 * std::cos(x) + 0.14128 * std::cos(2 * x) - 0.01168 * std::cos(3 * x);
+  }
+
+  Powers p;
+  std::vector<std::complex<double>> a(kFrameSize);
+  std::vector<BinClass> cls;
+  const int skip = (int)(0.1 * sr); // filter and envelope settling
+  for (int start = skip; start + kFrameSize <= n; start += kFrameSize / 2) {
+    const double fc = kSweepLoHz * std::exp(rate * (start + 0.5 * kFrameSize) / sr);
+    const double f0 = fc * kFrameSize / sr;
+    const double drift = f0 * rate * kFrameSize / sr; // bins moved per frame
+    for (int i = 0; i < kFrameSize; ++i) a[i] = y[start + i] * window[i];
+    fft(a);
+    classify(cls, kFrameSize, f0, [&](int h) { return 4 + (int)std::ceil(0.5 * h * drift); });
+    accumulate(a, cls, p);
+  }
+  return p;
+}
+
+double nsPerSample(Stage& st, float sr) {
+  st.reset();
+  const int n = (int)sr * 2;
+  std::vector<float> x(n);
+  for (int i = 0; i < n; ++i)
+    x[i] = kLevel * (float)std::sin(kTwoPi * 110.0 * i / sr);
+  constexpr int kBlock = 256;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; i += kBlock)
+    st.process(&x[i], std::min(kBlock, n - i));
+  const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  return s * 1e9 / n;
+}
+
+// One CSV field in dB, empty when its class had no bins.
+struct DbField {
+  char text[16] = "";
+  DbField(int bins, double db) {
+    if (bins > 0)
+      std::snprintf(text, sizeof(text), "%.1f", db);
+  }
+};
+
+void report(const char* stage, DSP::SatMode mode, float drive, const char* signal, double lo, double hi,
+            const Powers& p, double ns) {
+  std::printf("%s,%s,%.2f,%s,%.1f,%.1f,%s,%s,%s,%.1f\n", stage, modeName(mode), drive, signal, lo, hi,
+              DbField(p.aliasBins, p.aliasDb()).text, DbField(p.harmonicBins, p.thdDb()).text,
+              DbField(p.noiseBins, p.noiseDb()).text, ns);
+}
+
+template <class MakeStage>
+void runStage(const char* name, float sr, const float* drives, int numDrives, MakeStage&& make) {
+  const float freqs[] = { 1500.0f, 4000.0f, 9000.0f, 14000.0f };
+  for (int m = 0; m < (int)DSP::SatMode::Count; ++m) {
+    const auto mode = (DSP::SatMode)m;
+    for (int d = 0; d < numDrives; ++d) {
+      auto st = make(mode, drives[d]);
+      const double ns = nsPerSample(*st, sr);
+      for (float f : freqs) {
+        // Odd bin so folded harmonics do not land on in-band harmonics.
+        const int k0 = (int)std::lround(f * kFftSize / sr) | 1;
+        const double hz = (double)k0 * sr / kFftSize;
+        report(name, mode, drives[d], "sine", hz, hz, measureSine(*st, k0), ns);
+      }
+      report(name, mode, drives[d], "sweep", kSweepLoHz, kSweepHiHz, measureSweep(*st, sr), ns);
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const float sr = (argc > 1) ? (float)std::atof(argv[1]) : 48000.0f;
+  const float satDrives[] = { 2.0f, 8.0f, 20.0f };
+  const float engineDrives[] = { 0.2f, 0.5f, 0.9f };
+
+  std::printf("stage,mode,drive,signal,freq_lo_hz,freq_hi_hz,alias_db,thd_db,noise_db,ns_per_sample\n");
+  runStage("saturator", sr, satDrives, 3, [&](DSP::SatMode m, float d) {
+    return std::make_unique<SaturatorStage>(m, sr, d);
+  });
+  runStage("engine", sr, engineDrives, 3, [&](DSP::SatMode m, float d) {
+    return std::make_unique<EngineStage>(m, sr, d, 0);
+  });
+  runStage("engine_xover120", sr, engineDrives, 3, [&](DSP::SatMode m, float d) {
+    return std::make_unique<EngineStage>(m, sr, d, 2);
+  });
+  return 0;
+}
@@ -0,0 +1,104 @@
+// Session load: what each of many instances costs to bring up and tear
+// down, phase by phase, as a host loading a large project drives them.
+//
+// The plugin's lifecycle maps onto the engine: construction is the
+// Processor's (initialize only declares buses), setupProcessing only stores
+// the setup, and every setActive configures (or resets) the engine and warms
+// it up. The bench creates N engines, configures and warms them, runs two
+// blocks each, opens and closes the spectrum analyzer on all of them (an
+// editor shown per instance) and destroys them. Per phase it prints the wall time, the time and heap bytes
+// per instance, and the threads alive in the process afterwards.
+//
+//   session_load_bench [instances] [sampleRate] [blockSize]
+
+#include "engine.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace SvenderBass;
+
+// Heap bytes requested through operator new (what the engine allocates with).
+static std::atomic<size_t> gHeapBytes {0};
+
+void* operator new(size_t n) {
+  gHeapBytes.fetch_add(n, std::memory_order_relaxed);
+  if (void* p = std::malloc(n ? n : 1))
+    return p;
+  throw std::bad_alloc();
+}
+void* operator new(size_t n, std::align_val_t a) {
+  gHeapBytes.fetch_add(n, std::memory_order_relaxed);
+  const size_t align = (size_t)a;
+  if (void* p = std::aligned_alloc(align, (n + align - 1) / align * align))
+    return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int threadCount() {
+  std::ifstream status("/proc/self/status");
+  for (std::string line; std::getline(status, line);)
+    if (line.rfind("Threads:", 0) == 0)
+      return std::atoi(line.c_str() + 8);
+  return -1;
+}
+
+// Runs f over instances [begin, end) and prints the phase's row.
+template <typename F>
+void phase(const char* name, std::vector<std::unique_ptr<Engine>>& engines, size_t begin, size_t end, F&& f) {
+  const size_t bytes0 = gHeapBytes.load();
+  const auto t0 = Clock::now();
+  for (size_t i = begin; i < end; ++i)
+    f(engines[i]);
+  const double wall = std::chrono::duration<double>(Clock::now() - t0).count();
+  const size_t bytes = gHeapBytes.load() - bytes0;
+  const double n = (double)(end - begin);
+  std::printf("%s,%.2f,%.1f,%.0f,%d\n", name, wall * 1e3, wall * 1e6 / n, (double)bytes / n, threadCount());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const int instances = argc > 1 ? std::max(1, std::atoi(argv[1])) : 128;
+  const double sampleRate = argc > 2 ? std::atof(argv[2]) : 48000.0;
+  const int blockSize = argc > 3 ? std::max(1, std::atoi(argv[3])) : 512;
+
+  std::printf("# %d instances at %.0f Hz, block %d\n", instances, sampleRate, blockSize);
+  std::printf("phase,total_ms,us_per_instance,heap_bytes_per_instance,threads_after\n");
+
+  std::vector<std::unique_ptr<Engine>> engines(instances);
+  std::vector<float> l(blockSize), r(blockSize);
+
+  const size_t n = engines.size();
+  auto configure = [&](auto& e) { e->configure(sampleRate, blockSize); };
+  auto block = [&](auto& e) { e->process(l.data(), r.data(), l.data(), r.data(), blockSize); };
+
+  phase("construct", engines, 0, n, [](auto& e) { e = std::make_unique<Engine>(); });
+  // The first configure in the process also builds the shared tables.
+  phase("configure_first", engines, 0, 1, configure);
+  if (n > 1)
+    phase("configure", engines, 1, n, configure);
+  phase("warm_up", engines, 0, n, [](auto& e) { e->warmUp(); });
+  phase("first_block", engines, 0, n, block);
+  phase("second_block", engines, 0, n, block);
+  phase("editor_open", engines, 0, n, [](auto& e) { e->setAnalyzerEnabled(true); });
+  phase("editor_close", engines, 0, n, [](auto& e) { e->setAnalyzerEnabled(false); });
+  phase("reactivate", engines, 0, n, configure);
+  phase("destroy", engines, 0, n, [](auto& e) { e.reset(); });
+  return 0;
+}
@@ -0,0 +1,187 @@
+// Cost and accuracy of the modeled tone stack (SVENDER_PARAM_TONE_STACK)
+// against the three-section EQ it replaces.
+//
+// filter: ns/sample of the knob sections at rest, the EQ as a cascade and in
+// its parallel form (what the engine runs once the EQ settles), the stack as
+// its high-pass + biquad cascade.
+// design: ns per control tick while a knob moves, three EQ redesigns
+// against one grid lookup, next to the exact circuit solve the grid stands
+// in for and the one-off grid build.
+// accuracy: per Mid Freq position, mean and largest deviation of the
+// interpolated stack from the exact circuit over 30 Hz-12 kHz, at random
+// knob settings.
+//
+//   tone_stack_bench [seconds-per-case] [sampleRate]
+
+#include "kernels.h"
+#include "tone_stack.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace SvenderBass;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using cd = std::complex<double>;
+
+constexpr int kBlock = DSP::kControlInterval;
+constexpr int kLength = 1 << 14;
+
+// Calls f(i) until `seconds` pass; returns ns per call.
+template <typename F>
+double timeNs(double seconds, F&& f) {
+  long calls = 0;
+  const auto t0 = Clock::now();
+  double elapsed = 0.0;
+  do {
+    for (int i = 0; i < 1024; ++i)
+      f(calls + i);
+    calls += 1024;
+    elapsed = std::chrono::duration<double>(Clock::now() - t0).count();
+  } while (elapsed < seconds);
+  return elapsed * 1e9 / (double)calls;
+}
+
+// Knob settings away from noon, so no EQ section is an identity.
+constexpr float kBass = 0.7f, kMid = 0.3f, kTreble = 0.65f;
+
+void designEq(DSP::Biquad* bq, DSP::DynamicShelf& bass, DSP::DynamicPeaking& mid, DSP::DynamicShelf& treble,
+              float bassDb, float midDb, float trebleDb) {
+  bass.design(bq[0], bassDb, true);
+  mid.design(bq[1], midDb, true);
+  treble.design(bq[2], trebleDb, true);
+}
+
+cd response(const DSP::Biquad& bq, double w) {
+  const cd z = std::polar(1.0, -w);
+  return ((double)bq.b0 + z * ((double)bq.b1 + z * (double)bq.b2)) / (1.0 + z * ((double)bq.a1 + z * (double)bq.a2));
+}
+
+// Exact stack at the analog frequency the bilinear transform maps to hz.
+double exactMagnitude(const DSP::ToneStack::Sections& s, double hz, double sampleRate) {
+  const double w = 2.0 * sampleRate * std::tan(DSP::kPiD * hz / sampleRate) / DSP::ToneStack::kRefRadPerSec;
+  const cd x(0.0, w);
+  const double p1 = std::exp(s.logP1), q0 = std::exp(s.logQ0), q1 = std::exp(s.logQ1);
+  const double n1 = std::exp(s.logN1), n2 = std::exp(s.logN2), n3 = std::exp(s.logN3);
+  return std::abs(x / (x + p1) * (n1 + x * (n2 + x * n3)) / (q0 + x * (q1 + x)));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const double seconds = argc > 1 ? std::atof(argv[1]) : 0.5;
+  const float sr = argc > 2 ? (float)std::atof(argv[2]) : 48000.0f;
+  const DSP::KernelTable& k = DSP::kernels();
+
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+  std::vector<float> xL(kLength), xR(kLength);
+  for (int i = 0; i < kLength; ++i) {
+    xL[i] = 0.5f * std::sin(0.011f * (float)i) + 0.1f * noise(rng);
+    xR[i] = 0.5f * std::sin(0.017f * (float)i) + 0.1f * noise(rng);
+  }
+
+  DSP::DynamicShelf bassShape, trebleShape;
+  DSP::DynamicPeaking midShape;
+  bassShape.setup(sr, 40.0f, false, 0.707f);
+  midShape.setup(sr, 800.0f, 0.9f);
+  trebleShape.setup(sr, 4000.0f, true, 0.707f);
+
+  const auto g0 = Clock::now();
+  DSP::ToneStack::prepare();
+  DSP::ToneStack stack;
+  stack.setup(sr, 2);
+  const double buildMs = std::chrono::duration<double>(Clock::now() - g0).count() * 1e3;
+
+  std::printf("# %s kernels, %.0f Hz\n", DSP::isaName(k.isa), sr);
+  std::printf("case,variant,ns\n");
+
+  // filter
+  {
+    DSP::Biquad eqL[3], eqR[3];
+    designEq(eqL, bassShape, midShape, trebleShape, 5.0f, -8.0f, 4.5f);
+    for (int s = 0; s < 3; ++s)
+      eqR[s].copyCoefficients(eqL[s]);
+    DSP::ParallelBiquads par;
+    const bool parallel = par.design(eqL, 3);
+
+    DSP::Biquad stL[2], stR[2];
+    stack.design(stL[0], stL[1], kBass, kMid, kTreble);
+    stR[0].copyCoefficients(stL[0]);
+    stR[1].copyCoefficients(stL[1]);
+
+    // Per channel sample: one block of both channels per call.
+    auto perSample = [&](auto&& run) { return timeNs(seconds, run) / (2.0 * kBlock); };
+    auto at = [&](long call) { return (int)(call * kBlock % kLength); };
+    std::printf("filter,eq_cascade,%.2f\n", perSample([&](long c) {
+      k.biquadCascade(eqL, 3, &xL[at(c)], kBlock);
+      k.biquadCascade(eqR, 3, &xR[at(c)], kBlock);
+    }));
+    if (parallel)
+      std::printf("filter,eq_parallel,%.2f\n",
+                  perSample([&](long c) { k.parallelBiquads(par, &xL[at(c)], &xR[at(c)], kBlock); }));
+    std::printf("filter,tone_stack,%.2f\n", perSample([&](long c) {
+      k.biquadCascade(stL, 2, &xL[at(c)], kBlock);
+      k.biquadCascade(stR, 2, &xR[at(c)], kBlock);
+    }));
+  }
+
+  // design
+  {
+    DSP::Biquad eq[3], st[2];
+    std::printf("design,eq,%.1f\n", timeNs(seconds, [&](long c) {
+      const float m = (float)(c & 255) / 255.0f;
+      designEq(eq, bassShape, midShape, trebleShape, 12.0f * m, -20.0f * m, 15.0f * m);
+    }));
+    std::printf("design,tone_stack,%.1f\n", timeNs(seconds, [&](long c) {
+      const float m = (float)(c & 255) / 255.0f;
+      stack.design(st[0], st[1], m, 1.0f - m, m);
+    }));
+    std::printf("design,exact_solve,%.1f\n", timeNs(seconds / 4, [&](long c) {
+      const float m = (float)(c & 255) / 255.0f;
+      volatile float sink = DSP::ToneStack::solve(2, m, 1.0 - m, m).logQ0;
+      (void)sink;
+    }));
+    std::printf("design,grid_build_all_voicings,%.0f\n", buildMs * 1e6);
+  }
+
+  // accuracy
+  std::printf("voicing,mean_err_db,max_err_db\n");
+  std::uniform_real_distribution<double> knob(0.0, 1.0);
+  for (int v = 0; v < DSP::ToneStack::kVoicings; ++v) {
+    stack.setup(sr, v);
+
+    // The grid is normalized so the stack peaks at 0 dB with the knobs at noon.
+    const DSP::ToneStack::Sections noon = DSP::ToneStack::solve(v, 0.5, 0.5, 0.5);
+    double peak = 0.0;
+    for (double hz = 20.0; hz < 12000.0; hz *= 1.02)
+      peak = std::max(peak, exactMagnitude(noon, hz, 1e12));
+
+    double sum = 0.0, worst = 0.0;
+    int count = 0;
+    for (int trial = 0; trial < 500; ++trial) {
+      const double b = knob(rng), m = knob(rng), t = knob(rng);
+      const DSP::ToneStack::Sections exact = DSP::ToneStack::solve(v, b, m, t);
+      DSP::Biquad lowCut, body;
+      stack.design(lowCut, body, (float)b, (float)m, (float)t);
+      for (double hz = 30.0; hz < 12000.0; hz *= 1.1) {
+        const double w = 2.0 * DSP::kPiD * hz / sr;
+        const double got = std::abs(response(lowCut, w) * response(body, w));
+        const double err = std::fabs(20.0 * std::log10(got * peak / exactMagnitude(exact, hz, sr)));
+        sum += err;
+        worst = std::max(worst, err);
+        ++count;
+      }
+    }
+    std::printf("%d,%.3f,%.2f\n", v, sum / count, worst);
+  }
+  return 0;
+}
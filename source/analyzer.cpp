@@ -0,0 +1,307 @@
+#include "analyzer.h"
+#include "dsp.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+namespace SvenderBass {
+
+namespace {
+
+constexpr float kMinHz = 20.0f;
+constexpr float kMaxHz = 20000.0f;
+constexpr float kFloorDb = -120.0f;
+constexpr float kReleasePerFrame = 0.3f; // fall toward lower readings; rises are immediate
+constexpr double kFramesPerSecond = 20.0;
+
+size_t nextPow2(size_t n) {
+  size_t p = 1;
+  while (p < n) p <<= 1;
+  return p;
+}
+
+} // namespace
+
+Analyzer::~Analyzer() {
+  stop();
+}
+
+// Window and twiddles for one FFT size, shared by every analyzer.
+struct Analyzer::FftTables {
+  std::vector<float> hann, twiddleRe, twiddleIm;
+};
+
+const Analyzer::FftTables& Analyzer::fftTables(int n) {
+  // One slot per size configure() picks: 4096, 8192, 16384. Built on first
+  // use; never freed, so workers of analyzers in static storage are safe.
+  static std::mutex mutex;
+  static FftTables* cache[3] = {};
+  const int slot = n <= 4096 ? 0 : (n <= 8192 ? 1 : 2);
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!cache[slot]) {
+    auto* t = new FftTables;
+    t->hann.resize((size_t)n);
+    for (int i = 0; i < n; ++i)
+      t->hann[(size_t)i] = (float)(0.5 - 0.5 * std::cos(2.0 * DSP::kPiD * i / n));
+    t->twiddleRe.resize((size_t)n / 2);
+    t->twiddleIm.resize((size_t)n / 2);
+    for (int k = 0; k < n / 2; ++k) {
+      t->twiddleRe[(size_t)k] = (float)std::cos(-2.0 * DSP::kPiD * k / n);
+      t->twiddleIm[(size_t)k] = (float)std::sin(-2.0 * DSP::kPiD * k / n);
+    }
+    cache[slot] = t;
+  }
+  return *cache[slot];
+}
+
+void Analyzer::configure(double sampleRate) {
+  const bool wasEnabled = enabled();
+  enabled_.store(false, std::memory_order_release);
+  stop();
+
+  sampleRate_ = sampleRate;
+  if (!wasEnabled) {
+    release();
+    return;
+  }
+  allocate();
+  setEnabled(true);
+}
+
+// The audio thread only touches the ring while enabled, and configure()
+// never runs concurrently with it, so both are safe there.
+void Analyzer::release() {
+  for (auto* v : { &ring_[0], &ring_[1], &ring_[2], &ring_[3], &window_, &re_, &im_, &history_[0], &history_[1],
+                   &bandEdgesHz_ })
+    std::vector<float>().swap(*v);
+  ringMask_ = 0;
+  tables_ = nullptr;
+}
+
+void Analyzer::allocate() {
+  const double sampleRate = sampleRate_;
+  fftSize_ = sampleRate <= 50000.0 ? 4096 : (sampleRate <= 100000.0 ? 8192 : 16384);
+  hop_ = std::max(256, (int)(sampleRate / kFramesPerSecond));
+
+  // Enough for the worker to sleep between polls without the tap dropping.
+  const size_t capacity = nextPow2(std::max<size_t>((size_t)fftSize_ * 2, (size_t)(sampleRate * 0.5)));
+  for (auto& ch : ring_)
+    ch.assign(capacity, 0.0f);
+  ringMask_ = capacity - 1;
+  write_.store(0);
+  read_.store(0);
+  pendingWrite_ = false;
+
+  const int n = fftSize_;
+  tables_ = &fftTables(n);
+  re_.assign((size_t)n, 0.0f);
+  im_.assign((size_t)n, 0.0f);
+  for (auto& h : history_)
+    h.assign((size_t)n, 0.0f);
+  window_.resize((size_t)n / 2 + 1);
+
+  const float maxHz = std::min(kMaxHz, (float)(0.45 * sampleRate));
+  bandEdgesHz_.resize(SVENDER_SPECTRUM_BINS + 1);
+  for (int i = 0; i <= SVENDER_SPECTRUM_BINS; ++i)
+    bandEdgesHz_[(size_t)i] = kMinHz * std::pow(maxHz / kMinHz, (float)i / SVENDER_SPECTRUM_BINS);
+
+  current_ = svender_dsp_spectrum {};
+  current_.min_hz = kMinHz;
+  current_.max_hz = maxHz;
+  std::fill(std::begin(current_.input_db), std::end(current_.input_db), kFloorDb);
+  std::fill(std::begin(current_.output_db), std::end(current_.output_db), kFloorDb);
+}
+
+void Analyzer::setEnabled(bool enabled) {
+  if (enabled == this->enabled())
+    return;
+
+  if (enabled) {
+    if (ringMask_ == 0)
+      allocate();
+    read_.store(write_.load(std::memory_order_acquire), std::memory_order_release);
+    start();
+    enabled_.store(true, std::memory_order_release);
+  } else {
+    enabled_.store(false, std::memory_order_release);
+    stop();
+  }
+}
+
+void Analyzer::start() {
+  running_.store(true);
+  worker_ = std::thread([this] { run(); });
+}
+
+void Analyzer::stop() {
+  running_.store(false);
+  if (worker_.joinable())
+    worker_.join();
+}
+
+void Analyzer::captureInput(const float* l, const float* r, int n) {
+  pendingWrite_ = false;
+  if (!enabled_.load(std::memory_order_acquire) || n <= 0)
+    return;
+
+  const size_t w = write_.load(std::memory_order_relaxed);
+  const size_t used = w - read_.load(std::memory_order_acquire);
+  if ((size_t)n > ringMask_ + 1 - used)
+    return; // worker behind: drop this block
+
+  const size_t start = w & ringMask_;
+  const size_t first = std::min((size_t)n, ringMask_ + 1 - start);
+  std::memcpy(&ring_[0][start], l, first * sizeof(float));
+  std::memcpy(&ring_[1][start], r, first * sizeof(float));
+  std::memcpy(&ring_[0][0], l + first, (n - first) * sizeof(float));
+  std::memcpy(&ring_[1][0], r + first, (n - first) * sizeof(float));
+  pendingWrite_ = true;
+}
+
+void Analyzer::captureOutput(const float* l, const float* r, int n) {
+  if (!pendingWrite_)
+    return;
+  pendingWrite_ = false;
+
+  const size_t w = write_.load(std::memory_order_relaxed);
+  const size_t start = w & ringMask_;
+  const size_t first = std::min((size_t)n, ringMask_ + 1 - start);
+  std::memcpy(&ring_[2][start], l, first * sizeof(float));
+  std::memcpy(&ring_[3][start], r, first * sizeof(float));
+  std::memcpy(&ring_[2][0], l + first, (n - first) * sizeof(float));
+  std::memcpy(&ring_[3][0], r + first, (n - first) * sizeof(float));
+  write_.store(w + (size_t)n, std::memory_order_release);
+}
+
+bool Analyzer::popSpectrum(svender_dsp_spectrum& out) {
+  bool any = false;
+  while (results_.pop(out))
+    any = true;
+  return any;
+}
+
+void Analyzer::run() {
+  const size_t mask = (size_t)fftSize_ - 1;
+  size_t histPos = 0;
+  size_t filled = 0;
+  int sinceFrame = 0;
+
+  while (running_.load(std::memory_order_relaxed)) {
+    const size_t w = write_.load(std::memory_order_acquire);
+    size_t r = read_.load(std::memory_order_relaxed);
+    if (w == r) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      continue;
+    }
+
+    // Far behind (e.g. after a stall): only the newest window matters.
+    if (w - r > (size_t)(fftSize_ + hop_)) {
+      r = w - (size_t)fftSize_;
+      filled = 0;
+      sinceFrame = std::max(0, hop_ - fftSize_);
+    }
+
+    const size_t n = std::min(w - r, (size_t)(hop_ - sinceFrame));
+    for (size_t i = 0; i < n; ++i) {
+      const size_t j = (r + i) & ringMask_;
+      history_[0][histPos] = 0.5f * (ring_[0][j] + ring_[1][j]);
+      history_[1][histPos] = 0.5f * (ring_[2][j] + ring_[3][j]);
+      histPos = (histPos + 1) & mask;
+    }
+    read_.store(r + n, std::memory_order_release);
+    filled += n;
+    sinceFrame += (int)n;
+
+    if (sinceFrame >= hop_) {
+      sinceFrame = 0;
+      if (filled >= (size_t)fftSize_) {
+        // Oldest sample first.
+        for (auto& h : history_)
+          std::rotate(h.begin(), h.begin() + (ptrdiff_t)histPos, h.end());
+        histPos = 0;
+        analyze();
+      }
+    }
+  }
+}
+
+void Analyzer::analyze() {
+  const int n = fftSize_;
+  const float df = (float)(sampleRate_ / n);
+  // Hann-windowed one-sided power, scaled so a full-scale sine sums to 1.
+  const float scale = 32.0f / (3.0f * (float)n * (float)n);
+
+  float* outDb[2] = { current_.input_db, current_.output_db };
+  const float* hann = tables_->hann.data();
+  const float* twiddleRe = tables_->twiddleRe.data();
+  const float* twiddleIm = tables_->twiddleIm.data();
+
+  for (int s = 0; s < 2; ++s) {
+    const std::vector<float>& x = history_[s];
+    for (int i = 0; i < n; ++i) {
+      re_[(size_t)i] = x[(size_t)i] * hann[i];
+      im_[(size_t)i] = 0.0f;
+    }
+
+    // Iterative radix-2 FFT.
+    for (int i = 1, j = 0; i < n; ++i) {
+      int bit = n >> 1;
+      for (; j & bit; bit >>= 1) j ^= bit;
+      j ^= bit;
+      if (i < j) {
+        std::swap(re_[(size_t)i], re_[(size_t)j]);
+        std::swap(im_[(size_t)i], im_[(size_t)j]);
+      }
+    }
+    for (int len = 2; len <= n; len <<= 1) {
+      const int half = len >> 1;
+      const int step = n / len;
+      for (int i = 0; i < n; i += len) {
+        for (int k = 0; k < half; ++k) {
+          const float wr = twiddleRe[k * step];
+          const float wi = twiddleIm[k * step];
+          const size_t a = (size_t)(i + k), b = a + (size_t)half;
+          const float tr = re_[b] * wr - im_[b] * wi;
+          const float ti = re_[b] * wi + im_[b] * wr;
+          re_[b] = re_[a] - tr;
+          im_[b] = im_[a] - ti;
+          re_[a] += tr;
+          im_[a] += ti;
+        }
+      }
+    }
+
+    for (int k = 0; k <= n / 2; ++k)
+      window_[(size_t)k] = (re_[(size_t)k] * re_[(size_t)k] + im_[(size_t)k] * im_[(size_t)k]) * scale;
+
+    // Log-spaced bands: power summed over the FFT bins inside each band, or
+    // interpolated at the band center where a band is narrower than a bin.
+    for (int b = 0; b < SVENDER_SPECTRUM_BINS; ++b) {
+      const float lo = bandEdgesHz_[(size_t)b] / df;
+      const float hi = bandEdgesHz_[(size_t)b + 1] / df;
+      const int k0 = (int)std::ceil(lo);
+      const int k1 = std::min((int)std::ceil(hi), n / 2 + 1);
+      float p = 0.0f;
+      if (k1 > k0) {
+        for (int k = k0; k < k1; ++k) p += window_[(size_t)k];
+      } else {
+        const float c = 0.5f * (lo + hi);
+        const int k = std::min((int)c, n / 2 - 1);
+        const float t = c - (float)k;
+        p = window_[(size_t)k] * (1.0f - t) + window_[(size_t)k + 1] * t;
+      }
+
+      const float db = std::max(kFloorDb, 10.0f * std::log10(std::max(p, 1e-12f)));
+      float& y = outDb[s][b];
+      y = db > y ? db : y + (db - y) * kReleasePerFrame;
+    }
+  }
+
+  ++current_.sequence;
+  results_.push(current_); // dropped if the reader is behind
+}
+
+} // namespace SvenderBass
@@ -0,0 +1,79 @@
+#pragma once
+#include "spsc_ring.h"
+#include "svender_dsp.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace SvenderBass {
+
+// Input vs output spectrum for the editor. The audio thread only copies
+// samples into a preallocated ring (and only while enabled); windowing, FFT,
+// log-frequency banding and smoothing run on a worker thread that exists only
+// while the analyzer is enabled. Finished frames come back through a
+// wait-free ring. Buffers are only allocated once the analyzer is first
+// enabled, and the FFT tables are shared by every analyzer in the process,
+// so instances without an open editor cost neither memory nor setup time.
+class Analyzer {
+public:
+  Analyzer() = default;
+  ~Analyzer();
+  Analyzer(const Analyzer&) = delete;
+  Analyzer& operator=(const Analyzer&) = delete;
+
+  // Not real-time safe. Allocates for the sample rate if enabled, else
+  // frees; keeps the enabled state.
+  void configure(double sampleRate);
+
+  // Not real-time safe: allocates on first use, starts or joins the worker.
+  void setEnabled(bool enabled);
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  // Audio thread. Input is captured before processing (the host may process
+  // in place) and published together with the output.
+  void captureInput(const float* l, const float* r, int n);
+  void captureOutput(const float* l, const float* r, int n);
+
+  // Newest finished frame, if any since the last call. Single consumer.
+  bool popSpectrum(svender_dsp_spectrum& out);
+
+private:
+  static constexpr int kChannels = 4; // in L, in R, out L, out R
+
+  struct FftTables;
+  static const FftTables& fftTables(int n);
+
+  void allocate();
+  void release();
+  void start();
+  void stop();
+  void run();
+  void analyze();
+
+  double sampleRate_ = 44100.0;
+  int fftSize_ = 4096;
+  int hop_ = 2048;
+
+  // Sample ring shared with the worker; one write index for all channels.
+  std::vector<float> ring_[kChannels];
+  size_t ringMask_ = 0;
+  std::atomic<size_t> write_ {0};
+  std::atomic<size_t> read_ {0};
+  bool pendingWrite_ = false;
+
+  std::atomic<bool> enabled_ {false};
+  std::atomic<bool> running_ {false};
+  std::thread worker_;
+
+  // Worker-only state.
+  const FftTables* tables_ = nullptr;
+  std::vector<float> window_, re_, im_;
+  std::vector<float> history_[2]; // mono in / out, last fftSize_ samples
+  std::vector<float> bandEdgesHz_;
+  svender_dsp_spectrum current_ {};
+
+  DSP::SpscRing<svender_dsp_spectrum, 4> results_;
+};
+
+} // namespace SvenderBass
@@ -1,9 +1,12 @@
 #include "controller.h"
 #include "editor.h"
+#include "telemetry.h"
 
 #include "public.sdk/source/vst/vstparameters.h"
 #include "pluginterfaces/vst/ivsteditcontroller.h"
 
+#include <algorithm>
+
 using namespace Steinberg;
 using namespace Steinberg::Vst;
 
@@ -33,6 +36,25 @@ tresult PLUGIN_API Controller::initialize(FUnknown* context)
     parameters.addParameter(STR16("Ultra High"), STR16(""), 1, 0.0,
                             ParameterInfo::kCanAutomate, kParamUltraHigh);
 
+    parameters.addParameter(STR16("Saturation Mode"), STR16(""), 4, 0.0,
+                            ParameterInfo::kCanAutomate, kParamSatMode);
+    parameters.addParameter(STR16("Drive Crossover"), STR16(""), 4, 0.0,
+                            ParameterInfo::kCanAutomate, kParamCrossover);
+    parameters.addParameter(STR16("Tone Stack"), STR16(""), 1, 0.0,
+                            ParameterInfo::kCanAutomate, kParamToneStack);
+
+    parameters.addParameter(STR16("Tuner"),      STR16(""), 1, 0.0,
+                            ParameterInfo::kCanAutomate, kParamTuner);
+    parameters.addParameter(STR16("Tuner Mute"), STR16(""), 1, 1.0,
+                            ParameterInfo::kCanAutomate, kParamTunerMute);
+    parameters.addParameter(STR16("Tuner Note"),  STR16(""), 127, 0.0,
+                            ParameterInfo::kIsReadOnly, kParamTunerNote);
+    parameters.addParameter(STR16("Tuner Cents"), STR16("ct"), 0, 0.5,
+                            ParameterInfo::kIsReadOnly, kParamTunerCents);
+
+    parameters.addParameter(STR16("Fixed Internal Rate"), STR16(""), 1, 0.0,
+                            ParameterInfo::kNoFlags, kParamInternalRate);
+
     return kResultOk;
 }
 
@@ -45,4 +67,114 @@ IPlugView* PLUGIN_API Controller::createView(FIDString name)
     return nullptr;
 }
 
+tresult PLUGIN_API Controller::setParamNormalized(Steinberg::Vst::ParamID tag, ParamValue value)
+{
+    const ParamValue previous = getParamNormalized(tag);
+    tresult res = EditController::setParamNormalized(tag, value);
+    if (res != kResultOk)
+        return res;
+
+    const ParamValue actual = getParamNormalized(tag);
+    for (Editor* editor : editors_)
+        editor->paramChanged(tag, actual);
+
+    // The processor picks the rate up on reactivation, which the latency
+    // change makes the host do.
+    if (tag == kParamInternalRate && (actual >= 0.5) != (previous >= 0.5))
+    {
+        sendInternalRate(actual >= 0.5);
+        if (componentHandler)
+            componentHandler->restartComponent(kLatencyChanged);
+    }
+    return kResultOk;
+}
+
+void Controller::editorAttached(EditorView* editor)
+{
+    editors_.push_back(static_cast<Editor*>(editor));
+    if (editors_.size() == 1)
+        sendAnalyzerEnabled(true);
+}
+
+void Controller::editorRemoved(EditorView* editor)
+{
+    editors_.erase(std::remove(editors_.begin(), editors_.end(), static_cast<Editor*>(editor)),
+                   editors_.end());
+    if (editors_.empty())
+        sendAnalyzerEnabled(false);
+}
+
+void Controller::sendAnalyzerEnabled(bool enabled)
+{
+    IPtr<IMessage> message = owned(allocateMessage());
+    if (!message)
+        return;
+    message->setMessageID(kAnalyzerMessageID);
+    message->getAttributes()->setInt(kAnalyzerEnabledAttr, enabled ? 1 : 0);
+    sendMessage(message);
+}
+
+void Controller::sendInternalRate(bool fixed)
+{
+    IPtr<IMessage> message = owned(allocateMessage());
+    if (!message)
+        return;
+    message->setMessageID(kInternalRateMessageID);
+    message->getAttributes()->setInt(kInternalRateAttr, fixed ? 1 : 0);
+    sendMessage(message);
+}
+
+tresult PLUGIN_API Controller::notify(IMessage* message)
+{
+    if (dataExchange_.onMessage(message))
+        return kResultTrue;
+    return EditController::notify(message);
+}
+
+void PLUGIN_API Controller::queueOpened(DataExchangeUserContextID, uint32, TBool& dispatchOnBackgroundThread)
+{
+    // Meter frames are tiny; take them on the UI thread next to the editors.
+    dispatchOnBackgroundThread = false;
+}
+
+void PLUGIN_API Controller::queueClosed(DataExchangeUserContextID)
+{
+    meters_ = svender_dsp_meters {};
+    spectrum_ = svender_dsp_spectrum {};
+}
+
+void PLUGIN_API Controller::onDataExchangeBlocksReceived(DataExchangeUserContextID, uint32 numBlocks,
+                                                         DataExchangeBlock* blocks, TBool)
+{
+    for (uint32 b = 0; b < numBlocks; ++b)
+    {
+        const DataExchangeBlock& block = blocks[b];
+        if (!block.data || block.size < sizeof(TelemetryHeader))
+            continue;
+
+        const auto* header = static_cast<const TelemetryHeader*>(block.data);
+        const uint32 payload = block.size - (uint32)sizeof(TelemetryHeader);
+        if (header->kind == kTelemetryMeters && header->count > 0 &&
+            header->count <= payload / sizeof(svender_dsp_meters))
+        {
+            // Latest levels, but keep peaks that fell between UI updates.
+            const auto* frames = reinterpret_cast<const svender_dsp_meters*>(header + 1);
+            svender_dsp_meters m = frames[header->count - 1];
+            for (uint32 i = 0; i + 1 < header->count; ++i)
+            {
+                m.input_peak = std::max(m.input_peak, frames[i].input_peak);
+                m.saturation_peak = std::max(m.saturation_peak, frames[i].saturation_peak);
+                m.output_peak = std::max(m.output_peak, frames[i].output_peak);
+                m.sag = std::max(m.sag, frames[i].sag);
+            }
+            meters_ = m;
+        }
+        else if (header->kind == kTelemetrySpectrum && header->count == 1 &&
+                 payload >= sizeof(svender_dsp_spectrum))
+        {
+            spectrum_ = *reinterpret_cast<const svender_dsp_spectrum*>(header + 1);
+        }
+    }
+}
+
 } // namespace SvenderBass
@@ -3,12 +3,20 @@
 #include "public.sdk/source/vst/vsteditcontroller.h"
 #include "pluginterfaces/gui/iplugview.h"
 #include "pluginterfaces/base/fstrdefs.h"
+#include "pluginterfaces/vst/ivstdataexchange.h"
+#include "public.sdk/source/vst/utility/dataexchange.h"
 
 #include "ids.h"
+#include "svender_dsp.h"
+
+#include <vector>
 
 namespace SvenderBass {
 
-class Controller final : public Steinberg::Vst::EditController {
+class Editor;
+
+class Controller final : public Steinberg::Vst::EditController,
+                         public Steinberg::Vst::IDataExchangeReceiver {
 public:
   Controller() = default;
 
@@ -21,6 +29,50 @@ public:
 
   // VST3 UI factory hook ("editor" view)
   Steinberg::IPlugView* PLUGIN_API createView(const char* name) override;
+
+  // Pushes every change (host automation, presets, UI edits) to the open
+  // editors so they never need to poll.
+  Steinberg::tresult PLUGIN_API setParamNormalized(Steinberg::Vst::ParamID tag,
+                                                   Steinberg::Vst::ParamValue value) override;
+
+  void editorAttached(Steinberg::Vst::EditorView* editor) override;
+  void editorRemoved(Steinberg::Vst::EditorView* editor) override;
+
+  // Telemetry from the Processor (telemetry.h), via IDataExchangeReceiver or
+  // the SDK's message fallback.
+  Steinberg::tresult PLUGIN_API notify(Steinberg::Vst::IMessage* message) override;
+
+  void PLUGIN_API queueOpened(Steinberg::Vst::DataExchangeUserContextID userContextID,
+                              Steinberg::uint32 blockSize,
+                              Steinberg::TBool& dispatchOnBackgroundThread) override;
+  void PLUGIN_API queueClosed(Steinberg::Vst::DataExchangeUserContextID userContextID) override;
+  void PLUGIN_API onDataExchangeBlocksReceived(Steinberg::Vst::DataExchangeUserContextID userContextID,
+                                               Steinberg::uint32 numBlocks,
+                                               Steinberg::Vst::DataExchangeBlock* blocks,
+                                               Steinberg::TBool onBackgroundThread) override;
+
+  // Most recent meter frame; zeroed while the processor is inactive.
+  const svender_dsp_meters& meters() const { return meters_; }
+
+  // Most recent spectrum frame. The analyzer only runs while an editor is
+  // open; sequence stays put otherwise.
+  const svender_dsp_spectrum& spectrum() const { return spectrum_; }
+
+  OBJ_METHODS(Controller, Steinberg::Vst::EditController)
+  DEFINE_INTERFACES
+    DEF_INTERFACE(Steinberg::Vst::IDataExchangeReceiver)
+  END_DEFINE_INTERFACES(Steinberg::Vst::EditController)
+  REFCOUNT_METHODS(Steinberg::Vst::EditController)
+
+private:
+  void sendAnalyzerEnabled(bool enabled);
+  void sendInternalRate(bool fixed);
+
+  std::vector<Editor*> editors_;
+
+  Steinberg::Vst::DataExchangeReceiverHandler dataExchange_ {this};
+  svender_dsp_meters meters_ {};
+  svender_dsp_spectrum spectrum_ {};
 };
 
 } // namespace SvenderBass
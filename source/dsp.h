@@ -2,22 +2,68 @@
 #include <cmath>
 #include <algorithm>
 
+#include "fastmath.h"
+
 namespace SvenderBass::DSP {
 
 constexpr float kPi = 3.14159265358979323846f;
+constexpr double kPiD = 3.14159265358979323846;
+
+// Envelope-derived controls (dynamic drive, post shelves) are evaluated every
+// kControlInterval samples on a grid that runs independently of the host block.
+constexpr int kControlInterval = 32;
 
 inline float dbToLin(float db) { return std::pow(10.0f, db / 20.0f); }
 inline float clamp(float x, float lo, float hi) { return std::max(lo, std::min(x, hi)); }
 
-struct Smoother {
+// One-pole parameter ramp that stops once it has converged. While the value
+// moves, run() writes per-sample values; once it is within kSettleTol of the
+// target it snaps there and run() only reports "constant", so callers can use
+// a plain block gain. step() is the same filter at control rate.
+struct Ramp {
+  static constexpr float kSettleTol = 1.0e-5f; // relative, ~-100 dB
   float a = 0.0f;
   float y = 0.0f;
-  void setTimeMs(float sr, float ms) {
+  bool settled = true;
+
+  void setTimeMs(float rate, float ms) {
     const float t = std::max(0.001f, ms) * 0.001f;
-    a = std::exp(-1.0f / (t * sr));
+    a = std::exp(-1.0f / (t * rate));
+  }
+
+  void reset(float v) { y = v; settled = true; }
+
+  // True when the value is y for the whole block; otherwise out[0..n) holds
+  // the ramp. It settles on the same sample however the stream is sliced.
+  bool run(float target, float* out, int n) {
+    if (settled && target == y)
+      return true;
+    settled = false;
+    int i = 0;
+    while (i < n && !settled) {
+      y = a * y + (1.0f - a) * target;
+      settle(target);
+      out[i++] = y;
+    }
+    std::fill(out + i, out + n, y);
+    return false;
+  }
+
+  // Advances one tick; returns true when the value changed.
+  bool step(float target) {
+    if (settled && target == y)
+      return false;
+    y = a * y + (1.0f - a) * target;
+    settle(target);
+    return true;
+  }
+
+private:
+  void settle(float target) {
+    settled = std::fabs(y - target) <= kSettleTol * std::max(1.0f, std::fabs(target));
+    if (settled)
+      y = target;
   }
-  float process(float x) { y = a * y + (1.0f - a) * x; return y; }
-  void reset(float v) { y = v; }
 };
 
 struct EnvelopeFollower {
@@ -68,6 +114,13 @@ struct Biquad {
 
   void reset() { z1 = z2 = 0.0f; }
 
+  // Unity passthrough: what every gain-based design gives at 0 dB.
+  bool isIdentity() const { return b0 == 1.0f && b1 == a1 && b2 == a2; }
+
+  void copyCoefficients(const Biquad& o) {
+    b0 = o.b0; b1 = o.b1; b2 = o.b2; a1 = o.a1; a2 = o.a2;
+  }
+
   float process(float x) {
     float y = b0*x + z1;
     z1 = b1*x - a1*y + z2;
@@ -76,10 +129,17 @@ struct Biquad {
   }
 
   void setLowShelf(float sr, float f0, float gainDb, float Q=0.707f) {
-    float A = std::pow(10.0f, gainDb/40.0f);
     float w0 = 2.0f * float(kPi) * (f0 / sr);
-    float cw = std::cos(w0), sw = std::sin(w0);
-    float alpha = sw/(2.0f*Q);
+    setLowShelfShape(std::pow(10.0f, gainDb/40.0f), std::cos(w0), std::sin(w0)/(2.0f*Q));
+  }
+
+  void setHighShelf(float sr, float f0, float gainDb, float Q=0.707f) {
+    float w0 = 2.0f * float(kPi) * (f0 / sr);
+    setHighShelfShape(std::pow(10.0f, gainDb/40.0f), std::cos(w0), std::sin(w0)/(2.0f*Q));
+  }
+
+  // RBJ shelves from precomputed shape terms (A, cos(w0), alpha).
+  void setLowShelfShape(float A, float cw, float alpha) {
     float sqrtA = std::sqrt(A);
 
     float b0n =    A*((A+1) - (A-1)*cw + 2*sqrtA*alpha);
@@ -93,11 +153,7 @@ struct Biquad {
     a1 = a1n/a0n; a2 = a2n/a0n;
   }
 
-  void setHighShelf(float sr, float f0, float gainDb, float Q=0.707f) {
-    float A = std::pow(10.0f, gainDb/40.0f);
-    float w0 = 2.0f * float(kPi) * (f0 / sr);
-    float cw = std::cos(w0), sw = std::sin(w0);
-    float alpha = sw/(2.0f*Q);
+  void setHighShelfShape(float A, float cw, float alpha) {
     float sqrtA = std::sqrt(A);
 
     float b0n =    A*((A+1) + (A-1)*cw + 2*sqrtA*alpha);
@@ -159,6 +215,74 @@ struct Biquad {
     b0 = b0n/a0n; b1 = b1n/a0n; b2 = b2n/a0n;
     a1 = a1n/a0n; a2 = a2n/a0n;
   }
+
+  void setAllpass(float sr, float f0, float Q=0.707f) {
+    float w0 = 2.0f * float(kPi) * (f0 / sr);
+    float cw = std::cos(w0), sw = std::sin(w0);
+    float alpha = sw/(2.0f*Q);
+
+    float a0n = 1 + alpha;
+    b0 = (1 - alpha)/a0n; b1 = -2*cw/a0n; b2 = 1.0f;
+    a1 = b1; a2 = b0;
+  }
+};
+
+// Fixed-frequency shelf whose gain moves at control rate. The trig terms are
+// computed once per sample rate; a redesign only costs one exp and a sqrt and
+// is skipped entirely while the gain stays within kGainEpsDb.
+struct DynamicShelf {
+  static constexpr float kGainEpsDb = 0.01f;
+  float cw = 1.0f;
+  float alpha = 0.0f;
+  float gainDb = 0.0f;
+  bool high = false;
+
+  void setup(float sr, float f0, bool highShelf, float Q = 0.707f) {
+    float w0 = 2.0f * float(kPi) * (f0 / sr);
+    cw = std::cos(w0);
+    alpha = std::sin(w0) / (2.0f * Q);
+    high = highShelf;
+  }
+
+  // Returns true when the coefficients changed.
+  bool design(Biquad& bq, float db, bool force = false) {
+    if (!force && std::fabs(db - gainDb) < kGainEpsDb)
+      return false;
+    gainDb = db;
+    const float A = std::exp(db * (2.302585093f / 40.0f));
+    if (high) bq.setHighShelfShape(A, cw, alpha);
+    else      bq.setLowShelfShape(A, cw, alpha);
+    return true;
+  }
+};
+
+// Peaking EQ counterpart of DynamicShelf: geometry fixed by setup(), gain
+// redesigned cheaply as it ramps.
+struct DynamicPeaking {
+  static constexpr float kGainEpsDb = DynamicShelf::kGainEpsDb;
+  float cw = 1.0f;
+  float alpha = 0.0f;
+  float gainDb = 0.0f;
+
+  void setup(float sr, float f0, float Q) {
+    float w0 = 2.0f * float(kPi) * (f0 / sr);
+    cw = std::cos(w0);
+    alpha = std::sin(w0) / (2.0f * Q);
+  }
+
+  bool design(Biquad& bq, float db, bool force = false) {
+    if (!force && std::fabs(db - gainDb) < kGainEpsDb)
+      return false;
+    gainDb = db;
+    const float A = std::exp(db * (2.302585093f / 40.0f));
+    const float a0 = 1.0f + alpha / A;
+    bq.b0 = (1.0f + alpha * A) / a0;
+    bq.b1 = (-2.0f * cw) / a0;
+    bq.b2 = (1.0f - alpha * A) / a0;
+    bq.a1 = bq.b1;
+    bq.a2 = (1.0f - alpha / A) / a0;
+    return true;
+  }
 };
 
 struct Oversampler2x {
@@ -226,8 +350,8 @@ struct Oversampler4x {
 
 inline float tubeStage(float x, float drive, float bias) {
   float y = x * drive + bias;
-  y = std::tanh(y);
-  y -= std::tanh(bias);
+  y = fastTanh(y);
+  y -= fastTanh(bias);
   return y;
 }
 
@@ -247,4 +371,213 @@ inline float tubeSat(float x, float drive) {
   return tubeSatMulti(x, drive);
 }
 
+// ---------------------------------------------------------------------------
+// Antiderivative anti-aliasing (ADAA) for the tube stages.
+//
+// For the biased stage f(x) = tanh(d*x + b) - tanh(b) the antiderivatives are
+//   F1(x) = logcosh(d*x + b) / d - tanh(b) * x
+//   F2(x) = Lc2(d*x + b) / d^2   - tanh(b) * x^2 / 2
+// where Lc2(u) is the integral of logcosh from 0 to u, expressed through the
+// dilogarithm. Everything is evaluated in double: the divided differences
+// cancel catastrophically in float.
+
+namespace ADAA {
+
+constexpr double kLn2 = 0.69314718055994530942;
+constexpr double kPi2Over12 = 0.82246703342411321824;
+// Below this input step the divided difference is ill-conditioned and the
+// stages fall back to evaluating the lower-order function at the midpoint.
+constexpr double kEps = 1.0e-5;
+
+inline double logCosh(double u) {
+  const double a = std::fabs(u);
+  return a + std::log1p(std::exp(-2.0 * a)) - kLn2;
+}
+
+// Li2(y) for y = 1 - exp(-t), t in [0, ln 2], via the Bernoulli series.
+inline double dilogSeries(double t) {
+  const double t2 = t * t;
+  return t - 0.25 * t2 + t * t2 * (1.0 / 36.0 + t2 * (-1.0 / 3600.0 + t2 * (1.0 / 211680.0 +
+         t2 * (-1.0 / 10886400.0 + t2 * (1.0 / 526901760.0)))));
+}
+
+// Integral of logcosh over [0, u]. Odd in u; for u >= 0 it equals
+// u^2/2 - u ln2 + (pi^2/12 + Li2(-e^{-2u})) / 2, with the dilog mapped into
+// its fast-converging range by the Landen identity.
+inline double logCoshIntegral(double u) {
+  const double a = std::fabs(u);
+  const double t = std::log1p(std::exp(-2.0 * a));
+  const double r = 0.5 * a * a - a * kLn2 + 0.5 * (kPi2Over12 - dilogSeries(t) - 0.5 * t * t);
+  return u < 0.0 ? -r : r;
+}
+
+struct Stage {
+  double d = 1.0;
+  double b = 0.0;
+  double tb = 0.0;
+
+  // Once, at construction: on the audio path the compiler could fold
+  // tanh(bias) in some inlined copies and not others, and the output would
+  // depend on which specialization of the chain ran (host block size).
+  void setBias(double bias) { b = bias; tb = std::tanh(bias); }
+
+  double f(double x) const { return std::tanh(d * x + b) - tb; }
+  double F1(double x) const { return logCosh(d * x + b) / d - tb * x; }
+  double F2(double x) const { return logCoshIntegral(d * x + b) / (d * d) - 0.5 * tb * x * x; }
+};
+
+// First order: y = (F1(x) - F1(x1)) / (x - x1). Adds half a sample of delay.
+struct TubeStage1 {
+  Stage st;
+  double x1 = 0.0;
+
+  void reset() { x1 = 0.0; }
+
+  double process(double x, double drive) {
+    st.d = drive;
+    const double dx = x - x1;
+    const double y = (std::fabs(dx) > kEps)
+      ? (st.F1(x) - st.F1(x1)) / dx
+      : st.f(0.5 * (x + x1));
+    x1 = x;
+    return y;
+  }
+};
+
+// Second order (Bilbao/Esqueda/Parker form). Adds one sample of delay.
+struct TubeStage2 {
+  Stage st;
+  double x1 = 0.0;
+  double x2 = 0.0;
+
+  void reset() { x1 = x2 = 0.0; }
+
+  double process(double x, double drive) {
+    st.d = drive;
+    const double d01 = divided(x, x1);
+    const double d12 = divided(x1, x2);
+    const double dx = x - x2;
+
+    double y;
+    if (std::fabs(dx) > kEps) {
+      y = 2.0 * (d01 - d12) / dx;
+    } else {
+      const double xb = 0.5 * (x + x2);
+      const double delta = xb - x1;
+      y = (std::fabs(delta) > kEps)
+        ? 2.0 / delta * (st.F1(xb) + (st.F2(x1) - st.F2(xb)) / delta)
+        : st.f(0.5 * (xb + x1));
+    }
+
+    x2 = x1;
+    x1 = x;
+    return y;
+  }
+
+private:
+  double divided(double a, double b) const {
+    const double d = a - b;
+    return (std::fabs(d) > kEps) ? (st.F2(a) - st.F2(b)) / d : st.F1(0.5 * (a + b));
+  }
+};
+
+} // namespace ADAA
+
+// ADAA counterpart of tubeSatMulti: same drives and biases per stage.
+template <class StageT>
+struct TubeSatADAA {
+  StageT s[3];
+
+  TubeSatADAA() {
+    s[0].st.setBias(0.08);
+    s[1].st.setBias(-0.04);
+    s[2].st.setBias(0.02);
+  }
+
+  void reset() { for (auto& st : s) st.reset(); }
+
+  float process(float x, float drive) {
+    double y = x;
+    y = s[0].process(y, drive);
+    y = s[1].process(y, drive * 0.7 + 0.3);
+    y = s[2].process(y, drive * 0.5 + 0.5);
+    return (float)y;
+  }
+};
+
+using TubeSatADAA1 = TubeSatADAA<ADAA::TubeStage1>;
+using TubeSatADAA2 = TubeSatADAA<ADAA::TubeStage2>;
+
+// Saturation modes, in kParamSatMode order.
+enum class SatMode : int {
+  Oversample4x = 0,
+  Adaa1_1x,
+  Adaa1_2x,
+  Adaa2_1x,
+  Adaa2_2x,
+  Count
+};
+
+// Per-channel saturation stage: 4x brute-force oversampling through
+// Oversampler4x, or the ADAA tube stages at 1x or 2x (the 2x modes reuse the
+// first half-band stage of the 4x oversampler).
+struct Saturator {
+  SatMode mode = SatMode::Oversample4x;
+  Oversampler4x os;
+  TubeSatADAA1 adaa1;
+  TubeSatADAA2 adaa2;
+
+  void setSampleRate(float sr) { os.setSampleRate(sr); }
+
+  void reset() {
+    os.reset();
+    adaa1.reset();
+    adaa2.reset();
+  }
+
+  void setMode(SatMode m) {
+    if (m == mode)
+      return;
+    mode = m;
+    reset();
+  }
+
+  float process(float x, float drive) {
+    switch (mode) {
+      case SatMode::Adaa1_1x: return processAs<SatMode::Adaa1_1x>(x, drive);
+      case SatMode::Adaa1_2x: return processAs<SatMode::Adaa1_2x>(x, drive);
+      case SatMode::Adaa2_1x: return processAs<SatMode::Adaa2_1x>(x, drive);
+      case SatMode::Adaa2_2x: return processAs<SatMode::Adaa2_2x>(x, drive);
+      default:                return processAs<SatMode::Oversample4x>(x, drive);
+    }
+  }
+
+  // process() for a mode fixed at compile time; M must equal mode.
+  template <SatMode M>
+  float processAs(float x, float drive) {
+    if constexpr (M == SatMode::Adaa1_1x) {
+      return adaa1.process(x, drive);
+    } else if constexpr (M == SatMode::Adaa2_1x) {
+      return adaa2.process(x, drive);
+    } else if constexpr (M == SatMode::Adaa1_2x || M == SatMode::Adaa2_2x) {
+      float u0 = 0.0f, u1 = 0.0f;
+      os.s1.upsample(x, u0, u1);
+      if constexpr (M == SatMode::Adaa1_2x) {
+        u0 = adaa1.process(u0, drive);
+        u1 = adaa1.process(u1, drive);
+      } else {
+        u0 = adaa2.process(u0, drive);
+        u1 = adaa2.process(u1, drive);
+      }
+      return os.s1.downsample(u0, u1);
+    } else {
+      float up[4] = {};
+      os.upsample(x, up);
+      for (int i = 0; i < 4; ++i)
+        up[i] = tubeSatMulti(up[i], drive);
+      return os.downsample(up);
+    }
+  }
+};
+
 } // namespace SvenderBass::DSP
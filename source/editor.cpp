@@ -1,6 +1,9 @@
 #include "editor.h"
+#include "editor_model.h"
+#include "faceplate_cache.h"
 #include "ids.h"
 
+#include <filesystem>
 #include <memory>
 #include <string>
 #include <cstring>
@@ -55,12 +58,12 @@ static std::wstring getModuleDirW()
   return std::wstring(path);
 }
 
-static std::wstring buildResourcePathW(const wchar_t* fileName)
+static std::wstring getResourceDirW()
 {
   // Typical module dir:
   //   ...\SvenderBass.vst3\Contents\x86_64-win
   // Resources are:
-  //   ...\SvenderBass.vst3\Contents\Resources\<fileName>
+  //   ...\SvenderBass.vst3\Contents\Resources
 
   wchar_t p[MAX_PATH] = {};
   std::wstring dllDir = getModuleDirW();
@@ -69,63 +72,26 @@ static std::wstring buildResourcePathW(const wchar_t* fileName)
   // Move from x86_64-win -> Contents
   PathRemoveFileSpecW(p);
 
-  // Append Resources\<fileName>
   PathAppendW(p, L"Resources");
-  PathAppendW(p, fileName);
-
   return std::wstring(p);
 }
 
 static constexpr UINT_PTR kAnimTimerId = 1;
 static constexpr UINT kAnimTimerMs = 16;
-static constexpr int kKnobCount = 6;
-
-static const Steinberg::Vst::ParamID kKnobParams[kKnobCount] =
-{
-  kParamInputGain,
-  kParamBass,
-  kParamMid,
-  kParamTreble,
-  kParamDrive,
-  kParamOutput
-};
-
-static int knobIndexFromParam(Steinberg::Vst::ParamID paramId)
-{
-  for (int i = 0; i < kKnobCount; ++i)
-  {
-    if (kKnobParams[i] == paramId)
-      return i;
-  }
-  return -1;
-}
 
-static float clamp01(float v)
+static UI::Rect toUiRect(const RECT& r)
 {
-  if (v < 0.0f) return 0.0f;
-  if (v > 1.0f) return 1.0f;
-  return v;
+  return UI::Rect{ (int)r.left, (int)r.top, (int)r.right, (int)r.bottom };
 }
 
-static float normalizedToAngleRad(float v)
+static RECT toWinRect(const UI::Rect& r)
 {
-  // Map [0..1] to a 240-degree sweep (-120 to +120), where 0 is top center.
-  const float startDeg = -120.0f;
-  const float endDeg = 120.0f;
-  const float deg = startDeg + (endDeg - startDeg) * clamp01(v);
-  const float mathDeg = deg - 90.0f;
-  const float pi = 3.14159265358979323846f;
-  return mathDeg * (pi / 180.0f);
-}
-
-static bool pointInRect(const POINT& p, const RECT& r)
-{
-  return p.x >= r.left && p.x < r.right && p.y >= r.top && p.y < r.bottom;
+  return RECT{ r.left, r.top, r.right, r.bottom };
 }
 
 static std::wstring formatDisplayValueOneDecimal(float normalized)
 {
-  const float clamped = clamp01(normalized);
+  const float clamped = normalized < 0.0f ? 0.0f : (normalized > 1.0f ? 1.0f : normalized);
   const float display = clamped * 11.0f; // 0.0 to 11.0
 
   wchar_t buf[32] = {};
@@ -133,73 +99,29 @@ static std::wstring formatDisplayValueOneDecimal(float normalized)
   return std::wstring(buf);
 }
 
-static RECT getInputDisplayRect(const RECT& knobRect)
+// GDI+ objects used by WM_PAINT. Built once and rebuilt only when the client
+// size (and with it the pen width and font size) changes.
+struct PaintCache
 {
-  const int cx = (knobRect.left + knobRect.right) / 2;
-  const int cy = (knobRect.top + knobRect.bottom) / 2;
-  const int knobW = knobRect.right - knobRect.left;
-  const int knobH = knobRect.bottom - knobRect.top;
-  const int w = (int)(knobW * 0.60f);
-  const int h = (int)(knobH * 0.18f);
-
-  RECT r{};
-  r.left = cx - w / 2;
-  r.right = r.left + w;
-  r.top = cy - h / 2;
-  r.bottom = r.top + h;
-  return r;
-}
-
-static RECT offsetRect(const RECT& r, float dx, float dy)
-{
-  RECT out{};
-  out.left = (int)(r.left + dx);
-  out.right = (int)(r.right + dx);
-  out.top = (int)(r.top + dy);
-  out.bottom = (int)(r.bottom + dy);
-  return out;
-}
-
-static const float kTextOffsetX = 20.0f; // 40 right + 10 left + 20 left + 10 right
-static const float kTextOffsetY = 46.0f; // 40 down + 4 down + 4 down - 2 up
-static const float kDriveTextOffsetX = 5.0f;
-
-static RECT getTextRectForKnob(const RECT& knobRect, Steinberg::Vst::ParamID paramId)
-{
-  RECT rc = offsetRect(getInputDisplayRect(knobRect), kTextOffsetX, kTextOffsetY);
-  if (paramId == kParamDrive)
-    rc = offsetRect(rc, kDriveTextOffsetX, 0.0f);
-  return rc;
-}
-
-static RECT scaleRect(const RECT& r, float sx, float sy)
-{
-  RECT out{};
-  out.left = (int)(r.left * sx + 0.5f);
-  out.top = (int)(r.top * sy + 0.5f);
-  out.right = (int)(r.right * sx + 0.5f);
-  out.bottom = (int)(r.bottom * sy + 0.5f);
-  return out;
-}
-
-static void getClientScale(HWND hWnd, float& sx, float& sy)
-{
-  RECT rc{};
-  GetClientRect(hWnd, &rc);
-  const float designW = 1200.0f;
-  const float designH = 450.0f;
-  const float w = (float)(rc.right - rc.left);
-  const float h = (float)(rc.bottom - rc.top);
-  sx = (designW > 0.0f) ? (w / designW) : 1.0f;
-  sy = (designH > 0.0f) ? (h / designH) : 1.0f;
-}
+  float penWidth = -1.0f;
+  std::unique_ptr<Gdiplus::Pen> indicatorPen;
+  std::unique_ptr<Gdiplus::SolidBrush> toggleBrush;
+  std::unique_ptr<Gdiplus::FontFamily> fontFamily;
+  std::unique_ptr<Gdiplus::Font> font;
+  std::unique_ptr<Gdiplus::SolidBrush> textBrush;
+  std::unique_ptr<Gdiplus::SolidBrush> shadowBrush;
+  std::unique_ptr<Gdiplus::SolidBrush> highlightBrush;
+  std::unique_ptr<Gdiplus::StringFormat> fmt;
+};
 
 struct EditorWin32State
 {
   HWND hwnd = nullptr;
 
-  std::unique_ptr<Gdiplus::Image> faceplate;
-  std::wstring faceplatePath;
+  // Shared, prescaled to the client size (see faceplate_cache.h); painting
+  // it is a straight copy.
+  std::shared_ptr<const UI::Image> faceplate;
+  std::filesystem::path resourceDir;
 
   // EditController provides begin/perform/endEdit helpers.
   Steinberg::Vst::EditController* controller = nullptr;
@@ -208,40 +130,53 @@ struct EditorWin32State
   Steinberg::Vst::ParamID activeParam = 0;
   int lastY = 0;
 
-  float animValues[kKnobCount]{};
-  float animTargets[kKnobCount]{};
-  bool animInitialized = false;
-  UINT_PTR animTimer = 0;
-
-  // Hardcoded hit area for the Input knob on a 1200x450 faceplate.
-  RECT inputKnobRect{ 87, 140, 257, 310 };
-  // Bass knob is 198px to the right of input (moved +98px), same size.
-  RECT bassKnobRect{ 286, 140, 456, 310 };
-  // Mid knob is 125px to the right of bass, same size.
-  RECT midKnobRect{ 418, 140, 588, 310 };
-  // Treble knob is 132px to the right of mid, same size.
-  RECT trebleKnobRect{ 566, 140, 736, 310 };
-  // Drive knob is 132px to the right of treble, same size.
-  RECT driveKnobRect{ 698, 140, 868, 310 };
-  // Output knob is 150px to the right of drive, same size.
-  RECT outputKnobRect{ 914, 140, 1084, 310 };
-  // Ultra Low toggle: center from faceplate@2x (784, 680) -> (392, 340), ~40px wide at 2x.
-  RECT ultraLowRect{ 382, 330, 402, 350 };
-  // Ultra High toggle: center from faceplate@2x (1340, 680) -> (670, 340), same size as Ultra Low.
-  RECT ultraHighRect{ 660, 330, 680, 350 };
+  // Geometry and animation live in editor_model.h; this file only maps them
+  // onto Win32. The frame timer runs only while a knob is still moving.
+  UI::Layout layout;
+  UI::KnobAnimator anim;
+  bool timerRunning = false;
+
+  PaintCache paint;
 };
 
-static RECT getKnobRectForParam(const EditorWin32State* st, Steinberg::Vst::ParamID paramId)
+static void updatePaintCache(EditorWin32State* st)
+{
+  PaintCache& pc = st->paint;
+  const float penWidth = st->layout.indicatorPenWidth();
+  if (pc.indicatorPen && pc.penWidth == penWidth)
+    return;
+
+  pc.penWidth = penWidth;
+  pc.indicatorPen.reset(new Gdiplus::Pen(Gdiplus::Color(255, 0, 0, 0), (Gdiplus::REAL)penWidth));
+  if (!pc.toggleBrush)
+  {
+    pc.toggleBrush.reset(new Gdiplus::SolidBrush(Gdiplus::Color(220, 200, 20, 20)));
+    pc.textBrush.reset(new Gdiplus::SolidBrush(Gdiplus::Color(255, 0, 0, 0)));
+    pc.shadowBrush.reset(new Gdiplus::SolidBrush(Gdiplus::Color(160, 0, 0, 0)));
+    pc.highlightBrush.reset(new Gdiplus::SolidBrush(Gdiplus::Color(180, 255, 255, 255)));
+    pc.fontFamily.reset(new Gdiplus::FontFamily(L"Segoe UI"));
+    pc.fmt.reset(new Gdiplus::StringFormat());
+    pc.fmt->SetAlignment(Gdiplus::StringAlignmentCenter);
+    pc.fmt->SetLineAlignment(Gdiplus::StringAlignmentCenter);
+  }
+
+  const UI::Rect sampleTextRc = st->layout.textRect(0);
+  const float textH = (float)(sampleTextRc.bottom - sampleTextRc.top);
+  const float fontSize = (textH > 0.0f) ? textH * 0.65f : 10.0f;
+  pc.font.reset(new Gdiplus::Font(pc.fontFamily.get(), fontSize, Gdiplus::FontStyleBold, Gdiplus::UnitPixel));
+}
+
+static void onClientResized(EditorWin32State* st, int width, int height)
 {
-  if (!st)
-    return RECT{};
-
-  if (paramId == kParamBass) return st->bassKnobRect;
-  if (paramId == kParamMid) return st->midKnobRect;
-  if (paramId == kParamTreble) return st->trebleKnobRect;
-  if (paramId == kParamDrive) return st->driveKnobRect;
-  if (paramId == kParamOutput) return st->outputKnobRect;
-  return st->inputKnobRect;
+  st->layout.setClientSize(width, height);
+  st->faceplate = UI::FaceplateCache::shared().get(st->resourceDir, width, height);
+  st->paint.penWidth = -1.0f;
+}
+
+static void invalidate(EditorWin32State* st, const UI::Rect& r)
+{
+  const RECT rc = toWinRect(r);
+  InvalidateRect(st->hwnd, &rc, FALSE);
 }
 
 static void initAnimation(EditorWin32State* st)
@@ -249,25 +184,25 @@ static void initAnimation(EditorWin32State* st)
   if (!st || !st->controller)
     return;
 
-  for (int i = 0; i < kKnobCount; ++i)
-  {
-    const float v = (float)st->controller->getParamNormalized(kKnobParams[i]);
-    st->animValues[i] = v;
-    st->animTargets[i] = v;
-  }
-  st->animInitialized = true;
+  for (int i = 0; i < UI::kKnobCount; ++i)
+    st->anim.reset(i, (float)st->controller->getParamNormalized(UI::kKnobParams[i]));
 }
 
-static float getAnimatedValue(const EditorWin32State* st, Steinberg::Vst::ParamID paramId)
+// Called for every parameter change reaching the controller: host automation,
+// preset loads and this editor's own edits alike.
+static void onParamChanged(EditorWin32State* st, Steinberg::Vst::ParamID paramId, float value)
 {
-  if (!st || !st->controller)
-    return 0.0f;
-
-  const int idx = knobIndexFromParam(paramId);
-  if (idx < 0 || !st->animInitialized)
-    return (float)st->controller->getParamNormalized(paramId);
+  const int knob = UI::knobIndexFromParam((int)paramId);
+  if (knob >= 0)
+  {
+    if (st->anim.setTarget(knob, value) && !st->timerRunning)
+      st->timerRunning = SetTimer(st->hwnd, kAnimTimerId, kAnimTimerMs, nullptr) != 0;
+    return;
+  }
 
-  return st->animValues[idx];
+  const int toggle = UI::toggleIndexFromParam((int)paramId);
+  if (toggle >= 0)
+    invalidate(st, st->layout.toggleRect(toggle));
 }
 
 static LRESULT CALLBACK EditorWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
@@ -283,75 +218,48 @@ static LRESULT CALLBACK EditorWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
       return DefWindowProcW(hWnd, msg, wParam, lParam);
     }
 
+    case WM_SIZE:
+    {
+      if (st)
+      {
+        onClientResized(st, LOWORD(lParam), HIWORD(lParam));
+        InvalidateRect(hWnd, nullptr, FALSE);
+      }
+      break;
+    }
+
     case WM_LBUTTONDOWN:
     {
       if (!st || !st->controller)
         break;
 
-      POINT p{ GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam) };
-      float sx = 1.0f;
-      float sy = 1.0f;
-      getClientScale(hWnd, sx, sy);
-      const RECT ultraLowRc = scaleRect(st->ultraLowRect, sx, sy);
-      const RECT inputKnobRc = scaleRect(st->inputKnobRect, sx, sy);
-      const RECT inputTextRc = getTextRectForKnob(inputKnobRc, kParamInputGain);
-      const RECT bassKnobRc = scaleRect(st->bassKnobRect, sx, sy);
-      const RECT bassTextRc = getTextRectForKnob(bassKnobRc, kParamBass);
-      const RECT midKnobRc = scaleRect(st->midKnobRect, sx, sy);
-      const RECT midTextRc = getTextRectForKnob(midKnobRc, kParamMid);
-      const RECT trebleKnobRc = scaleRect(st->trebleKnobRect, sx, sy);
-      const RECT trebleTextRc = getTextRectForKnob(trebleKnobRc, kParamTreble);
-      const RECT driveKnobRc = scaleRect(st->driveKnobRect, sx, sy);
-      const RECT driveTextRc = getTextRectForKnob(driveKnobRc, kParamDrive);
-      const RECT outputKnobRc = scaleRect(st->outputKnobRect, sx, sy);
-      const RECT outputTextRc = getTextRectForKnob(outputKnobRc, kParamOutput);
-      const RECT ultraHighRc = scaleRect(st->ultraHighRect, sx, sy);
-
-      if (pointInRect(p, ultraLowRc))
-      {
-        const ParamValue cur = st->controller->getParamNormalized(kParamUltraLow);
-        const ParamValue next = (cur >= 0.5 ? 0.0 : 1.0);
-        st->controller->beginEdit(kParamUltraLow);
-        st->controller->setParamNormalized(kParamUltraLow, next);
-        st->controller->performEdit(kParamUltraLow, next);
-        st->controller->endEdit(kParamUltraLow);
-        InvalidateRect(hWnd, &ultraLowRc, FALSE);
-        return 0;
-      }
-      if (pointInRect(p, ultraHighRc))
+      const int x = GET_X_LPARAM(lParam);
+      const int y = GET_Y_LPARAM(lParam);
+
+      const int toggle = st->layout.toggleAt(x, y);
+      if (toggle >= 0)
       {
-        const ParamValue cur = st->controller->getParamNormalized(kParamUltraHigh);
+        const Steinberg::Vst::ParamID id = UI::kToggleParams[toggle];
+        const ParamValue cur = st->controller->getParamNormalized(id);
         const ParamValue next = (cur >= 0.5 ? 0.0 : 1.0);
-        st->controller->beginEdit(kParamUltraHigh);
-        st->controller->setParamNormalized(kParamUltraHigh, next);
-        st->controller->performEdit(kParamUltraHigh, next);
-        st->controller->endEdit(kParamUltraHigh);
-        InvalidateRect(hWnd, &ultraHighRc, FALSE);
+        st->controller->beginEdit(id);
+        st->controller->setParamNormalized(id, next);
+        st->controller->performEdit(id, next);
+        st->controller->endEdit(id);
         return 0;
       }
 
-      if (pointInRect(p, inputKnobRc) || pointInRect(p, inputTextRc))
-        st->activeParam = kParamInputGain;
-      else if (pointInRect(p, bassKnobRc) || pointInRect(p, bassTextRc))
-        st->activeParam = kParamBass;
-      else if (pointInRect(p, midKnobRc) || pointInRect(p, midTextRc))
-        st->activeParam = kParamMid;
-      else if (pointInRect(p, trebleKnobRc) || pointInRect(p, trebleTextRc))
-        st->activeParam = kParamTreble;
-      else if (pointInRect(p, driveKnobRc) || pointInRect(p, driveTextRc))
-        st->activeParam = kParamDrive;
-      else if (pointInRect(p, outputKnobRc) || pointInRect(p, outputTextRc))
-        st->activeParam = kParamOutput;
-      else
+      const int knob = st->layout.knobAt(x, y);
+      if (knob < 0)
         break;
 
+      st->activeParam = UI::kKnobParams[knob];
       st->draggingParam = true;
-      st->lastY = p.y;
+      st->lastY = y;
       SetCapture(hWnd);
 
       st->controller->beginEdit(st->activeParam);
       return 0;
-      break;
     }
 
     case WM_MOUSEMOVE:
@@ -359,35 +267,20 @@ static LRESULT CALLBACK EditorWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
       if (!st || !st->controller || !st->draggingParam)
         break;
 
-      POINT p{ GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam) };
-
-      const int dy = p.y - st->lastY;
-      st->lastY = p.y;
+      const int y = GET_Y_LPARAM(lParam);
+      const int dy = y - st->lastY;
+      st->lastY = y;
+      if (dy == 0)
+        return 0;
 
       const ParamValue cur = st->controller->getParamNormalized(st->activeParam);
       float next = (float)cur - (float)dy / 150.0f;
-      next = clamp01(next);
+      next = next < 0.0f ? 0.0f : (next > 1.0f ? 1.0f : next);
 
       // performEdit is the important call for automation + notifying the host.
+      // setParamNormalized comes back through onParamChanged to animate.
       st->controller->setParamNormalized(st->activeParam, next);
       st->controller->performEdit(st->activeParam, next);
-
-      const int activeIdx = knobIndexFromParam(st->activeParam);
-      if (activeIdx >= 0)
-        st->animTargets[activeIdx] = next;
-
-      float sx = 1.0f;
-      float sy = 1.0f;
-      getClientScale(hWnd, sx, sy);
-      const RECT knobRc = scaleRect(
-        st->activeParam == kParamBass ? st->bassKnobRect :
-        st->activeParam == kParamMid ? st->midKnobRect :
-        st->activeParam == kParamTreble ? st->trebleKnobRect :
-        st->activeParam == kParamDrive ? st->driveKnobRect :
-        st->activeParam == kParamOutput ? st->outputKnobRect : st->inputKnobRect, sx, sy);
-      RECT inv = getTextRectForKnob(knobRc, st->activeParam);
-      InvalidateRect(hWnd, &knobRc, FALSE);
-      InvalidateRect(hWnd, &inv, FALSE);
       return 0;
     }
 
@@ -410,37 +303,18 @@ static LRESULT CALLBACK EditorWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
 
     case WM_TIMER:
     {
-      if (!st || !st->controller || wParam != kAnimTimerId)
+      if (!st || wParam != kAnimTimerId)
         break;
 
-      bool anyChange = false;
-      for (int i = 0; i < kKnobCount; ++i)
-      {
-        const float target = (float)st->controller->getParamNormalized(kKnobParams[i]);
-        st->animTargets[i] = target;
-
-        const float cur = st->animValues[i];
-        const float next = cur + (target - cur) * 0.25f;
-        const float delta = target - next;
-        st->animValues[i] = (std::fabs(delta) < 0.0005f) ? target : next;
+      UI::DirtyRegion dirty;
+      const bool moving = st->anim.tick(st->layout, dirty);
+      for (int i = 0; i < dirty.count; ++i)
+        invalidate(st, dirty.rects[i]);
 
-        if (std::fabs(target - st->animValues[i]) > 0.0005f)
-          anyChange = true;
-      }
-
-      if (anyChange)
+      if (!moving)
       {
-        float sx = 1.0f;
-        float sy = 1.0f;
-        getClientScale(hWnd, sx, sy);
-
-        for (int i = 0; i < kKnobCount; ++i)
-        {
-          const RECT knobRc = scaleRect(getKnobRectForParam(st, kKnobParams[i]), sx, sy);
-          const RECT textRc = getTextRectForKnob(knobRc, kKnobParams[i]);
-          InvalidateRect(hWnd, &knobRc, FALSE);
-          InvalidateRect(hWnd, &textRc, FALSE);
-        }
+        KillTimer(hWnd, kAnimTimerId);
+        st->timerRunning = false;
       }
       return 0;
     }
@@ -455,210 +329,101 @@ static LRESULT CALLBACK EditorWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
         RECT rcPaint = ps.rcPaint;
         const int paintW = rcPaint.right - rcPaint.left;
         const int paintH = rcPaint.bottom - rcPaint.top;
+        const UI::Rect paintRc = toUiRect(rcPaint);
 
         HDC memDC = CreateCompatibleDC(hdc);
         HBITMAP memBmp = CreateCompatibleBitmap(hdc, paintW, paintH);
         HGDIOBJ oldBmp = SelectObject(memDC, memBmp);
 
-        HBRUSH br = CreateSolidBrush(RGB(0, 0, 0));
-        RECT localRc{ 0, 0, paintW, paintH };
-        FillRect(memDC, &localRc, br);
-        DeleteObject(br);
+        const UI::Image* fp = st->faceplate.get();
+        if (fp && !fp->empty())
+        {
+          // 1:1 copy of the update region out of the prescaled faceplate.
+          BITMAPINFO bmi{};
+          bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+          bmi.bmiHeader.biWidth = fp->width;
+          bmi.bmiHeader.biHeight = -fp->height; // top-down
+          bmi.bmiHeader.biPlanes = 1;
+          bmi.bmiHeader.biBitCount = 32;
+          bmi.bmiHeader.biCompression = BI_RGB;
+          StretchDIBits(memDC, 0, 0, paintW, paintH,
+                        rcPaint.left, rcPaint.top, paintW, paintH,
+                        fp->pixels.data(), &bmi, DIB_RGB_COLORS, SRCCOPY);
+        }
+        else
+        {
+          RECT localRc{ 0, 0, paintW, paintH };
+          FillRect(memDC, &localRc, (HBRUSH)GetStockObject(BLACK_BRUSH));
+        }
 
         Gdiplus::Graphics g(memDC);
-        g.SetInterpolationMode(Gdiplus::InterpolationModeHighQualityBicubic);
         g.SetClip(Gdiplus::Rect(0, 0, paintW, paintH));
 
-        RECT rcClient{};
-        GetClientRect(hWnd, &rcClient);
-        const int w = rcClient.right - rcClient.left;
-        const int h = rcClient.bottom - rcClient.top;
-
-        if (st->faceplate && st->faceplate->GetLastStatus() == Gdiplus::Ok)
-          g.DrawImage(st->faceplate.get(), -rcPaint.left, -rcPaint.top, w, h);
-
         if (st->controller)
         {
-          float sx = 1.0f;
-          float sy = 1.0f;
-          getClientScale(hWnd, sx, sy);
-          const RECT inputKnobRc = scaleRect(st->inputKnobRect, sx, sy);
-          const RECT bassKnobRc = scaleRect(st->bassKnobRect, sx, sy);
-          const RECT midKnobRc = scaleRect(st->midKnobRect, sx, sy);
-          const RECT trebleKnobRc = scaleRect(st->trebleKnobRect, sx, sy);
-          const RECT driveKnobRc = scaleRect(st->driveKnobRect, sx, sy);
-          const RECT outputKnobRc = scaleRect(st->outputKnobRect, sx, sy);
-          const RECT ultraLowRc = scaleRect(st->ultraLowRect, sx, sy);
-          const RECT ultraHighRc = scaleRect(st->ultraHighRect, sx, sy);
-
-          const RECT sampleTextRc = getTextRectForKnob(inputKnobRc, kParamInputGain);
-          const float textH = (float)(sampleTextRc.bottom - sampleTextRc.top);
-          const float fontSize = (textH > 0.0f) ? textH * 0.65f : 10.0f;
-
-          Gdiplus::FontFamily fontFamily(L"Segoe UI");
-          Gdiplus::Font font(&fontFamily, fontSize, Gdiplus::FontStyleBold, Gdiplus::UnitPixel);
-          Gdiplus::SolidBrush textBrush(Gdiplus::Color(255, 0, 0, 0));
-          Gdiplus::SolidBrush shadowBrush(Gdiplus::Color(160, 0, 0, 0));
-          Gdiplus::SolidBrush highlightBrush(Gdiplus::Color(180, 255, 255, 255));
-          Gdiplus::StringFormat fmt;
-          fmt.SetAlignment(Gdiplus::StringAlignmentCenter);
-          fmt.SetLineAlignment(Gdiplus::StringAlignmentCenter);
-          g.SetTextRenderingHint(Gdiplus::TextRenderingHintClearTypeGridFit);
+          updatePaintCache(st);
+          const PaintCache& pc = st->paint;
+          const float ox = (float)rcPaint.left;
+          const float oy = (float)rcPaint.top;
 
+          g.SetTextRenderingHint(Gdiplus::TextRenderingHintClearTypeGridFit);
           g.SetSmoothingMode(Gdiplus::SmoothingModeAntiAlias);
-          Gdiplus::Pen indicatorPen(Gdiplus::Color(255, 0, 0, 0),
-                                    (Gdiplus::REAL)(textH * 0.10f));
-          const auto drawIndicator = [&](Steinberg::Vst::ParamID id, const RECT& knobRc)
+
+          for (int i = 0; i < UI::kKnobCount; ++i)
           {
-            const float norm = getAnimatedValue(st, id);
-            float angle = normalizedToAngleRad(norm);
-            float cx = (float)(knobRc.left + knobRc.right) * 0.5f - (float)rcPaint.left;
-            float cy = (float)(knobRc.top + knobRc.bottom) * 0.5f - (float)rcPaint.top;
-            const float w = (float)(knobRc.right - knobRc.left);
-            const float h = (float)(knobRc.bottom - knobRc.top);
-            const float minDim = (w < h) ? w : h;
-            float x1 = 0.0f;
-            float y1 = 0.0f;
-            float x2 = 0.0f;
-            float y2 = 0.0f;
-
-            if (id == kParamInputGain || id == kParamBass || id == kParamMid || id == kParamTreble ||
-                id == kParamDrive || id == kParamOutput)
-            {
-              const float startDeg = -130.0f;
-              const float endDeg = 120.0f;
-              const float deg = startDeg + (endDeg - startDeg) * clamp01(norm);
-              const float mathDeg = deg - 90.0f;
-              const float pi = 3.14159265358979323846f;
-              angle = mathDeg * (pi / 180.0f);
-
-              if (id == kParamBass)
-              {
-                const float baseCx = (float)(inputKnobRc.left + inputKnobRc.right) * 0.5f - (float)rcPaint.left;
-                const float baseCy = (float)(inputKnobRc.top + inputKnobRc.bottom) * 0.5f - (float)rcPaint.top;
-                cx = baseCx + (214.0f * sx);
-                cy = baseCy + (46.0f * sy);
-              }
-              else if (id == kParamMid)
-              {
-                const float baseCx = (float)(inputKnobRc.left + inputKnobRc.right) * 0.5f - (float)rcPaint.left;
-                const float baseCy = (float)(inputKnobRc.top + inputKnobRc.bottom) * 0.5f - (float)rcPaint.top;
-                cx = baseCx + (349.0f * sx);
-                cy = baseCy + (46.0f * sy);
-              }
-              else if (id == kParamTreble)
-              {
-                const float trebleCx = (float)(trebleKnobRc.left + trebleKnobRc.right) * 0.5f - (float)rcPaint.left;
-                const float trebleCy = (float)(trebleKnobRc.top + trebleKnobRc.bottom) * 0.5f - (float)rcPaint.top;
-                cx = trebleCx + (19.0f * sx);
-                cy = trebleCy + (46.0f * sy);
-              }
-              else if (id == kParamDrive)
-              {
-                const float driveCx = (float)(driveKnobRc.left + driveKnobRc.right) * 0.5f - (float)rcPaint.left;
-                const float driveCy = (float)(driveKnobRc.top + driveKnobRc.bottom) * 0.5f - (float)rcPaint.top;
-                cx = driveCx + (24.0f * sx);
-                cy = driveCy + (46.0f * sy);
-              }
-              else if (id == kParamOutput)
-              {
-                const float outputCx = (float)(outputKnobRc.left + outputKnobRc.right) * 0.5f - (float)rcPaint.left;
-                const float outputCy = (float)(outputKnobRc.top + outputKnobRc.bottom) * 0.5f - (float)rcPaint.top;
-                cx = outputCx + (21.0f * sx);
-                cy = outputCy + (46.0f * sy);
-              }
-              else
-              {
-                cx += 19.0f * sx;
-                cy += 46.0f * sy;
-              }
-              const float length = (minDim * 0.20f) - (6.0f * sx);
-              const float start = length * 0.5f;
-              x1 = cx + start * std::cos(angle);
-              y1 = cy + start * std::sin(angle);
-              x2 = cx + length * std::cos(angle);
-              y2 = cy + length * std::sin(angle);
-            }
-            else
-            {
-              const float inner = minDim * 0.10f;
-              const float outer = minDim * 0.42f;
-              x1 = cx + inner * std::cos(angle);
-              y1 = cy + inner * std::sin(angle);
-              x2 = cx + outer * std::cos(angle);
-              y2 = cy + outer * std::sin(angle);
-            }
-
-            g.DrawLine(&indicatorPen, x1, y1, x2, y2);
-          };
+            const float norm = st->anim.value(i);
+            if (!st->layout.indicatorBounds(i, norm).intersects(paintRc))
+              continue;
+
+            const UI::IndicatorLine l = st->layout.indicator(i, norm);
+            g.DrawLine(pc.indicatorPen.get(), l.x1 - ox, l.y1 - oy, l.x2 - ox, l.y2 - oy);
+          }
 
           /*
-          const auto drawValue = [&](Steinberg::Vst::ParamID id, const RECT& knobRc)
+          const auto drawValue = [&](int knob)
           {
+            const Steinberg::Vst::ParamID id = UI::kKnobParams[knob];
             if (id == kParamInputGain && !(st->draggingParam && st->activeParam == kParamInputGain))
               return;
 
-            const RECT textRc = getTextRectForKnob(knobRc, id);
-            const float norm = getAnimatedValue(st, id);
+            const UI::Rect textRc = st->layout.textRect(knob);
+            const float norm = st->anim.value(knob);
             std::wstring valueText = formatDisplayValueOneDecimal(norm);
 
             Gdiplus::RectF layout(
-              (float)(textRc.left - rcPaint.left),
-              (float)(textRc.top - rcPaint.top),
+              (float)textRc.left - ox,
+              (float)textRc.top - oy,
               (float)(textRc.right - textRc.left),
               (float)(textRc.bottom - textRc.top)
             );
             Gdiplus::RectF shadowLayout = layout;
             shadowLayout.X -= 1.0f;
             shadowLayout.Y -= 1.0f;
-            g.DrawString(valueText.c_str(), -1, &font, shadowLayout, &fmt, &shadowBrush);
+            g.DrawString(valueText.c_str(), -1, pc.font.get(), shadowLayout, pc.fmt.get(), pc.shadowBrush.get());
 
             Gdiplus::RectF highlightLayout = layout;
             highlightLayout.X += 1.0f;
             highlightLayout.Y += 1.0f;
-            g.DrawString(valueText.c_str(), -1, &font, highlightLayout, &fmt, &highlightBrush);
+            g.DrawString(valueText.c_str(), -1, pc.font.get(), highlightLayout, pc.fmt.get(), pc.highlightBrush.get());
 
-            g.DrawString(valueText.c_str(), -1, &font, layout, &fmt, &textBrush);
+            g.DrawString(valueText.c_str(), -1, pc.font.get(), layout, pc.fmt.get(), pc.textBrush.get());
           };
-          */
 
-          drawIndicator(kParamInputGain, inputKnobRc);
-          drawIndicator(kParamBass, bassKnobRc);
-          drawIndicator(kParamMid, midKnobRc);
-          drawIndicator(kParamTreble, trebleKnobRc);
-          drawIndicator(kParamDrive, driveKnobRc);
-          drawIndicator(kParamOutput, outputKnobRc);
-
-          /*
-          drawValue(kParamInputGain, inputKnobRc);
-          drawValue(kParamBass, bassKnobRc);
-          drawValue(kParamMid, midKnobRc);
-          drawValue(kParamTreble, trebleKnobRc);
-          drawValue(kParamDrive, driveKnobRc);
-          drawValue(kParamOutput, outputKnobRc);
+          for (int i = 0; i < UI::kKnobCount; ++i)
+            drawValue(i);
           */
 
-          const ParamValue ultraLow = st->controller->getParamNormalized(kParamUltraLow);
-          if (ultraLow >= 0.5)
+          for (int i = 0; i < UI::kToggleCount; ++i)
           {
-            const Gdiplus::REAL ulW = (Gdiplus::REAL)(ultraLowRc.right - ultraLowRc.left) - 2.0f;
-            const Gdiplus::REAL ulH = (Gdiplus::REAL)(ultraLowRc.bottom - ultraLowRc.top) - 2.0f;
-            Gdiplus::SolidBrush redBrush(Gdiplus::Color(220, 200, 20, 20));
-            g.FillEllipse(&redBrush,
-                          (Gdiplus::REAL)(ultraLowRc.left - rcPaint.left) + 1.0f,
-                          (Gdiplus::REAL)(ultraLowRc.top - rcPaint.top) + 1.0f,
-                          ulW, ulH);
-          }
-          const ParamValue ultraHigh = st->controller->getParamNormalized(kParamUltraHigh);
-          if (ultraHigh >= 0.5)
-          {
-            const Gdiplus::REAL uhW = (Gdiplus::REAL)(ultraHighRc.right - ultraHighRc.left) - 2.0f;
-            const Gdiplus::REAL uhH = (Gdiplus::REAL)(ultraHighRc.bottom - ultraHighRc.top) - 2.0f;
-            Gdiplus::SolidBrush redBrush(Gdiplus::Color(220, 200, 20, 20));
-            g.FillEllipse(&redBrush,
-                          (Gdiplus::REAL)(ultraHighRc.left - rcPaint.left) + 1.0f,
-                          (Gdiplus::REAL)(ultraHighRc.top - rcPaint.top) + 1.0f,
-                          uhW, uhH);
+            const UI::Rect rc = st->layout.toggleRect(i);
+            if (!rc.intersects(paintRc) || st->controller->getParamNormalized(UI::kToggleParams[i]) < 0.5)
+              continue;
+
+            g.FillEllipse(pc.toggleBrush.get(),
+                          (Gdiplus::REAL)rc.left - ox + 1.0f,
+                          (Gdiplus::REAL)rc.top - oy + 1.0f,
+                          (Gdiplus::REAL)(rc.right - rc.left) - 2.0f,
+                          (Gdiplus::REAL)(rc.bottom - rc.top) - 2.0f);
           }
         }
 
@@ -677,7 +442,7 @@ static LRESULT CALLBACK EditorWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM
     {
       if (st)
       {
-        if (st->animTimer)
+        if (st->timerRunning)
           KillTimer(hWnd, kAnimTimerId);
         SetWindowLongPtrW(hWnd, GWLP_USERDATA, 0);
         delete st;
@@ -715,8 +480,8 @@ Editor::Editor(EditController* controller)
 {
   rect_.left   = 0;
   rect_.top    = 0;
-  rect_.right  = 1200;
-  rect_.bottom = 450;
+  rect_.right  = UI::kDesignWidth;
+  rect_.bottom = UI::kDesignHeight;
 
 #ifdef _WIN32
   ensureGdiPlusStarted();
@@ -742,8 +507,7 @@ tresult PLUGIN_API Editor::attached(void* parent, FIDString type)
   // EditorView provides getController() (non-static). We store the interface pointer.
   st->controller = this->getController();
 
-  st->faceplatePath = buildResourcePathW(L"faceplate.png");
-  st->faceplate.reset(new Gdiplus::Image(st->faceplatePath.c_str()));
+  st->resourceDir = getResourceDirW();
 
   HWND parentHwnd = (HWND)parent;
 
@@ -768,8 +532,11 @@ tresult PLUGIN_API Editor::attached(void* parent, FIDString type)
     return kInternalError;
   }
 
+  RECT rcClient{};
+  GetClientRect(st->hwnd, &rcClient);
+  onClientResized(st, rcClient.right - rcClient.left, rcClient.bottom - rcClient.top);
   initAnimation(st);
-  st->animTimer = SetTimer(st->hwnd, kAnimTimerId, kAnimTimerMs, nullptr);
+  win32_ = st;
 
   tresult r = EditorView::attached(parent, type);
   InvalidateRect(st->hwnd, nullptr, TRUE);
@@ -781,9 +548,28 @@ tresult PLUGIN_API Editor::attached(void* parent, FIDString type)
 
 tresult PLUGIN_API Editor::removed()
 {
+#ifdef _WIN32
+  // WM_NCDESTROY frees the state.
+  if (win32_)
+  {
+    DestroyWindow(win32_->hwnd);
+    win32_ = nullptr;
+  }
+#endif
   return EditorView::removed();
 }
 
+void Editor::paramChanged(Steinberg::Vst::ParamID paramId, ParamValue value)
+{
+#ifdef _WIN32
+  if (win32_)
+    onParamChanged(win32_, paramId, (float)value);
+#else
+  (void)paramId;
+  (void)value;
+#endif
+}
+
 tresult PLUGIN_API Editor::getSize(ViewRect* size)
 {
   if (!size)
@@ -799,6 +585,31 @@ tresult PLUGIN_API Editor::onSize(ViewRect* newSize)
     return kInvalidArgument;
 
   rect_ = *newSize;
+
+#ifdef _WIN32
+  if (win32_)
+    SetWindowPos(win32_->hwnd, nullptr, 0, 0, rect_.getWidth(), rect_.getHeight(),
+                 SWP_NOZORDER | SWP_NOMOVE | SWP_NOACTIVATE);
+#endif
+  return kResultOk;
+}
+
+tresult PLUGIN_API Editor::setContentScaleFactor(ScaleFactor factor)
+{
+  if (!(factor > 0.0f))
+    return kInvalidArgument;
+
+  ViewRect scaled(0, 0,
+                  (int32)std::lround(UI::kDesignWidth * factor),
+                  (int32)std::lround(UI::kDesignHeight * factor));
+  if (scaled.getWidth() == rect_.getWidth() && scaled.getHeight() == rect_.getHeight())
+    return kResultOk;
+
+  // The host answers resizeView with onSize; before attach just remember it.
+  if (plugFrame)
+    return plugFrame->resizeView(this, &scaled);
+
+  rect_ = scaled;
   return kResultOk;
 }
 
@@ -2,11 +2,14 @@
 
 #include "public.sdk/source/vst/vsteditcontroller.h"   // Steinberg::Vst::EditorView, EditController
 #include "pluginterfaces/gui/iplugview.h"              // IPlugView
+#include "pluginterfaces/gui/iplugviewcontentscalesupport.h"
 #include "pluginterfaces/base/fstrdefs.h"              // FIDString
 
 namespace SvenderBass {
 
-class Editor final : public Steinberg::Vst::EditorView {
+struct EditorWin32State;
+
+class Editor final : public Steinberg::Vst::EditorView, public Steinberg::IPlugViewContentScaleSupport {
 public:
   explicit Editor(Steinberg::Vst::EditController* controller);
   ~Editor() = default;
@@ -16,9 +19,24 @@ public:
   Steinberg::tresult PLUGIN_API onSize(Steinberg::ViewRect* newSize) override;
   Steinberg::tresult PLUGIN_API getSize(Steinberg::ViewRect* size) override;
 
+  // Host DPI factor: the view asks to be resized to the scaled design size,
+  // and the faceplate is prescaled to match from the 1x or 2x asset.
+  Steinberg::tresult PLUGIN_API setContentScaleFactor(ScaleFactor factor) override;
+
+  // Forwarded by the Controller for every parameter change, whatever its
+  // source. The view redraws (and animates) only in response to these.
+  void paramChanged(Steinberg::Vst::ParamID paramId, Steinberg::Vst::ParamValue value);
+
+  OBJ_METHODS(Editor, Steinberg::Vst::EditorView)
+  DEFINE_INTERFACES
+    DEF_INTERFACE(Steinberg::IPlugViewContentScaleSupport)
+  END_DEFINE_INTERFACES(Steinberg::Vst::EditorView)
+  REFCOUNT_METHODS(Steinberg::Vst::EditorView)
+
 private:
   Steinberg::ViewRect rect_ {0, 0, 1200, 450};
   Steinberg::Vst::EditController* controller_ = nullptr;
+  EditorWin32State* win32_ = nullptr; // owned by the window; null when not attached
 };
 
 } // namespace SvenderBass
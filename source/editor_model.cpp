@@ -0,0 +1,224 @@
+#include "editor_model.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace SvenderBass::UI {
+
+const int kKnobParams[kKnobCount] = {
+  SVENDER_PARAM_INPUT_GAIN,
+  SVENDER_PARAM_BASS,
+  SVENDER_PARAM_MID,
+  SVENDER_PARAM_TREBLE,
+  SVENDER_PARAM_DRIVE,
+  SVENDER_PARAM_OUTPUT
+};
+
+const int kToggleParams[kToggleCount] = {
+  SVENDER_PARAM_ULTRA_LOW,
+  SVENDER_PARAM_ULTRA_HIGH
+};
+
+namespace {
+
+enum Knob { kInput, kBass, kMid, kTreble, kDrive, kOutput };
+
+// Hit areas on the 1200x450 faceplate. Knobs are 170px squares; the toggles
+// come from faceplate@2x centers (784, 680) and (1340, 680), ~40px wide at 2x.
+constexpr Rect kKnobDesignRects[kKnobCount] = {
+  {  87, 140,  257, 310 }, // Input
+  { 286, 140,  456, 310 }, // Bass
+  { 418, 140,  588, 310 }, // Mid
+  { 566, 140,  736, 310 }, // Treble
+  { 698, 140,  868, 310 }, // Drive
+  { 914, 140, 1084, 310 }, // Output
+};
+
+constexpr Rect kToggleDesignRects[kToggleCount] = {
+  { 382, 330, 402, 350 }, // Ultra Low
+  { 660, 330, 680, 350 }, // Ultra High
+};
+
+// Indicator pivot: offset (design px) from the center of the reference knob's
+// hit rect. Bass and Mid are measured from the Input knob.
+struct Pivot { int refKnob; float dx, dy; };
+constexpr Pivot kPivots[kKnobCount] = {
+  { kInput,  19.0f, 46.0f },
+  { kInput, 214.0f, 46.0f },
+  { kInput, 349.0f, 46.0f },
+  { kTreble, 19.0f, 46.0f },
+  { kDrive,  24.0f, 46.0f },
+  { kOutput, 21.0f, 46.0f },
+};
+
+constexpr float kTextOffsetX = 20.0f; // 40 right + 10 left + 20 left + 10 right
+constexpr float kTextOffsetY = 46.0f; // 40 down + 4 down + 4 down - 2 up
+constexpr float kDriveTextOffsetX = 5.0f;
+
+// 250-degree sweep, 0 at top center.
+constexpr float kStartDeg = -130.0f;
+constexpr float kEndDeg = 120.0f;
+
+float clamp01(float v) { return v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v); }
+
+Rect scaleRect(const Rect& r, float sx, float sy) {
+  return Rect{ (int)(r.left * sx + 0.5f), (int)(r.top * sy + 0.5f),
+               (int)(r.right * sx + 0.5f), (int)(r.bottom * sy + 0.5f) };
+}
+
+Rect offsetRect(const Rect& r, float dx, float dy) {
+  return Rect{ (int)(r.left + dx), (int)(r.top + dy), (int)(r.right + dx), (int)(r.bottom + dy) };
+}
+
+Rect displayRect(const Rect& knob) {
+  const int cx = (knob.left + knob.right) / 2;
+  const int cy = (knob.top + knob.bottom) / 2;
+  const int w = (int)((knob.right - knob.left) * 0.60f);
+  const int h = (int)((knob.bottom - knob.top) * 0.18f);
+  Rect r;
+  r.left = cx - w / 2;
+  r.right = r.left + w;
+  r.top = cy - h / 2;
+  r.bottom = r.top + h;
+  return r;
+}
+
+} // namespace
+
+Rect unite(const Rect& a, const Rect& b) {
+  if (a.empty()) return b;
+  if (b.empty()) return a;
+  return Rect{ std::min(a.left, b.left), std::min(a.top, b.top),
+               std::max(a.right, b.right), std::max(a.bottom, b.bottom) };
+}
+
+int knobIndexFromParam(int paramId) {
+  for (int i = 0; i < kKnobCount; ++i)
+    if (kKnobParams[i] == paramId) return i;
+  return -1;
+}
+
+int toggleIndexFromParam(int paramId) {
+  for (int i = 0; i < kToggleCount; ++i)
+    if (kToggleParams[i] == paramId) return i;
+  return -1;
+}
+
+void Layout::setClientSize(int width, int height) {
+  sx_ = (float)width / (float)kDesignWidth;
+  sy_ = (float)height / (float)kDesignHeight;
+}
+
+Rect Layout::knobRect(int knob) const {
+  return scaleRect(kKnobDesignRects[knob], sx_, sy_);
+}
+
+Rect Layout::textRect(int knob) const {
+  Rect rc = offsetRect(displayRect(knobRect(knob)), kTextOffsetX, kTextOffsetY);
+  if (knob == kDrive)
+    rc = offsetRect(rc, kDriveTextOffsetX, 0.0f);
+  return rc;
+}
+
+Rect Layout::toggleRect(int toggle) const {
+  return scaleRect(kToggleDesignRects[toggle], sx_, sy_);
+}
+
+IndicatorLine Layout::indicator(int knob, float normalized) const {
+  const Pivot& p = kPivots[knob];
+  const Rect ref = knobRect(p.refKnob);
+  const float cx = (float)(ref.left + ref.right) * 0.5f + p.dx * sx_;
+  const float cy = (float)(ref.top + ref.bottom) * 0.5f + p.dy * sy_;
+
+  const Rect own = knobRect(knob);
+  const float minDim = (float)std::min(own.right - own.left, own.bottom - own.top);
+  const float length = minDim * 0.20f - 6.0f * sx_;
+  const float start = length * 0.5f;
+
+  const float deg = kStartDeg + (kEndDeg - kStartDeg) * clamp01(normalized) - 90.0f;
+  const float angle = deg * (3.14159265358979323846f / 180.0f);
+  const float c = std::cos(angle);
+  const float s = std::sin(angle);
+  return IndicatorLine{ cx + start * c, cy + start * s, cx + length * c, cy + length * s };
+}
+
+float Layout::indicatorPenWidth() const {
+  const Rect text = displayRect(knobRect(kInput));
+  return (float)(text.bottom - text.top) * 0.10f;
+}
+
+Rect Layout::indicatorBounds(int knob, float normalized) const {
+  const IndicatorLine l = indicator(knob, normalized);
+  // Half the pen plus a pixel of anti-aliasing on each side.
+  const float pad = indicatorPenWidth() * 0.5f + 1.0f;
+  return Rect{ (int)std::floor(std::min(l.x1, l.x2) - pad), (int)std::floor(std::min(l.y1, l.y2) - pad),
+               (int)std::ceil(std::max(l.x1, l.x2) + pad) + 1, (int)std::ceil(std::max(l.y1, l.y2) + pad) + 1 };
+}
+
+int Layout::knobAt(int x, int y) const {
+  for (int i = 0; i < kKnobCount; ++i)
+    if (knobRect(i).contains(x, y) || textRect(i).contains(x, y))
+      return i;
+  return -1;
+}
+
+int Layout::toggleAt(int x, int y) const {
+  for (int i = 0; i < kToggleCount; ++i)
+    if (toggleRect(i).contains(x, y))
+      return i;
+  return -1;
+}
+
+void DirtyRegion::add(const Rect& r) {
+  if (r.empty())
+    return;
+  // Absorb everything the new rectangle overlaps; the union can reach
+  // further rectangles, so repeat until none is left.
+  Rect merged = r;
+  for (int i = 0; i < count;) {
+    if (rects[i].intersects(merged)) {
+      merged = unite(merged, rects[i]);
+      rects[i] = rects[--count];
+      i = 0;
+    } else {
+      ++i;
+    }
+  }
+  if (count < kMaxRects)
+    rects[count++] = merged;
+  else
+    rects[count - 1] = unite(rects[count - 1], merged);
+}
+
+void KnobAnimator::reset(int knob, float normalized) {
+  values_[knob] = targets_[knob] = clamp01(normalized);
+  activeMask_ &= ~(1u << knob);
+}
+
+bool KnobAnimator::setTarget(int knob, float normalized) {
+  targets_[knob] = clamp01(normalized);
+  if (values_[knob] != targets_[knob])
+    activeMask_ |= 1u << knob;
+  return (activeMask_ & (1u << knob)) != 0;
+}
+
+bool KnobAnimator::tick(const Layout& layout, DirtyRegion& dirty) {
+  for (int i = 0; i < kKnobCount; ++i) {
+    if (!(activeMask_ & (1u << i)))
+      continue;
+
+    const float cur = values_[i];
+    const float target = targets_[i];
+    const float next = cur + (target - cur) * kFollow;
+    values_[i] = (std::fabs(target - next) < kSnap) ? target : next;
+
+    // Old and new indicator positions both need repainting.
+    dirty.add(unite(layout.indicatorBounds(i, cur), layout.indicatorBounds(i, values_[i])));
+
+    if (values_[i] == target)
+      activeMask_ &= ~(1u << i);
+  }
+  return animating();
+}
+
+} // namespace SvenderBass::UI
@@ -0,0 +1,107 @@
+#pragma once
+#include "svender_dsp.h"
+
+// Platform-neutral editor state: faceplate layout, knob indicator animation
+// and dirty-region tracking. No window system or SDK dependency, so the
+// Win32 view (editor.cpp) is only a thin shell around it and the logic can
+// be exercised headless.
+
+namespace SvenderBass::UI {
+
+// Faceplate design size; everything is laid out in these coordinates and
+// scaled to the client area.
+constexpr int kDesignWidth = 1200;
+constexpr int kDesignHeight = 450;
+
+struct Rect {
+  int left = 0, top = 0, right = 0, bottom = 0;
+
+  bool empty() const { return right <= left || bottom <= top; }
+  bool contains(int x, int y) const { return x >= left && x < right && y >= top && y < bottom; }
+  bool intersects(const Rect& o) const {
+    return left < o.right && o.left < right && top < o.bottom && o.top < bottom;
+  }
+};
+
+Rect unite(const Rect& a, const Rect& b);
+
+constexpr int kKnobCount = 6;
+constexpr int kToggleCount = 2;
+
+extern const int kKnobParams[kKnobCount];     // svender_dsp_param ids
+extern const int kToggleParams[kToggleCount];
+
+int knobIndexFromParam(int paramId);   // -1 if not a knob
+int toggleIndexFromParam(int paramId); // -1 if not a toggle
+
+struct IndicatorLine {
+  float x1, y1, x2, y2;
+};
+
+// Scaled geometry for one client size.
+class Layout {
+public:
+  void setClientSize(int width, int height);
+  float scaleX() const { return sx_; }
+  float scaleY() const { return sy_; }
+
+  Rect knobRect(int knob) const;
+  Rect textRect(int knob) const; // value readout under the knob, also a hit area
+  Rect toggleRect(int toggle) const;
+
+  IndicatorLine indicator(int knob, float normalized) const;
+  float indicatorPenWidth() const;
+  // Pixels touched by the indicator at this value, pen width and
+  // anti-aliasing included.
+  Rect indicatorBounds(int knob, float normalized) const;
+
+  int knobAt(int x, int y) const;   // -1 if none
+  int toggleAt(int x, int y) const; // -1 if none
+
+private:
+  float sx_ = 1.0f;
+  float sy_ = 1.0f;
+};
+
+// Small set of rectangles to invalidate. Overlapping additions are merged so
+// a knob sweeping across consecutive frames stays one rectangle.
+struct DirtyRegion {
+  static constexpr int kMaxRects = kKnobCount + kToggleCount;
+
+  Rect rects[kMaxRects];
+  int count = 0;
+
+  void add(const Rect& r);
+  void clear() { count = 0; }
+};
+
+// Eases each knob indicator toward its parameter value. Driven by parameter
+// change notifications rather than polling: setTarget() reports whether a
+// frame timer is needed and tick() reports when it can stop, so an idle
+// editor does no work at all.
+class KnobAnimator {
+public:
+  static constexpr float kFollow = 0.25f;  // fraction of the remaining distance per frame
+  static constexpr float kSnap = 0.0005f;  // closer than this lands on the target
+
+  // Jumps to the value without animating (editor open).
+  void reset(int knob, float normalized);
+
+  // Returns true if the knob now has somewhere to go.
+  bool setTarget(int knob, float normalized);
+
+  // Advances one frame and adds the area swept by every moved indicator to
+  // dirty. Returns false once all knobs have settled.
+  bool tick(const Layout& layout, DirtyRegion& dirty);
+
+  bool animating() const { return activeMask_ != 0; }
+  float value(int knob) const { return values_[knob]; }
+  float target(int knob) const { return targets_[knob]; }
+
+private:
+  float values_[kKnobCount] {};
+  float targets_[kKnobCount] {};
+  unsigned activeMask_ = 0;
+};
+
+} // namespace SvenderBass::UI
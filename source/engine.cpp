@@ -0,0 +1,1126 @@
+#include "engine.h"
+#include "kernels.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define SVENDER_HAS_MXCSR 1
+#endif
+
+namespace SvenderBass {
+
+namespace {
+
+// Flushes denormal results and operands to zero (MXCSR FTZ | DAZ) for the
+// calling thread, restoring the host's mode on exit. Filter and envelope
+// state decaying through silence otherwise lands in the denormal range,
+// where every operation is many times slower. A no-op off x86.
+class DenormalGuard {
+public:
+#ifdef SVENDER_HAS_MXCSR
+  DenormalGuard() : saved_(_mm_getcsr()) { _mm_setcsr(saved_ | 0x8040u); }
+  ~DenormalGuard() { _mm_setcsr(saved_); }
+
+private:
+  unsigned saved_;
+#else
+  DenormalGuard() {}
+#endif
+  DenormalGuard(const DenormalGuard&) = delete;
+  DenormalGuard& operator=(const DenormalGuard&) = delete;
+};
+
+} // namespace
+
+// Pipeline stages. Stereo: front, saturator L, saturator R, back. Mono:
+// front, saturator, back. Each entry is the set of stages it reads from.
+static constexpr unsigned kStereoDeps[] = { 0, 1u << 0, 1u << 0, (1u << 1) | (1u << 2) };
+static constexpr unsigned kMonoDeps[] = { 0, 1u << 0, 1u << 1 };
+
+// Chunks per pipelined job, and their smallest size: more chunks fill and
+// drain the pipeline sooner, fewer mean less handing over between threads.
+constexpr int kPipelineChunks = 8;
+constexpr int kMinChunk = 4 * DSP::kControlInterval;
+
+// One pipeline stage's position on the control grid and its own scratch.
+struct Engine::Lane {
+  State::Scratch scratch;
+  int countdown = 0; // samples to the next control tick
+  int meterCountdown = 1;
+  int tick = 0;      // ticks and meter periods reached in this job
+  int period = 0;
+  MeterAccum acc {};
+
+  // Hands this stage's share of the meter period that just ended to `to`.
+  void closeFrontMeters(MeterAccum& to) {
+    to.inPeak = acc.inPeak;
+    to.inSq = acc.inSq;
+    to.sag = acc.sag;
+    to.driveSum = acc.driveSum;
+    acc.inPeak = acc.inSq = acc.sag = acc.driveSum = 0.0f;
+  }
+  void closeBackMeters(MeterAccum& to) {
+    to.satPeak = acc.satPeak;
+    to.satSq = acc.satSq;
+    to.outPeak = acc.outPeak;
+    to.outSq = acc.outSq;
+    to.frames = acc.frames;
+    acc.satPeak = acc.satSq = acc.outPeak = acc.outSq = 0.0f;
+    acc.frames = 0;
+  }
+};
+
+struct Engine::Pipeline {
+  Lane lanes[StagePipeline::kMaxStages];
+
+  // The bus for a whole job, the drive target the front set at each tick,
+  // and the meter periods the job closes. Sized by configure().
+  std::vector<float> l, r, drive, sagGain;
+  std::vector<float> tickDrive;
+  std::vector<MeterAccum> periods;
+  std::vector<int> edges;
+
+  const float* inL = nullptr;
+  const float* inR = nullptr;
+  float* outL = nullptr;
+  float* outR = nullptr;
+
+  StagePipeline stages; // last: joined before the buffers go
+
+  Bus bus() { return { l.data(), r.data(), drive.data(), sagGain.data() }; }
+
+  void resize(int maxBlockSize) {
+    for (auto* v : { &l, &r, &drive, &sagGain })
+      v->assign((size_t)maxBlockSize, 0.0f);
+    tickDrive.assign((size_t)maxBlockSize / DSP::kControlInterval + 2, 0.0f);
+    periods.assign(tickDrive.size(), MeterAccum {});
+    edges.assign((size_t)maxBlockSize / kMinChunk + 3, 0);
+  }
+};
+
+Engine::Engine() = default;
+Engine::~Engine() = default;
+
+// Halvings from the host rate down to 44.1/48 kHz, none without fixedRate.
+static int rateStages(double sampleRate, bool fixedRate) {
+  int stages = 0;
+  while (fixedRate && stages < DSP::RateConverter::kMaxStages && sampleRate / (1 << stages) >= 88200.0)
+    ++stages;
+  return stages;
+}
+
+int Engine::latencyFor(double sampleRate, bool fixedRate) {
+  return DSP::RateConverter::latencyFor(rateStages(sampleRate, fixedRate));
+}
+
+void Engine::configure(double sampleRate, int maxBlockSize) {
+  sampleRate_ = sampleRate;
+  maxBlockSize_ = maxBlockSize;
+
+  // Allocated here, on the thread that activates the engine, and kept
+  // across reconfigurations.
+  if (!state_)
+    state_ = std::make_unique<State>();
+  State& st = *state_;
+
+  // Halve the rate down to 44.1/48 kHz when asked; everything below is
+  // designed for the rate the chain runs at.
+  const int stages = rateStages(sampleRate, fixedRate_);
+  dspRate_ = sampleRate / (1 << stages);
+  if (stages > 0) {
+    if (!rate_)
+      rate_ = std::make_unique<DSP::RateConverter>();
+    rate_->configure(stages, maxBlockSize_);
+  } else {
+    rate_.reset();
+  }
+
+  st.inGainRamp.setTimeMs((float)dspRate_, 15.0f);
+  st.outGainRamp.setTimeMs((float)dspRate_, 15.0f);
+  st.driveRamp.setTimeMs((float)dspRate_, 25.0f);
+
+  // EQ gains glide on the control grid.
+  const float controlRate = (float)dspRate_ / DSP::kControlInterval;
+  for (auto* r : { &st.bassDbRamp, &st.midDbRamp, &st.trebleDbRamp })
+    r->setTimeMs(controlRate, 20.0f);
+
+  st.envL.setTimeMs((float)dspRate_, 30.0f);
+  st.envR.setTimeMs((float)dspRate_, 30.0f);
+  st.sagEnv.setTimesMs((float)dspRate_, 15.0f, 220.0f);
+
+  st.satL.setSampleRate((float)dspRate_);
+  st.satR.setSampleRate((float)dspRate_);
+  st.satL.setMode(satMode_);
+  st.satR.setMode(satMode_);
+
+  st.postLowShape.setup((float)dspRate_, 40.0f, false);
+  st.postHighShape.setup((float)dspRate_, 4000.0f, true);
+
+  // The tone stack's tables are shared by every instance. The first
+  // configure in the process builds them, so the stack can be switched on
+  // in any block from here on.
+  DSP::ToneStack::prepare();
+
+  // ~50 meter frames per second, on the control grid.
+  meterIntervals_ = std::max(1, (int)std::lround(dspRate_ * 0.02 / DSP::kControlInterval));
+
+  if (pipeline_)
+    pipeline_->resize(maxBlockSize_);
+
+  analyzer_.configure(sampleRate_);
+  tuner_.configure(dspRate_);
+  tuner_.setActive(pTuner_);
+
+  resetToParams();
+}
+
+void Engine::resetToParams() {
+  State& st = *state_;
+  inLinTarget_  = DSP::dbToLin((pInputGain_ * 2.0f - 1.0f) * 24.0f);
+  outLinTarget_ = DSP::dbToLin((pOutput_    * 2.0f - 1.0f) * 24.0f);
+  st.inGainRamp.reset(1.0f);
+  st.outGainRamp.reset(1.0f);
+  st.driveRamp.reset(1.0f);
+
+  reset();
+  updateFilters(true);
+  filtersDirty_ = false; // everything was just designed
+  updateDynamics(true);
+}
+
+// Checkpoint layout: header, parameters, the State block as it is in
+// memory, then the rate converter if there is one. State holds no pointers
+// and is copied raw; its size doubles as a layout check, and the version
+// moves whenever it changes meaning without changing size.
+namespace {
+constexpr uint32_t kSnapshotMagic = 0x50434453; // "SDCP"
+constexpr uint32_t kSnapshotVersion = 1;
+
+struct SnapshotHeader {
+  uint32_t magic, version;
+  uint64_t size, stateSize;
+  double sampleRate, dspRate;
+  int32_t maxBlockSize, reserved;
+};
+
+// What setParam() does not rebuild from the normalized values.
+struct SnapshotParams {
+  double normalized[SVENDER_PARAM_COUNT];
+  float bassDbTarget, midDbTarget, trebleDbTarget;
+  uint8_t filtersDirty, chainStale;
+};
+} // namespace
+
+size_t Engine::snapshotSize() const {
+  return sizeof(SnapshotHeader) + sizeof(SnapshotParams) + sizeof(State) + (rate_ ? rate_->stateSize() : 0);
+}
+
+bool Engine::saveSnapshot(void* dst, size_t size) const {
+  static_assert(std::is_trivially_copyable_v<State>, "State is checkpointed as raw bytes");
+  if (!state_ || !dst || size < snapshotSize())
+    return false;
+  SnapshotHeader h {};
+  h.magic = kSnapshotMagic;
+  h.version = kSnapshotVersion;
+  h.size = snapshotSize();
+  h.stateSize = sizeof(State);
+  h.sampleRate = sampleRate_;
+  h.dspRate = dspRate_;
+  h.maxBlockSize = maxBlockSize_;
+
+  SnapshotParams p {};
+  std::copy(std::begin(normalized_), std::end(normalized_), p.normalized);
+  p.bassDbTarget = bassDbTarget_;
+  p.midDbTarget = midDbTarget_;
+  p.trebleDbTarget = trebleDbTarget_;
+  p.filtersDirty = filtersDirty_;
+  p.chainStale = chainStale_;
+
+  auto* out = (unsigned char*)dst;
+  std::memcpy(out, &h, sizeof(h));
+  std::memcpy(out += sizeof(h), &p, sizeof(p));
+  std::memcpy(out += sizeof(p), state_.get(), sizeof(State));
+  if (rate_)
+    rate_->saveState(out + sizeof(State));
+  return true;
+}
+
+bool Engine::restoreSnapshot(const void* src, size_t size) {
+  if (!state_ || !src || size < sizeof(SnapshotHeader))
+    return false;
+  SnapshotHeader h;
+  std::memcpy(&h, src, sizeof(h));
+  if (h.magic != kSnapshotMagic || h.version != kSnapshotVersion || h.size != snapshotSize() || size < h.size ||
+      h.stateSize != sizeof(State) || h.sampleRate != sampleRate_ || h.dspRate != dspRate_ ||
+      h.maxBlockSize != maxBlockSize_)
+    return false;
+
+  const auto* in = (const unsigned char*)src + sizeof(h);
+  SnapshotParams p;
+  std::memcpy(&p, in, sizeof(p));
+  for (int id = 0; id < SVENDER_PARAM_COUNT; ++id)
+    setParam(id, p.normalized[id]);
+  bassDbTarget_ = p.bassDbTarget;
+  midDbTarget_ = p.midDbTarget;
+  trebleDbTarget_ = p.trebleDbTarget;
+  filtersDirty_ = p.filtersDirty != 0;
+  chainStale_ = p.chainStale != 0;
+
+  std::memcpy(state_.get(), in += sizeof(p), sizeof(State));
+  if (rate_)
+    rate_->restoreState(in + sizeof(State));
+  return true;
+}
+
+void Engine::reset() {
+  if (!state_)
+    return;
+  resetChain();
+  if (rate_)
+    rate_->reset();
+}
+
+void Engine::resetChain() {
+  State& st = *state_;
+  for (int i = 0; i < kNumPre; ++i)  { st.preL[i].reset();  st.preR[i].reset(); }
+  st.prePar.reset();
+  for (int i = 0; i < kNumPost; ++i) { st.postL[i].reset(); st.postR[i].reset(); }
+  st.xoverApL.reset(); st.xoverApR.reset();
+  for (int i = 0; i < kXoverStages; ++i) {
+    st.xoverHighL[i].reset(); st.xoverHighR[i].reset();
+  }
+  st.envL.reset(); st.envR.reset();
+  st.lastEnv = 0.0f;
+  st.envAccum = 0.0f;
+  st.ctrlCountdown = 0;
+  st.sagEnv.reset();
+  st.satL.reset();
+  st.satR.reset();
+  st.meterAcc = MeterAccum {};
+  st.meterCountdown = meterIntervals_;
+}
+
+void Engine::setParam(int id, double normalized) {
+  if (id < 0 || id >= SVENDER_PARAM_COUNT)
+    return;
+  normalized_[id] = DSP::clamp((float)normalized, 0.0f, 1.0f);
+  const float v = (float)normalized_[id];
+
+  switch (id) {
+    case SVENDER_PARAM_INPUT_GAIN: pInputGain_ = v; inLinTarget_ = DSP::dbToLin((v * 2.0f - 1.0f) * 24.0f); break;
+    case SVENDER_PARAM_BASS:       pBass_      = v; filtersDirty_ = true; break;
+    case SVENDER_PARAM_MID:        pMid_       = v; filtersDirty_ = true; break;
+    case SVENDER_PARAM_TREBLE:     pTreble_    = v; filtersDirty_ = true; break;
+    case SVENDER_PARAM_MID_FREQ:   pMidFreq_   = (int)std::lround(v * 4.0f); filtersDirty_ = true; break;
+    case SVENDER_PARAM_DRIVE:      pDrive_     = v; break;
+    case SVENDER_PARAM_OUTPUT:     pOutput_    = v; outLinTarget_ = DSP::dbToLin((v * 2.0f - 1.0f) * 24.0f); break;
+    case SVENDER_PARAM_ULTRA_LOW:  pUltraLow_  = (v >= 0.5f); filtersDirty_ = true; break;
+    case SVENDER_PARAM_ULTRA_HIGH: pUltraHigh_ = (v >= 0.5f); filtersDirty_ = true; break;
+    case SVENDER_PARAM_SAT_MODE:
+      satMode_ = (DSP::SatMode)std::lround(v * 4.0f);
+      if (state_) {
+        state_->satL.setMode(satMode_);
+        state_->satR.setMode(satMode_);
+      }
+      break;
+    case SVENDER_PARAM_TUNER:
+      pTuner_ = (v >= 0.5f);
+      tuner_.setActive(pTuner_);
+      break;
+    case SVENDER_PARAM_TUNER_MUTE: pTunerMute_ = (v >= 0.5f); break;
+    case SVENDER_PARAM_CROSSOVER:  pCrossover_ = (int)std::lround(v * 4.0f); filtersDirty_ = true; break;
+    case SVENDER_PARAM_TONE_STACK: pToneStack_ = (v >= 0.5f); filtersDirty_ = true; break;
+    default: break;
+  }
+}
+
+double Engine::getParam(int id) const {
+  if (id < 0 || id >= SVENDER_PARAM_COUNT)
+    return 0.0;
+  return normalized_[id];
+}
+
+void Engine::setPipelined(bool enabled) {
+  if (enabled == pipelined())
+    return;
+  if (enabled) {
+    pipeline_ = std::make_unique<Pipeline>();
+    pipeline_->resize(maxBlockSize_);
+    pipeline_->stages.start();
+  } else {
+    pipeline_.reset();
+  }
+}
+
+static float crossoverFromSwitch(int pos) {
+  switch (pos) {
+    case 1: return 80.0f;
+    case 2: return 120.0f;
+    case 3: return 200.0f;
+    default:return 300.0f;
+  }
+}
+
+static float midFreqFromSwitch(int pos) {
+  switch (pos) {
+    case 0: return 220.0f;
+    case 1: return 450.0f;
+    case 2: return 800.0f;
+    case 3: return 1600.0f;
+    default:return 3000.0f;
+  }
+}
+
+// Stepped and fixed filters are designed here outright. The bass, mid and
+// treble gains only get new targets; their ramps move the coefficients on
+// the control grid (stepEqRamps), unless snapEq jumps straight there.
+void Engine::updateFilters(bool snapEq) {
+  State& st = *state_;
+  leaveParallelPre();
+  st.preParPending = true;
+  st.preLive = st.postLive = kAllStages; // pruned again on the next control tick
+
+  const float sr = (float)dspRate_;
+  auto mapDb = [](float norm, float maxAbsDb) { return (norm * 2.0f - 1.0f) * maxAbsDb; };
+  auto mapDbAsym = [](float norm, float maxPosDb, float maxNegDb) {
+    if (norm >= 0.5f)
+      return ((norm - 0.5f) / 0.5f) * maxPosDb;
+    return ((norm - 0.5f) / 0.5f) * maxNegDb;
+  };
+
+  if (pToneStack_) {
+    bassDbTarget_ = pBass_;
+    midDbTarget_ = pMid_;
+    trebleDbTarget_ = pTreble_;
+  } else {
+    bassDbTarget_ = mapDb(pBass_,   12.0f);
+    midDbTarget_  = mapDbAsym(pMid_,    10.0f, 20.0f);
+    trebleDbTarget_ = mapDbAsym(pTreble_, 15.0f, 20.0f);
+  }
+  // Switching between the EQ and the tone stack swaps what the ramps and
+  // the three sections mean; jump there rather than glide.
+  if (pToneStack_ != st.toneStackActive) {
+    snapEq = true;
+    for (int s : { kPreBass, kPreMid, kPreTreble }) {
+      st.preL[s].reset();
+      st.preR[s].reset();
+    }
+    st.toneStackActive = pToneStack_;
+  }
+  if (snapEq) {
+    st.bassDbRamp.reset(bassDbTarget_);
+    st.midDbRamp.reset(midDbTarget_);
+    st.trebleDbRamp.reset(trebleDbTarget_);
+  }
+
+  st.preBassShape.setup(sr, 40.0f, false, 0.707f);
+  st.preMidShape.setup(sr, midFreqFromSwitch(pMidFreq_), 0.9f);
+  st.preTrebleShape.setup(sr, 4000.0f, true, 0.707f);
+  if (pToneStack_) {
+    st.toneStack.setup(sr, pMidFreq_);
+    st.toneStack.design(st.preL[kPreBass], st.preL[kPreMid], st.bassDbRamp.y, st.midDbRamp.y, st.trebleDbRamp.y);
+    st.preL[kPreTreble].copyCoefficients(DSP::Biquad {});
+  } else {
+    st.preBassShape.design(st.preL[kPreBass], st.bassDbRamp.y, true);
+    st.preMidShape.design(st.preL[kPreMid], st.midDbRamp.y, true);
+    st.preTrebleShape.design(st.preL[kPreTreble], st.trebleDbRamp.y, true);
+  }
+
+  st.postL[kCabHp].setHP(sr, 55.0f, 0.707f);
+  st.postL[kCabLp].setLP(sr, 5200.0f, 0.707f);
+
+  st.postL[kCabRes].setPeaking(sr, 90.0f, 3.0f, 0.9f);
+  st.postL[kCabMid].setPeaking(sr, 750.0f, -2.5f, 1.1f);
+
+  const float ulDb = pUltraLow_  ? +2.0f : 0.0f;
+  const float ulCutDb = pUltraLow_ ? -10.0f : 0.0f;
+  const float uhDb = pUltraHigh_ ? +9.0f : 0.0f;
+
+  st.preL[kPreUltraLow].setLowShelf(sr, 40.0f, ulDb, 0.707f);
+  st.preL[kPreUltraLowCut].setPeaking(sr, 500.0f, ulCutDb, 0.9f);
+
+  st.preL[kPreUltraHigh].setHighShelf(sr, 8000.0f, uhDb, 0.707f);
+
+  const bool xover = pCrossover_ > 0;
+  if (xover) {
+    // LR4 = two cascaded Butterworth sections per band; low + high sums to
+    // an allpass, so with the drive stage idle the split is inaudible.
+    const float fc = crossoverFromSwitch(pCrossover_);
+    for (int i = 0; i < kXoverStages; ++i) {
+      st.xoverHighL[i].setHP(sr, fc, 0.70710678f);
+      st.xoverHighR[i].copyCoefficients(st.xoverHighL[i]);
+    }
+    st.xoverApL.setAllpass(sr, fc, 0.70710678f);
+    st.xoverApR.copyCoefficients(st.xoverApL);
+  }
+  if (xover != st.xoverActive) {
+    st.xoverApL.reset(); st.xoverApR.reset();
+    for (int i = 0; i < kXoverStages; ++i) {
+      st.xoverHighL[i].reset(); st.xoverHighR[i].reset();
+    }
+    st.xoverActive = xover;
+  }
+
+  // Both channels share coefficients; design once and copy.
+  for (int i = 0; i < kNumPre; ++i)
+    st.preR[i].copyCoefficients(st.preL[i]);
+  for (int i = kCabHp; i < kNumPost; ++i)
+    st.postR[i].copyCoefficients(st.postL[i]);
+}
+
+// One control tick of the EQ gain ramps; redesigns only the sections whose
+// gain actually moved.
+void Engine::stepEqRamps() {
+  State& st = *state_;
+  if (st.toneStackActive) {
+    // The knobs interact, so any move redesigns both sections.
+    const bool bass = st.bassDbRamp.step(bassDbTarget_);
+    const bool mid = st.midDbRamp.step(midDbTarget_);
+    const bool treble = st.trebleDbRamp.step(trebleDbTarget_);
+    if (bass || mid || treble) {
+      st.toneStack.design(st.preL[kPreBass], st.preL[kPreMid], st.bassDbRamp.y, st.midDbRamp.y, st.trebleDbRamp.y);
+      st.preR[kPreBass].copyCoefficients(st.preL[kPreBass]);
+      st.preR[kPreMid].copyCoefficients(st.preL[kPreMid]);
+    }
+    return;
+  }
+  // The final step is always designed so the sections land exactly on the
+  // target gain.
+  auto step = [](DSP::Ramp& r, float target, auto& shape, DSP::Biquad& l, DSP::Biquad& rt) {
+    if (r.step(target) && shape.design(l, r.y, r.settled))
+      rt.copyCoefficients(l);
+  };
+  step(st.bassDbRamp, bassDbTarget_, st.preBassShape, st.preL[kPreBass], st.preR[kPreBass]);
+  step(st.midDbRamp, midDbTarget_, st.preMidShape, st.preL[kPreMid], st.preR[kPreMid]);
+  step(st.trebleDbRamp, trebleDbTarget_, st.preTrebleShape, st.preL[kPreTreble], st.preR[kPreTreble]);
+}
+
+// Switches the pre chain to the parallel form once nothing is moving it.
+// Settings the expansion refuses, and those with fewer than two live stages
+// (the cascade then costs one biquad or nothing, as at the flat defaults),
+// stay on the cascade until the next change.
+void Engine::enterParallelPre() {
+  State& st = *state_;
+  if (!st.preParPending || !st.bassDbRamp.settled || !st.midDbRamp.settled || !st.trebleDbRamp.settled)
+    return;
+  // The expansion drops identity stages; wait for their tails to ring out.
+  for (int s = 0; s < kNumPre; ++s)
+    if (st.preL[s].isIdentity() && (st.preLive & (1u << s)))
+      return;
+  st.preParPending = false;
+  if ((st.preLive & (st.preLive - 1)) == 0)
+    return;
+  if (st.prePar.design(st.preL, kNumPre)) {
+    st.prePar.importState(st.preL, kNumPre, 0);
+    st.prePar.importState(st.preR, kNumPre, 1);
+  }
+}
+
+// A stage drops out of its cascade once it is an identity and its state has
+// rung out. One that has just turned identity keeps running until its tail
+// is below kRestLevel and is then flushed, so switching a stage off never
+// cuts a tail short.
+static unsigned liveStages(DSP::Biquad* l, DSP::Biquad* r, int num) {
+  constexpr float kRestLevel = 1.0e-6f; // ~-120 dB
+  auto atRest = [](const DSP::Biquad& bq) { return std::fabs(bq.z1) + std::fabs(bq.z2) < kRestLevel; };
+  unsigned mask = 0;
+  for (int s = 0; s < num; ++s) {
+    if (!l[s].isIdentity() || !atRest(l[s]) || !atRest(r[s])) {
+      mask |= 1u << s;
+    } else {
+      l[s].reset();
+      r[s].reset();
+    }
+  }
+  return mask;
+}
+
+void Engine::updatePreLive() {
+  State& st = *state_;
+  if (!st.prePar.active)
+    st.preLive = liveStages(st.preL, st.preR, kNumPre);
+}
+
+void Engine::updatePostLive() {
+  State& st = *state_;
+  st.postLive = liveStages(st.postL, st.postR, kNumPost);
+}
+
+void Engine::leaveParallelPre() {
+  State& st = *state_;
+  if (!st.prePar.active)
+    return;
+  st.prePar.exportState(st.preL, kNumPre, 0);
+  st.prePar.exportState(st.preR, kNumPre, 1);
+  st.prePar.active = false;
+}
+
+float Engine::driveTargetFor(float env) const {
+  float driveTarget = 1.0f + pDrive_ * 19.0f;
+
+  float envForDrive = DSP::clamp(env * 3.0f, 0.0f, 1.0f);
+  float dynamicDrive = 1.0f + 8.0f * envForDrive;
+  return driveTarget * dynamicDrive;
+}
+
+void Engine::designPostDynamics(float driveTarget, bool force) {
+  State& st = *state_;
+  float driveNorm = DSP::clamp((driveTarget - 1.0f) / 12.0f, 0.0f, 1.0f);
+  float lowTightenDb = -3.0f * driveNorm;
+  float highSoftenDb = -4.0f * driveNorm;
+
+  if (st.postLowShape.design(st.postL[kPostLow], lowTightenDb, force))
+    st.postR[kPostLow].copyCoefficients(st.postL[kPostLow]);
+  if (st.postHighShape.design(st.postL[kPostHigh], highSoftenDb, force))
+    st.postR[kPostHigh].copyCoefficients(st.postL[kPostHigh]);
+}
+
+void Engine::updateDynamics(bool force) {
+  State& st = *state_;
+  st.driveEffectiveTarget = driveTargetFor(st.lastEnv);
+  designPostDynamics(st.driveEffectiveTarget, force);
+}
+
+// The control tick's work for the front of the chain: drive target from the
+// last interval's envelope, EQ ramps, pre chain form. Ticks run once per
+// control interval on a sample grid that is independent of the host block
+// size, so the envelope-to-drive response is identical at any buffer setting.
+void Engine::tickFront() {
+  State& st = *state_;
+  st.driveEffectiveTarget = driveTargetFor(st.lastEnv);
+  stepEqRamps();
+  updatePreLive();
+  enterParallelPre();
+}
+
+// ... and for the back: post filters following the same drive target.
+void Engine::tickBack(float driveTarget) {
+  designPostDynamics(driveTarget, false);
+  updatePostLive();
+}
+
+void Engine::process(const float* inL, const float* inR, float* outL, float* outR, int numSamples) {
+  DenormalGuard ftz;
+  run(inL, inR, outL, outR, numSamples);
+}
+
+void Engine::processMono(const float* in, float* out, int numSamples) {
+  DenormalGuard ftz;
+  run(in, in, out, nullptr, numSamples);
+}
+
+// outR == nullptr selects the mono chain, which reads inL only.
+void Engine::run(const float* inL, const float* inR, float* outL, float* outR, int numSamples) {
+  if (numSamples <= 0 || !state_)
+    return;
+
+  const bool stereo = outR != nullptr;
+
+  // Before processing: input and output may alias.
+  analyzer_.captureInput(inL, inR, numSamples);
+  runResampled(inL, inR, outL, outR, numSamples);
+  analyzer_.captureOutput(outL, stereo ? outR : outL, numSamples);
+}
+
+// The chain at the host rate: through the rate converter when there is one.
+void Engine::runResampled(const float* inL, const float* inR, float* outL, float* outR, int numSamples) {
+  const bool stereo = outR != nullptr;
+  if (rate_) {
+    // Each slice is read in full before its output is written.
+    float* l = rate_->internal(0);
+    float* r = stereo ? rate_->internal(1) : l;
+    for (int n = 0; n < numSamples;) {
+      const int len = std::min(numSamples - n, maxBlockSize_);
+      const int m = rate_->down(0, inL + n, len);
+      if (stereo)
+        rate_->down(1, inR + n, len);
+      runChain(l, r, l, stereo ? r : nullptr, m);
+      rate_->up(0, m, outL + n, len);
+      if (stereo)
+        rate_->up(1, m, outR + n, len);
+      n += len;
+    }
+  } else {
+    runChain(inL, inR, outL, outR, numSamples);
+  }
+}
+
+void Engine::warmUp() {
+  if (!state_)
+    return;
+  std::vector<unsigned char> saved(snapshotSize());
+  saveSnapshot(saved.data(), saved.size());
+
+  // A bass-like tone through the whole chain, stereo and then mono, at the
+  // largest block the host may send. The tone chain runs even in tuner mode,
+  // ready for when the tuner goes off; the analyzer and the tuner see
+  // nothing, and no meter frame is due before the state goes back.
+  const bool tuner = pTuner_;
+  pTuner_ = false;
+  const int n = std::max(maxBlockSize_, DSP::kControlInterval);
+  std::vector<float> l((size_t)n), r((size_t)n);
+  for (int i = 0; i < n; ++i) {
+    const float phase = 2.0f * DSP::kPi * 55.0f * (float)i / (float)sampleRate_;
+    l[(size_t)i] = 0.5f * std::sin(phase);
+    r[(size_t)i] = 0.5f * std::sin(1.5f * phase);
+  }
+  for (int stereo = 1; stereo >= 0; --stereo) {
+    state_->meterCountdown = std::numeric_limits<int>::max();
+    runResampled(l.data(), r.data(), l.data(), stereo ? r.data() : nullptr, n);
+  }
+  pTuner_ = tuner;
+
+  restoreSnapshot(saved.data(), saved.size());
+}
+
+void Engine::runChain(const float* inL, const float* inR, float* outL, float* outR, int numSamples) {
+  const bool stereo = outR != nullptr;
+  if (pTuner_) {
+    processTuner(inL, inR, outL, outR, numSamples);
+    return;
+  }
+  if (chainStale_) {
+    resetChain();
+    chainStale_ = false;
+  }
+
+  // Filter redesigns land on the control grid and may switch the crossover
+  // on or off; the chain returns there and the rest runs in the new variant.
+  // The pipelined chain takes up to maxBlockSize_ samples per round.
+  const bool pipelined = pipeline_ && maxBlockSize_ >= kPipelineMinSamples;
+  for (int n = 0; n < numSamples;) {
+    const auto& chains = (pipelined && numSamples - n >= kPipelineMinSamples) ? kPipelineChains : kChains;
+    const ChainFn chain = chains[stereo][state_->xoverActive][(int)satMode_];
+    n += (this->*chain)(inL + n, inR + n, outL + n, stereo ? outR + n : nullptr, numSamples - n);
+  }
+}
+
+// Runs the cascade over the stages whose bit is set in live, one kernel call
+// per contiguous run.
+static void cascadeLive(const DSP::KernelTable& k, DSP::Biquad* stages, int numStages, unsigned live,
+                        float* x, int n) {
+  int s = 0;
+  while (s < numStages) {
+    if (!(live & (1u << s))) { ++s; continue; }
+    const int first = s;
+    while (s < numStages && (live & (1u << s))) ++s;
+    k.biquadCascade(stages + first, s - first, x, n);
+  }
+}
+
+// The tone chain for one combination of channel count, crossover and
+// saturation mode. Everything that only depends on those is resolved at
+// compile time; identity filter stages are skipped through the live masks.
+//
+// The chain runs in passes of at most one control interval, aligned to the
+// control grid rather than to the host block, and all per-block work
+// (filter redesigns, dynamics, ramps) happens on grid ticks, so its cost
+// follows the audio and not the call count. Full passes go through a
+// variant with the length fixed at compile time; a host block that is a
+// multiple of the interval runs only those, other sizes add at most two
+// short passes per call. Nothing is buffered, so there is no latency.
+//
+// Returns the number of samples processed: all of them, unless a redesign
+// switched the crossover and the caller has to change variants.
+template <bool Stereo, bool Xover, DSP::SatMode Mode>
+int Engine::processChain(const float* inL, const float* inR, float* outL, float* outR, int numSamples) {
+  State& st = *state_;
+  if constexpr (!Stereo)
+    std::fill(st.scratch.bufR, st.scratch.bufR + DSP::kControlInterval, 0.0f);
+
+  int n = 0;
+  while (n < numSamples) {
+    if (st.ctrlCountdown == 0) {
+      if (filtersDirty_) {
+        updateFilters();
+        filtersDirty_ = false;
+        if (st.xoverActive != Xover)
+          return n;
+      }
+      tickFront();
+      tickBack(st.driveEffectiveTarget);
+      st.ctrlCountdown = DSP::kControlInterval;
+    }
+    const int len = std::min(numSamples - n, st.ctrlCountdown);
+    st.ctrlCountdown -= len;
+
+    float* const outRn = Stereo ? outR + n : nullptr;
+    if (len == DSP::kControlInterval)
+      processPass<Stereo, Xover, Mode, DSP::kControlInterval>(inL + n, inR + n, outL + n, outRn, len);
+    else
+      processPass<Stereo, Xover, Mode, 0>(inL + n, inR + n, outL + n, outRn, len);
+
+    n += len;
+    if (st.ctrlCountdown == 0) {
+      st.lastEnv = st.envAccum / (float)DSP::kControlInterval;
+      st.envAccum = 0.0f;
+
+      if (--st.meterCountdown == 0) {
+        publishMeters(st.meterAcc);
+        st.meterAcc = MeterAccum {};
+        st.meterCountdown = meterIntervals_;
+      }
+    }
+  }
+  return n;
+}
+
+// One pass of the chain over len <= kControlInterval samples; FixedLen > 0
+// pins len at compile time.
+template <bool Stereo, bool Xover, DSP::SatMode Mode, int FixedLen>
+void Engine::processPass(const float* inL, const float* inR, float* outL, float* outR, int numSamples) {
+  State& st = *state_;
+  State::Scratch& s = st.scratch;
+  const Bus bus { s.bufL, s.bufR, s.drive, s.sagGain };
+
+  frontPass<Stereo, FixedLen>(s.inGain, inL, inR, bus, numSamples, st.meterAcc);
+  saturatePass<Xover, Mode, FixedLen>(0, s.lowL, bus.l, bus.drive, numSamples);
+  if constexpr (Stereo) saturatePass<Xover, Mode, FixedLen>(1, s.lowR, bus.r, bus.drive, numSamples);
+  backPass<Stereo, FixedLen>(s.outGain, bus, outL, outR, numSamples, st.meterAcc);
+}
+
+// Metering counts a mono channel twice, as the stereo chain would see it.
+template <bool Stereo>
+static void meter(const DSP::KernelTable& k, const float* l, const float* r, int n, float* peak, float* sumSq) {
+  k.peakSumSquares(l, n, peak, sumSq);
+  k.peakSumSquares(Stereo ? r : l, n, peak, sumSq);
+}
+
+// Input gain, pre EQ and the detectors; leaves the EQ'd signal and the
+// per-sample drive and sag gain on the bus.
+template <bool Stereo, int FixedLen>
+void Engine::frontPass(float* inGain, const float* inL, const float* inR, const Bus& bus, int numSamples,
+                       MeterAccum& acc) {
+  State& st = *state_;
+  const int len = FixedLen > 0 ? FixedLen : numSamples;
+  const DSP::KernelTable& k = DSP::kernels();
+
+  float* bufL = bus.l;
+  float* bufR = bus.r;
+  float* drive = bus.drive;
+  float* sagGain = bus.sagGain;
+
+  // Settled ramps collapse to block-constant gains.
+  if (st.inGainRamp.run(inLinTarget_, inGain, len)) {
+    const float g = st.inGainRamp.y;
+    for (int i = 0; i < len; ++i) {
+      bufL[i] = inL[i] * g;
+      if constexpr (Stereo) bufR[i] = inR[i] * g;
+    }
+  } else {
+    for (int i = 0; i < len; ++i) {
+      bufL[i] = inL[i] * inGain[i];
+      if constexpr (Stereo) bufR[i] = inR[i] * inGain[i];
+    }
+  }
+  if (st.driveRamp.run(st.driveEffectiveTarget, drive, len))
+    std::fill(drive, drive + len, st.driveRamp.y);
+
+  meter<Stereo>(k, inL, inR, len, &acc.inPeak, &acc.inSq);
+
+  if (st.prePar.active) {
+    // In mono the right lanes run on silence in spare SIMD width.
+    k.parallelBiquads(st.prePar, bufL, bufR, len);
+  } else {
+    cascadeLive(k, st.preL, kNumPre, st.preLive, bufL, len);
+    if constexpr (Stereo) cascadeLive(k, st.preR, kNumPre, st.preLive, bufR, len);
+  }
+
+  for (int i = 0; i < len; ++i) {
+    const float xL = bufL[i];
+    float sagIn;
+    if constexpr (Stereo) {
+      const float xR = bufR[i];
+      float eL = st.envL.process(xL);
+      float eR = st.envR.process(xR);
+      st.envAccum += 0.5f * (eL + eR);
+      sagIn = 0.5f * (std::fabs(xL) + std::fabs(xR));
+    } else {
+      st.envAccum += st.envL.process(xL);
+      sagIn = std::fabs(xL);
+    }
+
+    float sag = st.sagEnv.process(sagIn);
+    float sagCtrl = DSP::clamp(sag * 2.5f, 0.0f, 1.0f);
+    drive[i] *= 1.0f - 0.35f * sagCtrl;
+    sagGain[i] = 1.0f - 0.20f * sagCtrl;
+
+    acc.sag = std::max(acc.sag, sagCtrl);
+    acc.driveSum += drive[i];
+  }
+}
+
+// One channel of the drive stage, inside the crossover when it is on.
+template <bool Xover, DSP::SatMode Mode, int FixedLen>
+void Engine::saturatePass(int ch, float* low, float* x, const float* drive, int numSamples) {
+  State& st = *state_;
+  const int len = FixedLen > 0 ? FixedLen : numSamples;
+  DSP::Saturator& sat = ch ? st.satR : st.satL;
+
+  if constexpr (Xover) {
+    const DSP::KernelTable& k = DSP::kernels();
+    std::copy(x, x + len, low);
+    k.biquadCascade(ch ? &st.xoverApR : &st.xoverApL, 1, low, len);
+    k.biquadCascade(ch ? st.xoverHighR : st.xoverHighL, kXoverStages, x, len);
+    for (int i = 0; i < len; ++i)
+      low[i] -= x[i];
+
+    DSP::saturateBlock<Mode>(sat, x, drive, len);
+
+    for (int i = 0; i < len; ++i)
+      x[i] += low[i];
+  } else {
+    DSP::saturateBlock<Mode>(sat, x, drive, len);
+  }
+}
+
+// Sag gain, post/cab filters and output gain.
+template <bool Stereo, int FixedLen>
+void Engine::backPass(float* outGain, const Bus& bus, float* outL, float* outR, int numSamples, MeterAccum& acc) {
+  State& st = *state_;
+  const int len = FixedLen > 0 ? FixedLen : numSamples;
+  const DSP::KernelTable& k = DSP::kernels();
+
+  float* bufL = bus.l;
+  float* bufR = bus.r;
+  const float* sagGain = bus.sagGain;
+
+  const bool outFlat = st.outGainRamp.run(outLinTarget_, outGain, len);
+
+  meter<Stereo>(k, bufL, bufR, len, &acc.satPeak, &acc.satSq);
+
+  for (int i = 0; i < len; ++i) {
+    bufL[i] *= sagGain[i];
+    if constexpr (Stereo) bufR[i] *= sagGain[i];
+  }
+
+  cascadeLive(k, st.postL, kNumPost, st.postLive, bufL, len);
+  if constexpr (Stereo) cascadeLive(k, st.postR, kNumPost, st.postLive, bufR, len);
+
+  if (outFlat) {
+    const float g = st.outGainRamp.y;
+    for (int i = 0; i < len; ++i) {
+      outL[i] = bufL[i] * g;
+      if constexpr (Stereo) outR[i] = bufR[i] * g;
+    }
+  } else {
+    for (int i = 0; i < len; ++i) {
+      outL[i] = bufL[i] * outGain[i];
+      if constexpr (Stereo) outR[i] = bufR[i] * outGain[i];
+    }
+  }
+
+  meter<Stereo>(k, outL, outR, len, &acc.outPeak, &acc.outSq);
+  acc.frames += len;
+}
+
+// The pipelined chain: the serial chain's passes, run by one lane per stage.
+// Each lane walks the same control grid and does its own share of every
+// tick; the front records the drive target it set there, and the back
+// designs its filters from it when it reaches the same tick. Chunk edges sit
+// on the grid, so the passes, and with them the output, match the serial
+// chain's exactly.
+template <bool Stereo, bool Xover, DSP::SatMode Mode>
+int Engine::pipelineChain(const float* inL, const float* inR, float* outL, float* outR, int numSamples) {
+  State& st = *state_;
+
+  // A pending redesign may switch variants: the serial chain takes the
+  // samples up to and through that tick.
+  if (filtersDirty_)
+    return processChain<Stereo, Xover, Mode>(inL, inR, outL, outR,
+                                             std::min(numSamples, st.ctrlCountdown + DSP::kControlInterval));
+
+  Pipeline& p = *pipeline_;
+  const int total = std::min(numSamples, maxBlockSize_);
+  const int chunk = std::max(kMinChunk, total / kPipelineChunks / DSP::kControlInterval * DSP::kControlInterval);
+  int numChunks = 0;
+  p.edges[0] = 0;
+  for (int e = st.ctrlCountdown + chunk; numChunks == 0 || p.edges[numChunks] < total; e += chunk)
+    p.edges[++numChunks] = std::min(e, total);
+
+  p.inL = inL;
+  p.inR = inR;
+  p.outL = outL;
+  p.outR = outR;
+  for (Lane& lane : p.lanes) {
+    lane.countdown = st.ctrlCountdown;
+    lane.meterCountdown = st.meterCountdown;
+    lane.tick = 0;
+    lane.period = 0;
+    lane.acc = st.meterAcc;
+  }
+
+  constexpr int kStages = Stereo ? 4 : 3;
+  p.stages.run(&Engine::pipelineStage<Stereo, Xover, Mode>, this, Stereo ? kStereoDeps : kMonoDeps, kStages,
+               p.edges.data(), numChunks);
+
+  Lane& front = p.lanes[0];
+  Lane& back = p.lanes[kStages - 1];
+  for (int i = 0; i < front.period; ++i)
+    publishMeters(p.periods[i]);
+  st.meterAcc = MeterAccum {};
+  front.closeFrontMeters(st.meterAcc);
+  back.closeBackMeters(st.meterAcc);
+  st.ctrlCountdown = front.countdown;
+  st.meterCountdown = front.meterCountdown;
+  return total;
+}
+
+template <bool Stereo, bool Xover, DSP::SatMode Mode>
+void Engine::pipelineStage(void* ctx, int stage, int begin, int end) {
+  Engine& e = *static_cast<Engine*>(ctx);
+  DenormalGuard ftz; // the pipeline's own threads run this too
+  Lane& lane = e.pipeline_->lanes[stage];
+  constexpr int kBack = Stereo ? 3 : 2;
+  if (stage == 0)
+    e.frontLane<Stereo>(lane, begin, end);
+  else if (stage == kBack)
+    e.backLane<Stereo>(lane, begin, end);
+  else
+    e.saturateLane<Xover, Mode>(lane, stage - 1, begin, end);
+}
+
+template <bool Stereo>
+void Engine::frontLane(Lane& lane, int begin, int end) {
+  State& st = *state_;
+  Pipeline& p = *pipeline_;
+  const Bus bus = p.bus();
+  if constexpr (!Stereo)
+    std::fill(bus.r + begin, bus.r + end, 0.0f);
+
+  for (int n = begin; n < end;) {
+    if (lane.countdown == 0) {
+      tickFront();
+      p.tickDrive[lane.tick++] = st.driveEffectiveTarget;
+      lane.countdown = DSP::kControlInterval;
+    }
+    const int len = std::min(end - n, lane.countdown);
+    lane.countdown -= len;
+
+    if (len == DSP::kControlInterval)
+      frontPass<Stereo, DSP::kControlInterval>(lane.scratch.inGain, p.inL + n, p.inR + n, bus.at(n), len, lane.acc);
+    else
+      frontPass<Stereo, 0>(lane.scratch.inGain, p.inL + n, p.inR + n, bus.at(n), len, lane.acc);
+
+    n += len;
+    if (lane.countdown == 0) {
+      st.lastEnv = st.envAccum / (float)DSP::kControlInterval;
+      st.envAccum = 0.0f;
+
+      if (--lane.meterCountdown == 0) {
+        lane.closeFrontMeters(p.periods[lane.period++]);
+        lane.meterCountdown = meterIntervals_;
+      }
+    }
+  }
+}
+
+template <bool Xover, DSP::SatMode Mode>
+void Engine::saturateLane(Lane& lane, int ch, int begin, int end) {
+  Pipeline& p = *pipeline_;
+  float* x = ch ? p.r.data() : p.l.data();
+  const float* drive = p.drive.data();
+
+  for (int n = begin; n < end;) {
+    if (lane.countdown == 0)
+      lane.countdown = DSP::kControlInterval;
+    const int len = std::min(end - n, lane.countdown);
+    lane.countdown -= len;
+
+    if (len == DSP::kControlInterval)
+      saturatePass<Xover, Mode, DSP::kControlInterval>(ch, lane.scratch.lowL, x + n, drive + n, len);
+    else
+      saturatePass<Xover, Mode, 0>(ch, lane.scratch.lowL, x + n, drive + n, len);
+    n += len;
+  }
+}
+
+template <bool Stereo>
+void Engine::backLane(Lane& lane, int begin, int end) {
+  Pipeline& p = *pipeline_;
+  const Bus bus = p.bus();
+
+  for (int n = begin; n < end;) {
+    if (lane.countdown == 0) {
+      tickBack(p.tickDrive[lane.tick++]);
+      lane.countdown = DSP::kControlInterval;
+    }
+    const int len = std::min(end - n, lane.countdown);
+    lane.countdown -= len;
+
+    float* const outRn = Stereo ? p.outR + n : nullptr;
+    if (len == DSP::kControlInterval)
+      backPass<Stereo, DSP::kControlInterval>(lane.scratch.outGain, bus.at(n), p.outL + n, outRn, len, lane.acc);
+    else
+      backPass<Stereo, 0>(lane.scratch.outGain, bus.at(n), p.outL + n, outRn, len, lane.acc);
+
+    n += len;
+    if (lane.countdown == 0 && --lane.meterCountdown == 0) {
+      lane.closeBackMeters(p.periods[lane.period++]);
+      lane.meterCountdown = meterIntervals_;
+    }
+  }
+}
+
+template <bool Pipelined, bool Stereo, bool Xover, std::size_t... M>
+constexpr std::array<Engine::ChainFn, sizeof...(M)> Engine::chainRow(std::index_sequence<M...>) {
+  if constexpr (Pipelined)
+    return { &Engine::pipelineChain<Stereo, Xover, (DSP::SatMode)M>... };
+  else
+    return { &Engine::processChain<Stereo, Xover, (DSP::SatMode)M>... };
+}
+
+using SatModes = std::make_index_sequence<(std::size_t)DSP::SatMode::Count>;
+
+const std::array<Engine::ChainFn, (std::size_t)DSP::SatMode::Count> Engine::kChains[2][2] = {
+  { chainRow<false, false, false>(SatModes()), chainRow<false, false, true>(SatModes()) },
+  { chainRow<false, true, false>(SatModes()),  chainRow<false, true, true>(SatModes()) },
+};
+
+const std::array<Engine::ChainFn, (std::size_t)DSP::SatMode::Count> Engine::kPipelineChains[2][2] = {
+  { chainRow<true, false, false>(SatModes()), chainRow<true, false, true>(SatModes()) },
+  { chainRow<true, true, false>(SatModes()),  chainRow<true, true, true>(SatModes()) },
+};
+
+// Tuner mode: the tone chain is skipped entirely; the input goes to the
+// decimating tuner tap and the output is either silence or the dry signal.
+void Engine::processTuner(const float* inL, const float* inR, float* outL, float* outR, int numSamples) {
+  tuner_.capture(inL, inR, numSamples);
+  chainStale_ = true;
+
+  if (pTunerMute_) {
+    std::fill(outL, outL + numSamples, 0.0f);
+    if (outR) std::fill(outR, outR + numSamples, 0.0f);
+  } else {
+    if (outL != inL) std::copy(inL, inL + numSamples, outL);
+    if (outR && outR != inR) std::copy(inR, inR + numSamples, outR);
+  }
+}
+
+void Engine::publishMeters(const MeterAccum& a) {
+  const float norm = a.frames > 0 ? 1.0f / (float)(2 * a.frames) : 0.0f;
+
+  svender_dsp_meters m;
+  m.input_peak = a.inPeak;
+  m.input_rms = std::sqrt(a.inSq * norm);
+  m.saturation_peak = a.satPeak;
+  m.saturation_rms = std::sqrt(a.satSq * norm);
+  m.output_peak = a.outPeak;
+  m.output_rms = std::sqrt(a.outSq * norm);
+  m.sag = a.sag;
+  m.drive = a.frames > 0 ? a.driveSum / (float)a.frames : 0.0f;
+  m.frames = (unsigned)a.frames;
+
+  meterRing_.push(m); // dropped if nobody is reading
+}
+
+} // namespace SvenderBass
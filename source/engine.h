@@ -0,0 +1,321 @@
+#pragma once
+#include "analyzer.h"
+#include "dsp.h"
+#include "parallel_biquads.h"
+#include "resampler.h"
+#include "spsc_ring.h"
+#include "stage_pipeline.h"
+#include "svender_dsp.h"
+#include "tone_stack.h"
+#include "tuner.h"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace SvenderBass {
+
+// The complete tone engine: input gain, EQ, dynamic drive and sag, the
+// saturation stage, post/cab filtering and output gain. Independent of the
+// VST3 SDK; the plugin Processor and the svender_dsp C API both wrap it, so
+// this is the only hot path.
+class Engine {
+public:
+  Engine();
+  ~Engine();
+
+  // Sets the sample rate, designs all filters and resets state. The block
+  // size bound is kept for wrappers that need scratch memory.
+  void configure(double sampleRate, int maxBlockSize);
+
+  // Clears filter, envelope and oversampler state.
+  void reset();
+
+  // Returns to the state configure() leaves, with the current parameters
+  // and without restarting the analyzer and tuner workers: output from here
+  // matches a freshly configured engine. For instance pools.
+  void resetToParams();
+
+  // Activation warm-up: runs the chain over a dummy signal, one host block
+  // in stereo and in mono, then restores the state exactly. The first real
+  // block then finds its state, scratch, resampler and pipeline buffers and
+  // code already faulted in and cached, and runs like any later one.
+  // Output, meters, analyzer and tuner are unaffected. Not real-time safe;
+  // the plugin calls it on every activation.
+  void warmUp();
+
+  // Checkpoints for long offline renders: the complete DSP state, with the
+  // parameters, as a versioned blob of snapshotSize() bytes. Restored into
+  // an engine of the same build and configuration (rate, block size bound,
+  // internal rate), processing continues bit-identically to a render that
+  // never stopped, so a render can resume or be split at checkpoints. The
+  // analyzer, the tuner's detector and unread meter frames are left out.
+  // Not real-time safe. Both return false before configure() or on a size,
+  // version or configuration mismatch.
+  size_t snapshotSize() const;
+  bool saveSnapshot(void* dst, size_t size) const;
+  bool restoreSnapshot(const void* src, size_t size);
+
+  // Normalized [0, 1] values, ids from svender_dsp_param. Filter redesign is
+  // deferred to the next control tick inside process(): the start of the
+  // call when host blocks are multiples of DSP::kControlInterval.
+  void setParam(int id, double normalized);
+  double getParam(int id) const;
+
+  // Stereo planar processing. Input and output buffers may alias. Denormals
+  // are flushed to zero for the call; the caller's FP mode is restored.
+  void process(const float* inL, const float* inR, float* outL, float* outR, int numSamples);
+
+  // Mono processing through a single-channel chain. Same output as process()
+  // with the same buffer on both inputs, at about half the cost.
+  void processMono(const float* in, float* out, int numSamples);
+
+  // Meter frames queued by process() every ~20 ms. Single consumer; may be
+  // called from another thread.
+  bool popMeters(svender_dsp_meters& out) { return meterRing_.pop(out); }
+
+  // Spectrum analyzer, off by default. setAnalyzerEnabled is not real-time
+  // safe; popSpectrum has the same rules as popMeters.
+  void setAnalyzerEnabled(bool enabled) { analyzer_.setEnabled(enabled); }
+  bool analyzerEnabled() const { return analyzer_.enabled(); }
+  bool popSpectrum(svender_dsp_spectrum& out) { return analyzer_.popSpectrum(out); }
+
+  // Tuner readings while SVENDER_PARAM_TUNER is on. Same rules as popMeters.
+  bool tunerActive() const { return pTuner_; }
+  bool popTuner(svender_dsp_tuner& out) { return tuner_.popResult(out); }
+
+  // Offline rendering: runs the chain as a pipeline of stages (EQ and
+  // detectors, one saturator per channel, post/cab) on their own threads
+  // within each long process() call. Output is bit-identical to the serial
+  // chain and there is no added latency; blocks shorter than
+  // kPipelineMinSamples stay serial. Not real-time safe: starts or joins the
+  // workers.
+  static constexpr int kPipelineMinSamples = 512;
+  void setPipelined(bool enabled);
+  bool pipelined() const { return pipeline_ != nullptr; }
+
+  // High host rates: runs the chain at 44.1 or 48 kHz instead, when the
+  // host rate is a power-of-two multiple of one of them (88.2 kHz and up),
+  // through halfband resamplers (DSP::RateConverter). Cost drops by about
+  // the ratio and the tone is that of the base rate. Applied by the next
+  // configure(); latencySamples() then reports the delay it adds.
+  void setFixedInternalRate(bool enabled) { fixedRate_ = enabled; }
+  bool fixedInternalRate() const { return fixedRate_; }
+  double internalRate() const { return dspRate_; }
+  int latencySamples() const { return rate_ ? rate_->latency() : 0; }
+  // latencySamples() after configure(sampleRate) with the given setting.
+  static int latencyFor(double sampleRate, bool fixedRate);
+
+  double sampleRate() const { return sampleRate_; }
+  int maxBlockSize() const { return maxBlockSize_; }
+
+private:
+  void run(const float* inL, const float* inR, float* outL, float* outR, int numSamples);
+  void runResampled(const float* inL, const float* inR, float* outL, float* outR, int numSamples);
+  void runChain(const float* inL, const float* inR, float* outL, float* outR, int numSamples);
+  void resetChain();
+
+  // One specialization of the tone chain per channel count, crossover state
+  // and saturation mode; run() picks one per block.
+  using ChainFn = int (Engine::*)(const float*, const float*, float*, float*, int);
+  template <bool Stereo, bool Xover, DSP::SatMode Mode>
+  int processChain(const float* inL, const float* inR, float* outL, float* outR, int numSamples);
+  template <bool Pipelined, bool Stereo, bool Xover, std::size_t... M>
+  static constexpr std::array<ChainFn, sizeof...(M)> chainRow(std::index_sequence<M...>);
+  static const std::array<ChainFn, (std::size_t)DSP::SatMode::Count> kChains[2][2];
+
+  template <bool Stereo, bool Xover, DSP::SatMode Mode, int FixedLen>
+  void processPass(const float* inL, const float* inR, float* outL, float* outR, int numSamples);
+
+  // The same chain with its stages pipelined across threads (setPipelined).
+  template <bool Stereo, bool Xover, DSP::SatMode Mode>
+  int pipelineChain(const float* inL, const float* inR, float* outL, float* outR, int numSamples);
+  template <bool Stereo, bool Xover, DSP::SatMode Mode>
+  static void pipelineStage(void* ctx, int stage, int begin, int end);
+  static const std::array<ChainFn, (std::size_t)DSP::SatMode::Count> kPipelineChains[2][2];
+
+  struct MeterAccum;
+  struct Pipeline;
+  struct Lane;
+
+  // The signal between stages: audio and the per-sample drive and sag gain
+  // the detectors derived from it.
+  struct Bus {
+    float* l;
+    float* r;
+    float* drive;
+    float* sagGain;
+    Bus at(int n) const { return { l + n, r + n, drive + n, sagGain + n }; }
+  };
+
+  // A pass split into the stages the pipeline runs on separate threads; the
+  // serial chain runs them back to back. Each one only touches its own part
+  // of State.
+  template <bool Stereo, int FixedLen>
+  void frontPass(float* inGain, const float* inL, const float* inR, const Bus& bus, int numSamples,
+                 MeterAccum& acc);
+  template <bool Xover, DSP::SatMode Mode, int FixedLen>
+  void saturatePass(int ch, float* low, float* x, const float* drive, int numSamples);
+  template <bool Stereo, int FixedLen>
+  void backPass(float* outGain, const Bus& bus, float* outL, float* outR, int numSamples, MeterAccum& acc);
+
+  // Control-tick work, split the same way.
+  void tickFront();
+  void tickBack(float driveTarget);
+
+  template <bool Stereo>
+  void frontLane(Lane& lane, int begin, int end);
+  template <bool Xover, DSP::SatMode Mode>
+  void saturateLane(Lane& lane, int ch, int begin, int end);
+  template <bool Stereo>
+  void backLane(Lane& lane, int begin, int end);
+
+  void updateFilters(bool snapEq = false);
+  void stepEqRamps();
+  void enterParallelPre();
+  void leaveParallelPre();
+  void updatePreLive();
+  void updatePostLive();
+  float driveTargetFor(float env) const;
+  void designPostDynamics(float driveTarget, bool force);
+  void updateDynamics(bool force);
+  void processTuner(const float* inL, const float* inR, float* outL, float* outR, int numSamples);
+  void publishMeters(const MeterAccum& a);
+
+  // Cold: configuration and parameters, touched by setParam() and at most
+  // once per control tick.
+  double sampleRate_ = 44100.0;
+  double dspRate_ = 44100.0; // the chain's rate: sampleRate_ unless resampled
+  int maxBlockSize_ = 0;
+  bool fixedRate_ = false;
+
+  double normalized_[SVENDER_PARAM_COUNT] = {
+    0.5, 0.5, 0.5, 0.5, 0.5, 0.3, 0.7, 0.0, 0.0, 0.0, 0.0, 1.0, 0.5, 0.0
+  };
+
+  float pInputGain_ = 0.5f;
+  float pBass_      = 0.5f;
+  float pMid_       = 0.5f;
+  float pTreble_    = 0.5f;
+  int   pMidFreq_   = 2;
+  float pDrive_     = 0.3f;
+  float pOutput_    = 0.7f;
+  bool pUltraLow_ = false;
+  bool pUltraHigh_ = false;
+  int  pCrossover_ = 0;
+  bool pToneStack_ = false;
+  bool pTuner_ = false;
+  bool pTunerMute_ = true;
+  DSP::SatMode satMode_ = DSP::SatMode::Oversample4x;
+  bool chainStale_ = false; // tone chain skipped while tuning; reset on return
+  bool filtersDirty_ = true; // redesign on the next control tick
+
+  // Ramp targets for the continuous parameters.
+  float inLinTarget_ = 1.0f;
+  float outLinTarget_ = 1.0f;
+  float bassDbTarget_ = 0.0f, midDbTarget_ = 0.0f, trebleDbTarget_ = 0.0f; // knob positions in tone-stack mode
+
+  int meterIntervals_ = 1;
+
+  // Serial filter chains, laid out as arrays so each runs as one
+  // DSP::kernels().biquadCascade call per block.
+  enum PreStage { kPreUltraLow, kPreUltraLowCut, kPreUltraHigh, kPreBass, kPreMid, kPreTreble, kNumPre };
+  enum PostStage { kPostLow, kPostHigh, kCabHp, kCabRes, kCabMid, kCabLp, kNumPost };
+  enum { kXoverStages = 2 };
+  static constexpr unsigned kAllStages = ~0u;
+
+  // Metering: accumulated over meterIntervals_ control intervals, then
+  // published to meterRing_.
+  struct MeterAccum {
+    float inPeak, inSq, satPeak, satSq, outPeak, outSq, sag, driveSum;
+    int frames;
+  };
+
+  // Hot: every piece of DSP state the audio path touches, and its scratch
+  // buffers, in one cache-line-aligned block allocated by configure(). It
+  // shares no line with the host's allocation of the Engine or with anyone
+  // else's. Roughly in the order a pass walks it: per-sample state first,
+  // then what only the control tick reads. The parts frontPass,
+  // saturatePass (per channel) and backPass own start on separate lines, so
+  // pipeline stages do not share any.
+  struct State {
+    // Per-pass working buffers, one control interval each.
+    struct Scratch {
+      alignas(64) float bufL[DSP::kControlInterval];
+      alignas(64) float bufR[DSP::kControlInterval];
+      alignas(64) float drive[DSP::kControlInterval];
+      alignas(64) float sagGain[DSP::kControlInterval];
+      alignas(64) float inGain[DSP::kControlInterval];
+      alignas(64) float outGain[DSP::kControlInterval];
+      alignas(64) float lowL[DSP::kControlInterval];
+      alignas(64) float lowR[DSP::kControlInterval];
+    } scratch;
+
+    // Continuous parameters glide through settled-aware ramps: per-sample
+    // gains and drive while moving, plain block constants once converged.
+    alignas(64) DSP::Ramp inGainRamp, driveRamp;
+    DSP::EnvelopeFollower envL, envR;
+    DSP::AttackReleaseEnvelope sagEnv;
+
+    // Control-rate grid for the envelope-to-drive path (see DSP::kControlInterval).
+    int ctrlCountdown = 0;
+    float envAccum = 0.0f;
+    float lastEnv = 0.0f;
+    float driveEffectiveTarget = 1.0f;
+    int meterCountdown = 1;
+    MeterAccum meterAcc {};
+
+    // Stages each cascade actually runs (bit per stage); identity stages drop
+    // out once at rest (see updatePreLive).
+    unsigned preLive = kAllStages;
+
+    // Partial-fraction form of the pre chain, run instead of preL/preR once
+    // the EQ ramps have settled. Any coefficient change hands the state back
+    // to the cascade first (leaveParallelPre), so ramps and redesigns always
+    // happen there.
+    alignas(64) DSP::ParallelBiquads prePar;
+    bool preParPending = false;
+
+    alignas(64) DSP::Biquad preL[kNumPre], preR[kNumPre];
+
+    // Linkwitz-Riley (LR4) split in front of the saturators: the low band
+    // bypasses the drive stage and is summed back clean. The two bands sum to
+    // a second-order allpass, so the low band is that allpass minus the high
+    // band, one section instead of two. Off at pCrossover_ 0.
+    alignas(64) DSP::Biquad xoverHighL[kXoverStages], xoverHighR[kXoverStages];
+    DSP::Biquad xoverApL, xoverApR;
+    bool xoverActive = false;
+
+    alignas(64) DSP::Saturator satL;
+    alignas(64) DSP::Saturator satR;
+
+    alignas(64) DSP::Ramp outGainRamp;
+    unsigned postLive = kAllStages;
+    DSP::Biquad postL[kNumPost], postR[kNumPost];
+
+    // EQ gains (dB) ramp at control rate; the sections are redesigned only
+    // while they move. In tone-stack mode the ramps carry the knob
+    // positions and kPreBass/kPreMid hold the stack's two sections.
+    alignas(64) DSP::Ramp bassDbRamp, midDbRamp, trebleDbRamp;
+    DSP::DynamicShelf preBassShape, preTrebleShape;
+    DSP::DynamicPeaking preMidShape;
+    DSP::ToneStack toneStack;
+    bool toneStackActive = false;
+    alignas(64) DSP::DynamicShelf postLowShape, postHighShape;
+  };
+  std::unique_ptr<State> state_;
+
+  // Host rate to internal rate and back, with fixedRate_ at a high rate.
+  std::unique_ptr<DSP::RateConverter> rate_;
+
+  // Stage threads and inter-stage buffers while pipelined; see engine.cpp.
+  std::unique_ptr<Pipeline> pipeline_;
+
+  DSP::SpscRing<svender_dsp_meters, 64> meterRing_;
+
+  Analyzer analyzer_;
+  Tuner tuner_;
+};
+
+} // namespace SvenderBass
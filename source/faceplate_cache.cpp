@@ -0,0 +1,72 @@
+#include "faceplate_cache.h"
+#include "editor_model.h"
+
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace SvenderBass::UI {
+
+namespace {
+
+const char* const kFaceplateFiles[2] = { "faceplate.png", "faceplate@2x.png" };
+
+bool readFile(const std::filesystem::path& path, std::vector<uint8_t>& bytes) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return false;
+  bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  return !bytes.empty();
+}
+
+} // namespace
+
+FaceplateCache& FaceplateCache::shared() {
+  static FaceplateCache cache;
+  return cache;
+}
+
+const Image* FaceplateCache::source(const std::filesystem::path& resourceDir, int index) {
+  Source& s = sources_[index];
+  if (!s.tried) {
+    s.tried = true;
+    std::vector<uint8_t> bytes;
+    auto img = std::make_shared<Image>();
+    if (readFile(resourceDir / kFaceplateFiles[index], bytes) && decodePng(bytes.data(), bytes.size(), *img))
+      s.image = std::move(img);
+  }
+  return s.image.get();
+}
+
+std::shared_ptr<const Image> FaceplateCache::get(const std::filesystem::path& resourceDir, int width, int height) {
+  if (width <= 0 || height <= 0)
+    return nullptr;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto it = scaled_.find({ width, height });
+  if (it != scaled_.end())
+    return it->second;
+
+  // Prefer the 2x asset only when the window is larger than the design size;
+  // fall back to whichever one decodes.
+  const int preferred = (width > kDesignWidth || height > kDesignHeight) ? 1 : 0;
+  const Image* src = source(resourceDir, preferred);
+  if (!src)
+    src = source(resourceDir, 1 - preferred);
+  if (!src)
+    return nullptr;
+
+  auto img = std::make_shared<const Image>(resample(*src, width, height));
+  scaled_[{ width, height }] = img;
+  return img;
+}
+
+void FaceplateCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  scaled_.clear();
+  for (Source& s : sources_)
+    s = Source();
+}
+
+} // namespace SvenderBass::UI
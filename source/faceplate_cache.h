@@ -0,0 +1,39 @@
+#pragma once
+#include "image.h"
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace SvenderBass::UI {
+
+// Process-wide store of faceplate bitmaps, shared by every open editor.
+// faceplate.png / faceplate@2x.png are each decoded at most once; per window
+// size the better-suited source (1x up to the design size, 2x above it) is
+// resampled once and kept as a ready-to-blit buffer.
+class FaceplateCache {
+public:
+  static FaceplateCache& shared();
+
+  // Null if neither asset can be read or decoded.
+  std::shared_ptr<const Image> get(const std::filesystem::path& resourceDir, int width, int height);
+
+  // Drops all decoded and scaled images (they stay alive while referenced).
+  void clear();
+
+private:
+  struct Source {
+    bool tried = false;
+    std::shared_ptr<const Image> image;
+  };
+
+  const Image* source(const std::filesystem::path& resourceDir, int index);
+
+  std::mutex mutex_;
+  Source sources_[2]; // 1x, 2x
+  std::map<std::pair<int, int>, std::shared_ptr<const Image>> scaled_;
+};
+
+} // namespace SvenderBass::UI
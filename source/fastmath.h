@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+// Branch-free float math for the hot saturation loops.
+//
+// These are ordinary inline functions, one definition for the whole program,
+// so inline code in dsp.h can use them. The per-ISA kernel translation units
+// (kernels_*.cpp), compiled with different -m/arch flags, must not: they
+// include the same bodies into their own anonymous namespace
+// (kernels_impl.h), so the linker can never hand an AVX2 body to the generic
+// code path.
+
+namespace SvenderBass::DSP {
+
+#include "fastmath_impl.h"
+
+} // namespace SvenderBass::DSP
@@ -0,0 +1,63 @@
+// Bodies of fastmath.h. No include guard and no namespace of its own: it is
+// included once into SvenderBass::DSP (fastmath.h) and once into each kernel
+// variant's anonymous namespace (kernels_impl.h), so the per-ISA objects get
+// private copies and export no inline definitions compiled with their flags.
+// Nothing here may call an inline function from outside this file; <cmath>'s
+// float overloads are inline too, hence the builtins. Needs <cstdint> and
+// <cstring>.
+
+#if defined(__GNUC__) || defined(__clang__)
+inline float absf(float x) { return __builtin_fabsf(x); }
+inline float copySignf(float mag, float sgn) { return __builtin_copysignf(mag, sgn); }
+#else
+inline float absf(float x) {
+  uint32_t b;
+  std::memcpy(&b, &x, sizeof(b));
+  b &= 0x7fffffffu;
+  std::memcpy(&x, &b, sizeof(x));
+  return x;
+}
+inline float copySignf(float mag, float sgn) {
+  uint32_t m, s;
+  std::memcpy(&m, &mag, sizeof(m));
+  std::memcpy(&s, &sgn, sizeof(s));
+  m = (m & 0x7fffffffu) | (s & 0x80000000u);
+  std::memcpy(&mag, &m, sizeof(mag));
+  return mag;
+}
+#endif
+
+// exp(x) for x <= 0 (Cephes polynomial, ~1 ulp). Inputs below -87 flush to
+// the smallest normal instead of producing denormals.
+inline float expNonPositive(float x) {
+  x = x < -87.0f ? -87.0f : x;
+  const float fx = x * 1.44269504088896341f;
+  const float n = (float)(int32_t)(fx - 0.5f);
+  const float r = x - n * 0.693359375f - n * -2.12194440e-4f;
+
+  float p = 1.9875691500e-4f;
+  p = p * r + 1.3981999507e-3f;
+  p = p * r + 8.3334519073e-3f;
+  p = p * r + 4.1665795894e-2f;
+  p = p * r + 1.6666665459e-1f;
+  p = p * r + 5.0000001201e-1f;
+  const float y = p * r * r + r + 1.0f;
+
+  const int32_t bits = ((int32_t)n + 127) << 23;
+  float scale;
+  std::memcpy(&scale, &bits, sizeof(scale));
+  return y * scale;
+}
+
+// tanh within ~1e-7 of std::tanh, written so compilers can vectorize it.
+// A [7/6] Pade approximant covers |x| < 0.625, where (1 - e) / (1 + e)
+// would lose relative precision; the exp form covers the rest.
+inline float fastTanh(float x) {
+  const float a = absf(x);
+  const float x2 = x * x;
+  const float small = x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2))) /
+                      (135135.0f + x2 * (62370.0f + x2 * (3150.0f + 28.0f * x2)));
+  const float e = expNonPositive(-2.0f * a);
+  const float big = copySignf((1.0f - e) / (1.0f + e), x);
+  return a < 0.625f ? small : big;
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include "pluginterfaces/base/funknown.h"
 #include "pluginterfaces/vst/vsttypes.h"
+#include "svender_dsp.h"
 
 namespace SvenderBass {
 
@@ -8,16 +9,32 @@ namespace SvenderBass {
 static const Steinberg::FUID kProcessorUID (0x2F0B1C91, 0x2A8F4B7D, 0x9E6D58C2, 0x4C5E18A1);
 static const Steinberg::FUID kControllerUID(0x8A1D2B7E, 0x9C3A4F10, 0xB1E2D3C4, 0x55667788);
 
+// Plugin parameter ids are the C API ids, so host automation maps 1:1 onto
+// svender_dsp_set_param.
 enum ParamID : Steinberg::Vst::ParamID {
-  kParamInputGain = 0,
-  kParamBass      = 1,
-  kParamMid       = 2,
-  kParamTreble    = 3,
-  kParamMidFreq   = 4, // 0..4 -> 220/450/800/1600/3000
-  kParamDrive     = 5,
-  kParamOutput    = 6,
-  kParamUltraLow  = 7,
-  kParamUltraHigh = 8,
+  kParamInputGain = SVENDER_PARAM_INPUT_GAIN,
+  kParamBass      = SVENDER_PARAM_BASS,
+  kParamMid       = SVENDER_PARAM_MID,
+  kParamTreble    = SVENDER_PARAM_TREBLE,
+  kParamMidFreq   = SVENDER_PARAM_MID_FREQ, // 0..4 -> 220/450/800/1600/3000
+  kParamDrive     = SVENDER_PARAM_DRIVE,
+  kParamOutput    = SVENDER_PARAM_OUTPUT,
+  kParamUltraLow  = SVENDER_PARAM_ULTRA_LOW,
+  kParamUltraHigh = SVENDER_PARAM_ULTRA_HIGH,
+  kParamSatMode   = SVENDER_PARAM_SAT_MODE, // 0..4 -> 4x oversampled / ADAA1 1x / ADAA1 2x / ADAA2 1x / ADAA2 2x
+  kParamTuner     = SVENDER_PARAM_TUNER,
+  kParamTunerMute = SVENDER_PARAM_TUNER_MUTE,
+  kParamCrossover = SVENDER_PARAM_CROSSOVER, // 0..4 -> full band / 80 / 120 / 200 / 300 Hz
+  kParamToneStack = SVENDER_PARAM_TONE_STACK,
+
+  // Read-only outputs written by the Processor (no C API equivalent; see
+  // svender_dsp_read_tuner).
+  kParamTunerNote  = 100, // MIDI note / 127, 0 = no pitch
+  kParamTunerCents = 101, // -50..+50 cents -> 0..1
+
+  // Plugin option, not automatable: run the chain at 44.1/48 kHz in
+  // high-rate sessions (Engine::setFixedInternalRate). Adds latency.
+  kParamInternalRate = 102,
 };
 
 } // namespace SvenderBass
@@ -0,0 +1,478 @@
+#include "image.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace SvenderBass::UI {
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Inflate (RFC 1951). Table-driven: each Huffman table is indexed directly by
+// the next maxBits input bits, which is fast enough to decode the 2x
+// faceplate in a few tens of milliseconds, once per process.
+
+class BitReader {
+public:
+  BitReader(const uint8_t* p, size_t n) : p_(p), end_(p + n) {}
+
+  uint32_t peek(int n) {
+    refill();
+    return (uint32_t)(buf_ & ((1ull << n) - 1));
+  }
+  void consume(int n) { buf_ >>= n; cnt_ -= n; }
+  uint32_t bits(int n) {
+    const uint32_t v = peek(n);
+    consume(n);
+    return v;
+  }
+  void alignToByte() { consume(cnt_ & 7); }
+
+  // True once bits beyond the end of the input have been consumed.
+  bool overrun() const { return pad_ * 8 > cnt_; }
+
+private:
+  void refill() {
+    while (cnt_ <= 56) {
+      uint64_t byte = 0;
+      if (p_ < end_) byte = *p_++;
+      else ++pad_;
+      buf_ |= byte << cnt_;
+      cnt_ += 8;
+    }
+  }
+
+  const uint8_t* p_;
+  const uint8_t* end_;
+  uint64_t buf_ = 0;
+  int cnt_ = 0;
+  int pad_ = 0;
+};
+
+struct Huffman {
+  std::vector<uint16_t> table; // (symbol << 4) | length; 0 = invalid code
+  int maxBits = 0;
+
+  bool build(const uint8_t* lengths, int n) {
+    int count[16] = {};
+    for (int i = 0; i < n; ++i) ++count[lengths[i]];
+    count[0] = 0;
+
+    maxBits = 0;
+    for (int b = 1; b < 16; ++b)
+      if (count[b]) maxBits = b;
+    if (maxBits == 0) {
+      // No codes at all (e.g. no distances in a literal-only block).
+      maxBits = 1;
+      table.assign(2, 0);
+      return true;
+    }
+
+    int left = 1;
+    for (int b = 1; b < 16; ++b) {
+      left = (left << 1) - count[b];
+      if (left < 0) return false; // over-subscribed
+    }
+
+    int next[16] = {};
+    for (int b = 1, code = 0; b < 16; ++b) {
+      code = (code + count[b - 1]) << 1;
+      next[b] = code;
+    }
+
+    table.assign((size_t)1 << maxBits, 0);
+    for (int sym = 0; sym < n; ++sym) {
+      const int len = lengths[sym];
+      if (!len) continue;
+      const int code = next[len]++;
+      int rev = 0;
+      for (int b = 0; b < len; ++b)
+        rev |= ((code >> b) & 1) << (len - 1 - b);
+      const uint16_t entry = (uint16_t)((sym << 4) | len);
+      for (int i = rev; i < (1 << maxBits); i += 1 << len)
+        table[(size_t)i] = entry;
+    }
+    return true;
+  }
+
+  // -1 on an invalid code.
+  int decode(BitReader& br) const {
+    const uint16_t e = table[br.peek(maxBits)];
+    if (!e) return -1;
+    br.consume(e & 15);
+    return e >> 4;
+  }
+};
+
+const uint16_t kLenBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+const uint8_t kLenExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+const uint16_t kDistBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                 8193, 12289, 16385, 24577 };
+const uint8_t kDistExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+bool inflateCodes(BitReader& br, const Huffman& lit, const Huffman& dist,
+                  uint8_t* out, size_t outSize, size_t& pos) {
+  for (;;) {
+    const int sym = lit.decode(br);
+    if (sym < 0 || br.overrun()) return false;
+    if (sym < 256) {
+      if (pos >= outSize) return false;
+      out[pos++] = (uint8_t)sym;
+      continue;
+    }
+    if (sym == 256) return true;
+
+    const int li = sym - 257;
+    if (li >= 29) return false;
+    const size_t len = kLenBase[li] + br.bits(kLenExtra[li]);
+
+    const int ds = dist.decode(br);
+    if (ds < 0 || ds >= 30) return false;
+    const size_t d = kDistBase[ds] + br.bits(kDistExtra[ds]);
+
+    if (d > pos || len > outSize - pos) return false;
+    const uint8_t* src = out + pos - d;
+    uint8_t* dst = out + pos;
+    for (size_t i = 0; i < len; ++i) dst[i] = src[i]; // may overlap forward
+    pos += len;
+  }
+}
+
+struct FixedTables {
+  Huffman lit, dist;
+
+  FixedTables() {
+    uint8_t l[288];
+    std::fill(l, l + 144, 8);
+    std::fill(l + 144, l + 256, 9);
+    std::fill(l + 256, l + 280, 7);
+    std::fill(l + 280, l + 288, 8);
+    lit.build(l, 288);
+    std::fill(l, l + 30, 5);
+    dist.build(l, 30);
+  }
+};
+
+bool inflate(const uint8_t* data, size_t size, uint8_t* out, size_t outSize) {
+  static const FixedTables fixed;
+
+  BitReader br(data, size);
+  size_t pos = 0;
+  Huffman lit, dist;
+
+  for (;;) {
+    const uint32_t final = br.bits(1);
+    const uint32_t type = br.bits(2);
+
+    if (type == 0) {
+      br.alignToByte();
+      const uint32_t len = br.bits(16);
+      const uint32_t nlen = br.bits(16);
+      if ((len ^ 0xffff) != nlen || len > outSize - pos) return false;
+      for (uint32_t i = 0; i < len; ++i) out[pos++] = (uint8_t)br.bits(8);
+      if (br.overrun()) return false;
+    } else if (type == 1) {
+      if (!inflateCodes(br, fixed.lit, fixed.dist, out, outSize, pos)) return false;
+    } else if (type == 2) {
+      const int hlit = (int)br.bits(5) + 257;
+      const int hdist = (int)br.bits(5) + 1;
+      const int hclen = (int)br.bits(4) + 4;
+      // The 5-bit fields reach 288 and 32; only 286 and 30 are valid (RFC
+      // 1951, 3.2.7), and lengths[] has room for no more.
+      if (hlit > 286 || hdist > 30) return false;
+      static const uint8_t order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+      uint8_t clen[19] = {};
+      for (int i = 0; i < hclen; ++i) clen[order[i]] = (uint8_t)br.bits(3);
+      Huffman clh;
+      if (!clh.build(clen, 19)) return false;
+
+      uint8_t lengths[286 + 30] = {};
+      int n = 0;
+      while (n < hlit + hdist) {
+        const int sym = clh.decode(br);
+        if (sym < 0 || br.overrun()) return false;
+        if (sym < 16) { lengths[n++] = (uint8_t)sym; continue; }
+
+        int rep = 0;
+        uint8_t val = 0;
+        if (sym == 16) {
+          if (n == 0) return false;
+          val = lengths[n - 1];
+          rep = 3 + (int)br.bits(2);
+        } else if (sym == 17) {
+          rep = 3 + (int)br.bits(3);
+        } else {
+          rep = 11 + (int)br.bits(7);
+        }
+        if (n + rep > hlit + hdist) return false;
+        while (rep--) lengths[n++] = val;
+      }
+
+      if (!lit.build(lengths, hlit) || !dist.build(lengths + hlit, hdist)) return false;
+      if (!inflateCodes(br, lit, dist, out, outSize, pos)) return false;
+    } else {
+      return false;
+    }
+
+    if (final) break;
+  }
+  return pos == outSize;
+}
+
+// ---------------------------------------------------------------------------
+// PNG
+
+uint32_t be32(const uint8_t* p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+uint32_t adler32(const uint8_t* p, size_t n) {
+  uint32_t a = 1, b = 0;
+  while (n > 0) {
+    const size_t run = std::min<size_t>(n, 5552); // no overflow before the modulo
+    for (size_t i = 0; i < run; ++i) {
+      a += p[i];
+      b += a;
+    }
+    a %= 65521;
+    b %= 65521;
+    p += run;
+    n -= run;
+  }
+  return (b << 16) | a;
+}
+
+int paeth(int a, int b, int c) {
+  const int p = a + b - c;
+  const int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+  if (pa <= pb && pa <= pc) return a;
+  return pb <= pc ? b : c;
+}
+
+bool unfilter(uint8_t* raw, int width, int height, int bpp) {
+  const size_t stride = (size_t)width * bpp;
+  std::vector<uint8_t> zero(stride, 0);
+  const uint8_t* prev = zero.data();
+
+  for (int y = 0; y < height; ++y) {
+    uint8_t* row = raw + (size_t)y * (stride + 1);
+    const uint8_t filter = row[0];
+    uint8_t* cur = row + 1;
+
+    switch (filter) {
+      case 0: break;
+      case 1:
+        for (size_t i = bpp; i < stride; ++i) cur[i] = (uint8_t)(cur[i] + cur[i - bpp]);
+        break;
+      case 2:
+        for (size_t i = 0; i < stride; ++i) cur[i] = (uint8_t)(cur[i] + prev[i]);
+        break;
+      case 3:
+        for (size_t i = 0; i < stride; ++i) {
+          const int left = i >= (size_t)bpp ? cur[i - bpp] : 0;
+          cur[i] = (uint8_t)(cur[i] + ((left + prev[i]) >> 1));
+        }
+        break;
+      case 4:
+        for (size_t i = 0; i < stride; ++i) {
+          const int left = i >= (size_t)bpp ? cur[i - bpp] : 0;
+          const int upLeft = i >= (size_t)bpp ? prev[i - bpp] : 0;
+          cur[i] = (uint8_t)(cur[i] + paeth(left, prev[i], upLeft));
+        }
+        break;
+      default:
+        return false;
+    }
+    prev = cur;
+  }
+  return true;
+}
+
+inline uint32_t packPremultiplied(uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+  if (a != 255) {
+    r = (r * a + 127) / 255;
+    g = (g * a + 127) / 255;
+    b = (b * a + 127) / 255;
+  }
+  return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+// ---------------------------------------------------------------------------
+// Resampling
+
+// For each destination index along one axis: the first source index and the
+// weights of the source samples that contribute to it.
+struct AxisWeights {
+  int taps = 0;
+  std::vector<int> first;
+  std::vector<float> w; // dst * taps
+
+  void build(int srcN, int dstN) {
+    first.assign((size_t)dstN, 0);
+    if (dstN <= srcN) {
+      // Area average: destination pixel i covers [i*r, (i+1)*r) of the source.
+      const double r = (double)srcN / dstN;
+      taps = (int)std::ceil(r) + 1;
+      w.assign((size_t)dstN * taps, 0.0f);
+      for (int i = 0; i < dstN; ++i) {
+        const double x0 = i * r, x1 = (i + 1) * r;
+        const int j0 = (int)std::floor(x0);
+        first[(size_t)i] = j0;
+        for (int k = 0; k < taps; ++k) {
+          const int j = j0 + k;
+          if (j >= srcN) break;
+          const double overlap = std::min(x1, (double)(j + 1)) - std::max(x0, (double)j);
+          if (overlap > 0.0) w[(size_t)i * taps + k] = (float)(overlap / r);
+        }
+      }
+    } else {
+      // Bilinear between pixel centers, clamped at the edges.
+      taps = 2;
+      w.assign((size_t)dstN * 2, 0.0f);
+      const double r = (double)srcN / dstN;
+      for (int i = 0; i < dstN; ++i) {
+        double s = (i + 0.5) * r - 0.5;
+        s = std::max(0.0, std::min(s, (double)(srcN - 1)));
+        int j = (int)s;
+        if (j >= srcN - 1) j = std::max(0, srcN - 2);
+        const float t = srcN > 1 ? (float)(s - j) : 0.0f;
+        first[(size_t)i] = j;
+        w[(size_t)i * 2] = 1.0f - t;
+        w[(size_t)i * 2 + 1] = t;
+      }
+    }
+  }
+};
+
+} // namespace
+
+bool decodePng(const uint8_t* data, size_t size, Image& out) {
+  out = Image();
+  static const uint8_t kSig[8] = { 0x89, 'P', 'N', 'G', 0x0d, 0x0a, 0x1a, 0x0a };
+  if (!data || size < 8 || std::memcmp(data, kSig, 8) != 0)
+    return false;
+
+  int width = 0, height = 0, channels = 0;
+  std::vector<uint8_t> idat;
+
+  size_t pos = 8;
+  bool haveHeader = false;
+  while (pos + 12 <= size) {
+    const uint32_t len = be32(data + pos);
+    const uint8_t* type = data + pos + 4;
+    const uint8_t* body = data + pos + 8;
+    if (len > size - pos - 12) return false;
+
+    if (std::memcmp(type, "IHDR", 4) == 0) {
+      if (len < 13) return false;
+      width = (int)be32(body);
+      height = (int)be32(body + 4);
+      const int bitDepth = body[8], colorType = body[9], interlace = body[12];
+      if (bitDepth != 8 || interlace != 0) return false;
+      switch (colorType) {
+        case 0: channels = 1; break;
+        case 2: channels = 3; break;
+        case 4: channels = 2; break;
+        case 6: channels = 4; break;
+        default: return false;
+      }
+      if (width <= 0 || height <= 0 || width > 16384 || height > 16384) return false;
+      haveHeader = true;
+    } else if (std::memcmp(type, "IDAT", 4) == 0) {
+      idat.insert(idat.end(), body, body + len);
+    } else if (std::memcmp(type, "IEND", 4) == 0) {
+      break;
+    }
+    pos += 12 + len;
+  }
+
+  // zlib wrapper: deflate, no preset dictionary.
+  if (!haveHeader || idat.size() < 6) return false;
+  if ((idat[0] & 0x0f) != 8 || ((idat[0] << 8) | idat[1]) % 31 != 0 || (idat[1] & 0x20)) return false;
+
+  const size_t stride = (size_t)width * channels + 1;
+  std::vector<uint8_t> raw(stride * (size_t)height);
+  if (!inflate(idat.data() + 2, idat.size() - 6, raw.data(), raw.size())) return false;
+  // The stream's Adler-32 trailer: PNG chunk CRCs aside, the only check on
+  // the decompressed data.
+  if (adler32(raw.data(), raw.size()) != be32(idat.data() + idat.size() - 4)) return false;
+  if (!unfilter(raw.data(), width, height, channels)) return false;
+
+  out.width = width;
+  out.height = height;
+  out.pixels.resize((size_t)width * height);
+  for (int y = 0; y < height; ++y) {
+    const uint8_t* s = raw.data() + (size_t)y * stride + 1;
+    uint32_t* d = out.pixels.data() + (size_t)y * width;
+    for (int x = 0; x < width; ++x, s += channels) {
+      switch (channels) {
+        case 1: d[x] = packPremultiplied(s[0], s[0], s[0], 255); break;
+        case 2: d[x] = packPremultiplied(s[0], s[0], s[0], s[1]); break;
+        case 3: d[x] = packPremultiplied(s[0], s[1], s[2], 255); break;
+        default: d[x] = packPremultiplied(s[0], s[1], s[2], s[3]); break;
+      }
+    }
+  }
+  return true;
+}
+
+Image resample(const Image& src, int width, int height) {
+  Image out;
+  if (src.empty() || width <= 0 || height <= 0)
+    return out;
+  if (width == src.width && height == src.height)
+    return src;
+
+  AxisWeights wx, wy;
+  wx.build(src.width, width);
+  wy.build(src.height, height);
+
+  out.width = width;
+  out.height = height;
+  out.pixels.resize((size_t)width * height);
+
+  // Vertical pass into one float row (4 channels), then horizontal pass.
+  std::vector<float> row((size_t)src.width * 4);
+  for (int y = 0; y < height; ++y) {
+    std::fill(row.begin(), row.end(), 0.0f);
+    for (int k = 0; k < wy.taps; ++k) {
+      const float wk = wy.w[(size_t)y * wy.taps + k];
+      const int sy = wy.first[(size_t)y] + k;
+      if (wk == 0.0f || sy >= src.height) continue;
+      const uint32_t* s = src.pixels.data() + (size_t)sy * src.width;
+      for (int x = 0; x < src.width; ++x) {
+        const uint32_t p = s[x];
+        float* r = &row[(size_t)x * 4];
+        r[0] += wk * (float)(p >> 24);
+        r[1] += wk * (float)((p >> 16) & 0xff);
+        r[2] += wk * (float)((p >> 8) & 0xff);
+        r[3] += wk * (float)(p & 0xff);
+      }
+    }
+
+    uint32_t* d = out.pixels.data() + (size_t)y * width;
+    for (int x = 0; x < width; ++x) {
+      float acc[4] = {};
+      for (int k = 0; k < wx.taps; ++k) {
+        const float wk = wx.w[(size_t)x * wx.taps + k];
+        const int sx = wx.first[(size_t)x] + k;
+        if (wk == 0.0f || sx >= src.width) continue;
+        const float* r = &row[(size_t)sx * 4];
+        for (int c = 0; c < 4; ++c) acc[c] += wk * r[c];
+      }
+      uint32_t v[4];
+      for (int c = 0; c < 4; ++c)
+        v[c] = (uint32_t)std::min(255.0f, std::max(0.0f, acc[c] + 0.5f));
+      d[x] = (v[0] << 24) | (v[1] << 16) | (v[2] << 8) | v[3];
+    }
+  }
+  return out;
+}
+
+} // namespace SvenderBass::UI
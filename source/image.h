@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Minimal, platform-neutral image support for the editor: decoding the
+// faceplate PNGs and resampling them to the window size. Pixels are 32-bit
+// 0xAARRGGBB (BGRA in memory on little-endian), premultiplied, top-down rows,
+// i.e. the layout of a 32bpp top-down DIB, so a buffer can be blitted as-is.
+
+namespace SvenderBass::UI {
+
+struct Image {
+  int width = 0;
+  int height = 0;
+  std::vector<uint32_t> pixels; // width * height, row-major
+
+  bool empty() const { return width <= 0 || height <= 0; }
+};
+
+// Decodes 8-bit RGB / RGBA / gray / gray+alpha, non-interlaced PNGs, which
+// covers the shipped assets. Returns false (and leaves out empty) otherwise,
+// and for truncated or corrupted data (zlib Adler-32 mismatch).
+bool decodePng(const uint8_t* data, size_t size, Image& out);
+
+// Resamples to width x height: area averaging when shrinking, bilinear when
+// enlarging. Same size is a copy.
+Image resample(const Image& src, int width, int height);
+
+} // namespace SvenderBass::UI
@@ -0,0 +1,137 @@
+#include "kernels.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_MSC_VER)
+  #include <intrin.h>
+#endif
+
+namespace SvenderBass::DSP {
+
+namespace generic { const KernelTable& table(); }
+#if defined(SVENDER_X86_KERNELS)
+namespace avx2    { const KernelTable& table(); }
+namespace avx512  { const KernelTable& table(); }
+#endif
+
+namespace {
+
+#if defined(SVENDER_X86_KERNELS)
+void cpuid(int leaf, int sub, int regs[4]) {
+#if defined(_MSC_VER)
+  __cpuidex(regs, leaf, sub);
+#else
+  __asm__ __volatile__("cpuid"
+                       : "=a"(regs[0]), "=b"(regs[1]), "=c"(regs[2]), "=d"(regs[3])
+                       : "a"(leaf), "c"(sub));
+#endif
+}
+
+unsigned long long xgetbv0() {
+#if defined(_MSC_VER)
+  return _xgetbv(0);
+#else
+  unsigned int lo = 0, hi = 0;
+  __asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+  return ((unsigned long long)hi << 32) | lo;
+#endif
+}
+
+// Highest variant both the CPU and the OS (saved register state) support.
+Isa detectIsa() {
+  int r[4] = {};
+  cpuid(0, 0, r);
+  const int maxLeaf = r[0];
+  if (maxLeaf < 7)
+    return Isa::Generic;
+
+  cpuid(1, 0, r);
+  const bool fma = (r[2] >> 12) & 1;
+  const bool osxsave = (r[2] >> 27) & 1;
+  const bool avx = (r[2] >> 28) & 1;
+  if (!osxsave || !avx || !fma)
+    return Isa::Generic;
+
+  const unsigned long long xcr0 = xgetbv0();
+  if ((xcr0 & 0x6) != 0x6) // XMM + YMM state
+    return Isa::Generic;
+
+  cpuid(7, 0, r);
+  const bool avx2 = (r[1] >> 5) & 1;
+  const bool avx512f = (r[1] >> 16) & 1;
+  const bool avx512dq = (r[1] >> 17) & 1;
+  const bool avx512vl = (r[1] >> 31) & 1;
+  if (!avx2)
+    return Isa::Generic;
+
+  if (avx512f && avx512dq && avx512vl && (xcr0 & 0xe6) == 0xe6) // + opmask/ZMM state
+    return Isa::Avx512;
+  return Isa::Avx2;
+}
+#else
+Isa detectIsa() { return Isa::Generic; }
+#endif
+
+Isa supportedIsa() {
+  static const Isa isa = detectIsa();
+  return isa;
+}
+
+const KernelTable* compiledTable(Isa isa) {
+  switch (isa) {
+    case Isa::Generic: return &generic::table();
+#if defined(SVENDER_X86_KERNELS)
+    case Isa::Avx2:    return &avx2::table();
+    case Isa::Avx512:  return &avx512::table();
+#endif
+    default:           return nullptr;
+  }
+}
+
+const KernelTable& selectKernels() {
+  int want = (int)supportedIsa();
+
+  if (const char* env = std::getenv("SVENDER_DSP_ISA")) {
+    for (int i = 0; i < (int)Isa::Count; ++i) {
+      if (std::strcmp(env, isaName((Isa)i)) == 0) {
+        want = i < want ? i : want;
+        break;
+      }
+    }
+  }
+
+  for (int i = want; i > 0; --i) {
+    if (const KernelTable* t = kernelsFor((Isa)i))
+      return *t;
+  }
+  return generic::table();
+}
+
+} // namespace
+
+const char* isaName(Isa isa) {
+  switch (isa) {
+    case Isa::Generic: return "generic";
+    case Isa::Avx2:    return "avx2";
+    case Isa::Avx512:  return "avx512";
+    default:           return "unknown";
+  }
+}
+
+const KernelTable* kernelsFor(Isa isa) {
+  if ((int)isa > (int)supportedIsa())
+    return nullptr;
+  return compiledTable(isa);
+}
+
+const KernelTable& kernels() {
+  static const KernelTable& active = selectKernels();
+  return active;
+}
+
+// Resolve the table while the module loads rather than on the first audio
+// callback.
+static const KernelTable& gLoadTimeKernels = kernels();
+
+} // namespace SvenderBass::DSP
@@ -0,0 +1,73 @@
+#pragma once
+#include "dsp.h"
+#include "parallel_biquads.h"
+
+// Block kernels for the hot DSP loops, compiled once per instruction set and
+// selected at module load (see kernels.cpp).
+//
+// The variant is picked from CPUID. The SVENDER_DSP_ISA environment variable
+// (generic | avx2 | avx512) overrides the choice for testing; a request the
+// CPU cannot run falls back to the best supported variant below it.
+
+namespace SvenderBass::DSP {
+
+enum class Isa : int {
+  Generic = 0,
+  Avx2,   // AVX2 + FMA
+  Avx512, // AVX-512F/VL/DQ + FMA
+  Count
+};
+
+struct KernelTable {
+  Isa isa;
+  const char* name;
+
+  // Runs x[0..n) in place through numStages serial biquads.
+  void (*biquadCascade)(Biquad* stages, int numStages, float* x, int n);
+
+  // Oversampler4x + tubeSatMulti over x[0..n) in place, with a per-sample
+  // drive. Same arithmetic as Saturator::process in Oversample4x mode.
+  void (*saturate4x)(Oversampler4x& os, float* x, const float* drive, int n);
+
+  // Metering reduction: *peak = max(*peak, |x|), *sumSq += x^2 over x[0..n).
+  void (*peakSumSquares)(const float* x, int n, float* peak, float* sumSq);
+
+  // Stereo ParallelBiquads over xL/xR[0..n) in place: every section of both
+  // channels in SIMD lanes, then a fixed-order lane sum.
+  void (*parallelBiquads)(ParallelBiquads& pb, float* xL, float* xR, int n);
+};
+
+// Active table, chosen once at load.
+const KernelTable& kernels();
+
+// Table for a specific ISA, or nullptr if it was not compiled in or the CPU
+// cannot run it. Used by the benchmarks to cover every variant.
+const KernelTable* kernelsFor(Isa isa);
+
+const char* isaName(Isa isa);
+
+// Block form of Saturator::process for a mode fixed at compile time. The
+// brute-force 4x path goes through the dispatched kernel; the ADAA modes run
+// in double and stay scalar.
+template <SatMode M>
+inline void saturateBlock(Saturator& sat, float* x, const float* drive, int n) {
+  if constexpr (M == SatMode::Oversample4x) {
+    kernels().saturate4x(sat.os, x, drive, n);
+  } else {
+    for (int i = 0; i < n; ++i)
+      x[i] = sat.processAs<M>(x[i], drive[i]);
+  }
+}
+
+// Same, with the mode switch taken once per block.
+inline void saturateBlock(Saturator& sat, float* x, const float* drive, int n) {
+  switch (sat.mode) {
+    case SatMode::Adaa1_1x: saturateBlock<SatMode::Adaa1_1x>(sat, x, drive, n); break;
+    case SatMode::Adaa1_2x: saturateBlock<SatMode::Adaa1_2x>(sat, x, drive, n); break;
+    case SatMode::Adaa2_1x: saturateBlock<SatMode::Adaa2_1x>(sat, x, drive, n); break;
+    case SatMode::Adaa2_2x: saturateBlock<SatMode::Adaa2_2x>(sat, x, drive, n); break;
+    default:                saturateBlock<SatMode::Oversample4x>(sat, x, drive, n); break;
+  }
+}
+
+} // namespace SvenderBass::DSP
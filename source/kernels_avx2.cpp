@@ -0,0 +1,5 @@
+#define SVENDER_KERNEL_NS avx2
+#define SVENDER_KERNEL_ISA Isa::Avx2
+#define SVENDER_KERNEL_NAME "avx2"
+#define SVENDER_KERNEL_GENERIC_CASCADE
+#include "kernels_impl.h"
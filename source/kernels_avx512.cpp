@@ -0,0 +1,5 @@
+#define SVENDER_KERNEL_NS avx512
+#define SVENDER_KERNEL_ISA Isa::Avx512
+#define SVENDER_KERNEL_NAME "avx512"
+#define SVENDER_KERNEL_GENERIC_CASCADE
+#include "kernels_impl.h"
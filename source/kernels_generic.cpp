@@ -0,0 +1,4 @@
+#define SVENDER_KERNEL_NS generic
+#define SVENDER_KERNEL_ISA Isa::Generic
+#define SVENDER_KERNEL_NAME "generic"
+#include "kernels_impl.h"
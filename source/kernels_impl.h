@@ -0,0 +1,204 @@
+// Kernel bodies, included once per ISA by kernels_<isa>.cpp with
+// SVENDER_KERNEL_NS set to the variant namespace. No include guard: each
+// including TU gets its own copy.
+//
+// Rule for this file: touch the DSP structs only through their data members
+// and call nothing but this variant's copy of fastmath_impl.h, included into
+// the anonymous namespace below. The inline functions in dsp.h, fastmath.h
+// and <cmath> have external linkage; calling them from here would emit
+// copies compiled for this ISA that the linker may pick for the generic
+// build.
+
+#include "kernels.h"
+
+#include <cstdint>
+#include <cstring>
+
+#ifndef SVENDER_KERNEL_NS
+#error "SVENDER_KERNEL_NS must name the ISA variant namespace"
+#endif
+
+// The biquad cascade is one serial recurrence per stage: wider vectors do not
+// help it, and FMA contraction lengthens its loop-carried path (kernel_bench:
+// ~18 ns/sample generic, ~21 with FMA). Variants that define
+// SVENDER_KERNEL_GENERIC_CASCADE use the generic build of it.
+#if defined(SVENDER_KERNEL_GENERIC_CASCADE)
+namespace SvenderBass::DSP::generic {
+void biquadCascade(Biquad* stages, int numStages, float* x, int n);
+}
+#endif
+
+namespace SvenderBass::DSP::SVENDER_KERNEL_NS {
+
+namespace {
+
+#include "fastmath_impl.h"
+
+constexpr int kChunk = 32;
+
+inline float biquadStep(Biquad& s, float x) {
+  const float y = s.b0 * x + s.z1;
+  s.z1 = s.b1 * x - s.a1 * y + s.z2;
+  s.z2 = s.b2 * x - s.a2 * y;
+  return y;
+}
+
+inline void upsample2x(Oversampler2x& os, float x, float& y0, float& y1) {
+  const float h = 0.5f * (x + os.prev);
+  os.prev = x;
+  y0 = biquadStep(os.lpUp, x);
+  y1 = biquadStep(os.lpUp, h);
+}
+
+inline float downsample2x(Oversampler2x& os, float y0, float y1) {
+  const float f0 = biquadStep(os.lpDown, y0);
+  biquadStep(os.lpDown, y1);
+  return f0;
+}
+
+} // namespace
+
+#if !defined(SVENDER_KERNEL_GENERIC_CASCADE)
+void biquadCascade(Biquad* stages, int numStages, float* x, int n) {
+  for (int s = 0; s < numStages; ++s) {
+    Biquad& bq = stages[s];
+    float z1 = bq.z1, z2 = bq.z2;
+    const float b0 = bq.b0, b1 = bq.b1, b2 = bq.b2, a1 = bq.a1, a2 = bq.a2;
+    for (int i = 0; i < n; ++i) {
+      const float in = x[i];
+      const float y = b0 * in + z1;
+      z1 = b1 * in - a1 * y + z2;
+      z2 = b2 * in - a2 * y;
+      x[i] = y;
+    }
+    bq.z1 = z1;
+    bq.z2 = z2;
+  }
+}
+#endif
+
+void saturate4x(Oversampler4x& os, float* x, const float* drive, int n) {
+  const float tb1 = fastTanh(0.08f);
+  const float tb2 = fastTanh(-0.04f);
+  const float tb3 = fastTanh(0.02f);
+
+  alignas(64) float up[4 * kChunk];
+  alignas(64) float d4[4 * kChunk];
+
+  for (int base = 0; base < n; base += kChunk) {
+    const int len = (n - base < kChunk) ? n - base : kChunk;
+
+    // Recursive half-band filters: serial by nature.
+    for (int i = 0; i < len; ++i) {
+      float t0 = 0.0f, t1 = 0.0f;
+      upsample2x(os.s1, x[base + i], t0, t1);
+      upsample2x(os.s2, t0, up[4 * i + 0], up[4 * i + 1]);
+      upsample2x(os.s2, t1, up[4 * i + 2], up[4 * i + 3]);
+      const float d = drive[base + i];
+      d4[4 * i + 0] = d4[4 * i + 1] = d4[4 * i + 2] = d4[4 * i + 3] = d;
+    }
+
+    // Memoryless tube stages over the whole oversampled chunk: this is the
+    // loop the wider ISAs vectorize.
+    for (int j = 0; j < 4 * len; ++j) {
+      const float d = d4[j];
+      float y = up[j];
+      y = fastTanh(y * d + 0.08f) - tb1;
+      y = fastTanh(y * (d * 0.7f + 0.3f) + -0.04f) - tb2;
+      y = fastTanh(y * (d * 0.5f + 0.5f) + 0.02f) - tb3;
+      up[j] = y;
+    }
+
+    for (int i = 0; i < len; ++i) {
+      const float t0 = downsample2x(os.s2, up[4 * i + 0], up[4 * i + 1]);
+      const float t1 = downsample2x(os.s2, up[4 * i + 2], up[4 * i + 3]);
+      x[base + i] = downsample2x(os.s1, t0, t1);
+    }
+  }
+}
+
+void parallelBiquads(ParallelBiquads& pb, float* xL, float* xR, int n) {
+  constexpr int S = ParallelBiquads::kSections;
+  constexpr int L = ParallelBiquads::kLanes;
+  static_assert(S == 8, "lane sum below is written out for 8 sections");
+
+  alignas(64) float b0[L], b1[L], a1[L], a2[L], z1[L], z2[L];
+  for (int k = 0; k < L; ++k) {
+    b0[k] = pb.b0[k]; b1[k] = pb.b1[k]; a1[k] = pb.a1[k]; a2[k] = pb.a2[k];
+    z1[k] = pb.z1[k]; z2[k] = pb.z2[k];
+  }
+  const float direct = pb.direct;
+
+  for (int i = 0; i < n; ++i) {
+    const float l = xL[i], r = xR[i];
+    alignas(64) float y[L];
+
+    // All sections of both channels in one pass: no lane depends on another.
+    for (int k = 0; k < S; ++k) {
+      y[k] = b0[k] * l + z1[k];
+      z1[k] = b1[k] * l - a1[k] * y[k] + z2[k];
+      z2[k] = -a2[k] * y[k];
+    }
+    for (int k = S; k < L; ++k) {
+      y[k] = b0[k] * r + z1[k];
+      z1[k] = b1[k] * r - a1[k] * y[k] + z2[k];
+      z2[k] = -a2[k] * y[k];
+    }
+
+    // Pairwise lane sums, a fixed order for every ISA. Inputs come straight
+    // from registers and the tree stays in y[]: round trips through small
+    // scalar stores cost more than the sections themselves.
+    for (int k = 0; k < 4; ++k) { y[k] += y[k + 4]; y[S + k] += y[S + k + 4]; }
+    for (int k = 0; k < 2; ++k) { y[k] += y[k + 2]; y[S + k] += y[S + k + 2]; }
+    xL[i] = direct * l + (y[0] + y[1]);
+    xR[i] = direct * r + (y[S] + y[S + 1]);
+  }
+
+  for (int k = 0; k < L; ++k) {
+    pb.z1[k] = z1[k];
+    pb.z2[k] = z2[k];
+  }
+}
+
+void peakSumSquares(const float* x, int n, float* peak, float* sumSq) {
+  // Independent lanes so the reductions vectorize without reassociation
+  // flags; the lanes are folded once at the end.
+  constexpr int kLanes = 16;
+  float pk[kLanes] = {};
+  float sq[kLanes] = {};
+
+  int i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    for (int l = 0; l < kLanes; ++l) {
+      const float v = x[i + l];
+      const float a = absf(v);
+      pk[l] = pk[l] > a ? pk[l] : a;
+      sq[l] += v * v;
+    }
+  }
+
+  float p = *peak;
+  float s = 0.0f;
+  for (int l = 0; l < kLanes; ++l) {
+    p = p > pk[l] ? p : pk[l];
+    s += sq[l];
+  }
+  for (; i < n; ++i) {
+    const float a = absf(x[i]);
+    p = p > a ? p : a;
+    s += x[i] * x[i];
+  }
+  *peak = p;
+  *sumSq += s;
+}
+
+const KernelTable& table() {
+#if defined(SVENDER_KERNEL_GENERIC_CASCADE)
+  static const KernelTable t { SVENDER_KERNEL_ISA, SVENDER_KERNEL_NAME, &generic::biquadCascade, &saturate4x, &peakSumSquares, &parallelBiquads };
+#else
+  static const KernelTable t { SVENDER_KERNEL_ISA, SVENDER_KERNEL_NAME, &biquadCascade, &saturate4x, &peakSumSquares, &parallelBiquads };
+#endif
+  return t;
+}
+
+} // namespace SvenderBass::DSP::SVENDER_KERNEL_NS
@@ -0,0 +1,234 @@
+#include "parallel_biquads.h"
+
+#include <algorithm>
+#include <complex>
+
+namespace SvenderBass::DSP {
+
+namespace {
+
+using cd = std::complex<double>;
+
+// Sections whose individual gains are far above the overall response cancel
+// against each other in the sum, costing float precision the serial form
+// does not lose. This bounds the sum of the section peak gains (~34 dB).
+constexpr double kMaxSectionGainSum = 52.0;
+// Relative pole separation below which the expansion is treated as having a
+// repeated pole.
+constexpr double kMinPoleSeparation = 1.0e-6;
+
+cd numeratorAt(const Biquad& s, cd w) {
+  return (double)s.b0 + w * ((double)s.b1 + w * (double)s.b2);
+}
+
+// Larger of a section's gains at DC and at its pole angle.
+double sectionPeakGain(double b0, double b1, double a1, double a2, cd pole) {
+  double g = 0.0;
+  for (double theta : { 0.0, std::abs(std::arg(pole)) }) {
+    const cd w = std::polar(1.0, -theta);
+    g = std::max(g, std::abs((b0 + b1 * w) / (1.0 + w * (a1 + w * a2))));
+  }
+  return g;
+}
+
+// State hand-over, in double. Both forms have the same poles, so a state is
+// matched through the residues of its zero-input response
+//
+//   Y0(w) = sum_i R_i / (1 - p_i w),  w = z^-1.
+//
+// A transposed DF-II section with state (z1, z2) and no input contributes
+// (z1 + z2 w) / A(w). In the cascade, stage j's contribution also passes
+// through every later stage; V_k = U_k B_k + S_k with U_{k+1} = V_k / A_k
+// is the zero-input output of stages [0, k] before stage k's poles divide
+// it, so the residue at pole p of stage k (other pole q) is
+//
+//   R = V_k(1/p) * prod_{m>k} B_m/A_m (1/p) / (1 - q/p).
+//
+// Each step only involves one stage's two poles, which design() guarantees
+// are distinct and separated from every other pole.
+struct StagePoles {
+  int count = 0;
+  int stage[ParallelBiquads::kSections];
+  cd p[ParallelBiquads::kSections][2];
+};
+
+void stagePoles(const Biquad* stages, int numStages, StagePoles& sp) {
+  sp.count = 0;
+  for (int s = 0; s < numStages; ++s) {
+    const Biquad& bq = stages[s];
+    if (bq.isIdentity()) continue;
+    const cd disc = std::sqrt(cd((double)bq.a1 * bq.a1 - 4.0 * bq.a2, 0.0));
+    sp.stage[sp.count] = s;
+    sp.p[sp.count][0] = 0.5 * (-(double)bq.a1 + disc);
+    sp.p[sp.count][1] = 0.5 * (-(double)bq.a1 - disc);
+    ++sp.count;
+  }
+}
+
+cd denominatorAt(const Biquad& s, cd w) {
+  return 1.0 + w * ((double)s.a1 + w * (double)s.a2);
+}
+
+cd stateAt(double z1, double z2, cd w) { return z1 + z2 * w; }
+
+// U_k(w): zero-input output of stages [0, k) for the given cascade states.
+cd upstreamAt(const Biquad* stages, const StagePoles& sp, const double* st, int k, cd w) {
+  cd u = 0.0;
+  for (int j = 0; j < k; ++j) {
+    const Biquad& bq = stages[sp.stage[j]];
+    u = (u * numeratorAt(bq, w) + stateAt(st[2 * j], st[2 * j + 1], w)) / denominatorAt(bq, w);
+  }
+  return u;
+}
+
+// prod_{m>k} B_m/A_m (1/p) / (1 - q/p) for pole e (0 or 1) of stage k.
+cd downstreamGain(const Biquad* stages, const StagePoles& sp, int k, int e) {
+  const cd w = 1.0 / sp.p[k][e];
+  cd g = 1.0 / (1.0 - sp.p[k][1 - e] * w);
+  for (int m = k + 1; m < sp.count; ++m) {
+    const Biquad& bq = stages[sp.stage[m]];
+    g *= numeratorAt(bq, w) / denominatorAt(bq, w);
+  }
+  return g;
+}
+
+} // namespace
+
+void ParallelBiquads::importState(const Biquad* stages, int numStages, int channel) {
+  StagePoles sp;
+  stagePoles(stages, numStages, sp);
+  const int off = channel * kSections;
+
+  double st[2 * kSections];
+  for (int k = 0; k < sp.count; ++k) {
+    st[2 * k] = stages[sp.stage[k]].z1;
+    st[2 * k + 1] = stages[sp.stage[k]].z2;
+  }
+
+  for (int k = 0; k < kSections; ++k) z1[off + k] = z2[off + k] = 0.0f;
+  for (int k = 0; k < sp.count; ++k) {
+    const Biquad& bq = stages[sp.stage[k]];
+    cd r[2];
+    for (int e = 0; e < 2; ++e) {
+      const cd w = 1.0 / sp.p[k][e];
+      const cd v = upstreamAt(stages, sp, st, k, w) * numeratorAt(bq, w) + stateAt(st[2 * k], st[2 * k + 1], w);
+      r[e] = v * downstreamGain(stages, sp, k, e);
+    }
+    // (z1 + z2 w) / A(w) = r0 / (1 - p0 w) + r1 / (1 - p1 w)
+    z1[off + sp.stage[k]] = (float)(r[0] + r[1]).real();
+    z2[off + sp.stage[k]] = (float)(-(r[0] * sp.p[k][1] + r[1] * sp.p[k][0])).real();
+  }
+}
+
+void ParallelBiquads::exportState(Biquad* stages, int numStages, int channel) const {
+  StagePoles sp;
+  stagePoles(stages, numStages, sp);
+  const int off = channel * kSections;
+
+  double st[2 * kSections];
+  for (int s = 0; s < numStages; ++s) stages[s].z1 = stages[s].z2 = 0.0f;
+  for (int k = 0; k < sp.count; ++k) {
+    const Biquad& bq = stages[sp.stage[k]];
+    const double s1 = z1[off + sp.stage[k]], s2 = z2[off + sp.stage[k]];
+    // Solve S_k(w) = z1 + z2 w at both poles so V_k reproduces the lane's
+    // residues; the earlier stages' states are already fixed.
+    cd w[2], sv[2];
+    for (int e = 0; e < 2; ++e) {
+      const cd p = sp.p[k][e], q = sp.p[k][1 - e];
+      w[e] = 1.0 / p;
+      const cd r = stateAt(s1, s2, w[e]) / (1.0 - q * w[e]);
+      const cd g = downstreamGain(stages, sp, k, e);
+      const cd v = std::abs(g) > 1.0e-12 ? r / g : cd(0.0);
+      sv[e] = v - upstreamAt(stages, sp, st, k, w[e]) * numeratorAt(bq, w[e]);
+    }
+    const cd zz2 = (sv[0] - sv[1]) / (w[0] - w[1]);
+    st[2 * k] = (sv[0] - zz2 * w[0]).real();
+    st[2 * k + 1] = zz2.real();
+    stages[sp.stage[k]].z1 = (float)st[2 * k];
+    stages[sp.stage[k]].z2 = (float)st[2 * k + 1];
+  }
+}
+
+bool ParallelBiquads::design(const Biquad* stages, int numStages) {
+  if (numStages > kSections) {
+    active = false;
+    return false;
+  }
+
+  int stageOf[2 * kSections];
+  cd poles[2 * kSections];
+  int numPoles = 0;
+  double c0 = 1.0;
+
+  for (int s = 0; s < numStages; ++s) {
+    const Biquad& bq = stages[s];
+    if (bq.isIdentity())
+      continue;
+    if (bq.a2 == 0.0f) { // first-order denominator: not expanded here
+      active = false;
+      return false;
+    }
+    // Poles: roots of z^2 + a1 z + a2.
+    const cd disc = std::sqrt(cd((double)bq.a1 * bq.a1 - 4.0 * bq.a2, 0.0));
+    poles[numPoles] = 0.5 * (-(double)bq.a1 + disc);
+    stageOf[numPoles++] = s;
+    poles[numPoles] = 0.5 * (-(double)bq.a1 - disc);
+    stageOf[numPoles++] = s;
+    c0 *= (double)bq.b2 / (double)bq.a2;
+  }
+  if (numPoles == 0) { // nothing to run in parallel
+    active = false;
+    return false;
+  }
+
+  // r_i = N(1/p_i) / prod_{j != i} (1 - p_j / p_i), in w = z^-1.
+  cd residue[2 * kSections];
+  for (int i = 0; i < numPoles; ++i) {
+    const cd w = 1.0 / poles[i];
+    cd num = 1.0;
+    for (int s = 0; s < numStages; ++s)
+      if (!stages[s].isIdentity())
+        num *= numeratorAt(stages[s], w);
+    cd den = 1.0;
+    for (int j = 0; j < numPoles; ++j) {
+      if (j == i) continue;
+      const cd f = 1.0 - poles[j] * w;
+      if (std::abs(f) < kMinPoleSeparation) {
+        active = false;
+        return false;
+      }
+      den *= f;
+    }
+    residue[i] = num / den;
+  }
+
+  float nb0[kSections] = {}, nb1[kSections] = {}, na1[kSections] = {}, na2[kSections] = {};
+  double gainSum = 0.0;
+  for (int i = 0; i < numPoles; i += 2) {
+    const int s = stageOf[i];
+    const cd r1 = residue[i], r2 = residue[i + 1];
+    const double sb0 = (r1 + r2).real();
+    const double sb1 = -(r1 * poles[i + 1] + r2 * poles[i]).real();
+    gainSum += sectionPeakGain(sb0, sb1, stages[s].a1, stages[s].a2, poles[i]);
+    if (gainSum > kMaxSectionGainSum) {
+      active = false;
+      return false;
+    }
+    nb0[s] = (float)sb0;
+    nb1[s] = (float)sb1;
+    na1[s] = stages[s].a1;
+    na2[s] = stages[s].a2;
+  }
+
+  for (int k = 0; k < kSections; ++k) {
+    b0[k] = b0[kSections + k] = nb0[k];
+    b1[k] = b1[kSections + k] = nb1[k];
+    a1[k] = a1[kSections + k] = na1[k];
+    a2[k] = a2[kSections + k] = na2[k];
+  }
+  direct = (float)c0;
+  active = true;
+  return true;
+}
+
+} // namespace SvenderBass::DSP
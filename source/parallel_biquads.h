@@ -0,0 +1,47 @@
+#pragma once
+#include "dsp.h"
+
+namespace SvenderBass::DSP {
+
+// Parallel (partial-fraction) form of a stereo biquad cascade:
+//
+//   H(z) = direct + sum_k (b0_k + b1_k z^-1) / (1 + a1_k z^-1 + a2_k z^-2)
+//
+// Each section keeps the poles of one cascade stage, so the sections are
+// independent and run side by side in SIMD lanes (left channel in lanes
+// [0, kSections), right in [kSections, kLanes)) instead of as a serial
+// chain. Lane k always belongs to cascade stage k; identity stages get zero
+// coefficients.
+struct ParallelBiquads {
+  static constexpr int kSections = 8;
+  static constexpr int kLanes = 2 * kSections;
+
+  alignas(64) float b0[kLanes] = {};
+  alignas(64) float b1[kLanes] = {};
+  alignas(64) float a1[kLanes] = {};
+  alignas(64) float a2[kLanes] = {};
+  alignas(64) float z1[kLanes] = {};
+  alignas(64) float z2[kLanes] = {};
+  float direct = 1.0f;
+  bool active = false;
+
+  void reset() {
+    for (int k = 0; k < kLanes; ++k) z1[k] = z2[k] = 0.0f;
+  }
+
+  // Expands numStages (<= kSections) stages; the lane state is left for
+  // importState. Returns false, and clears active, when every stage is an
+  // identity or the expansion would be badly conditioned in float
+  // (near-coincident poles across stages give large, cancelling residues);
+  // callers then keep running the cascade.
+  bool design(const Biquad* stages, int numStages);
+
+  // Hand-over between the two forms for one channel (0 = left, 1 = right),
+  // with the coefficients the lanes were designed from: the receiving
+  // side's state gets the same zero-input response, so a form switch is
+  // free of transients.
+  void importState(const Biquad* stages, int numStages, int channel);
+  void exportState(Biquad* stages, int numStages, int channel) const;
+};
+
+} // namespace SvenderBass::DSP
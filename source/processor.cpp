@@ -1,5 +1,9 @@
 #include "processor.h"
 #include "controller.h"
+#include "telemetry.h"
+
+#include <algorithm>
+#include <thread>
 
 using namespace Steinberg;
 using namespace Steinberg::Vst;
@@ -20,123 +24,92 @@ tresult PLUGIN_API Processor::initialize(FUnknown* context) {
   return kResultOk;
 }
 
+// The setup is stored by AudioEffect and applied on activation, where the
+// engine allocates its DSP state.
 tresult PLUGIN_API Processor::setupProcessing(ProcessSetup& setup) {
-  sampleRate_ = setup.sampleRate;
-
-  inGainSm_.setTimeMs((float)sampleRate_, 15.0f);
-  outGainSm_.setTimeMs((float)sampleRate_, 15.0f);
-  driveSm_.setTimeMs((float)sampleRate_, 25.0f);
-
-  inGainSm_.reset(1.0f);
-  outGainSm_.reset(1.0f);
-  driveSm_.reset(1.0f);
-
-  envL_.setTimeMs((float)sampleRate_, 30.0f);
-  envR_.setTimeMs((float)sampleRate_, 30.0f);
-  envL_.reset();
-  envR_.reset();
-  lastEnv_ = 0.0f;
-  sagEnv_.setTimesMs((float)sampleRate_, 15.0f, 220.0f);
-  sagEnv_.reset();
-
-  osL_.setSampleRate((float)sampleRate_);
-  osR_.setSampleRate((float)sampleRate_);
-
-  updateFilters();
   return AudioEffect::setupProcessing(setup);
 }
 
 tresult PLUGIN_API Processor::setActive(TBool state) {
   if (state) {
-    bassL_.reset(); bassR_.reset();
-    midL_.reset();  midR_.reset();
-    trebL_.reset(); trebR_.reset();
-    postLowL_.reset();  postLowR_.reset();
-    postHighL_.reset(); postHighR_.reset();
-    cabHpL_.reset(); cabHpR_.reset();
-    cabLpL_.reset(); cabLpR_.reset();
-    cabResL_.reset(); cabResR_.reset();
-    cabMidL_.reset(); cabMidR_.reset();
-    ultraLowL_.reset(); ultraLowR_.reset();
-    ultraLowCutL_.reset(); ultraLowCutR_.reset();
-    ultraHighL_.reset(); ultraHighR_.reset();
-    envL_.reset(); envR_.reset();
-    lastEnv_ = 0.0f;
-    sagEnv_.reset();
-    osL_.reset();
-    osR_.reset();
+    // Offline bounces run the chain's stages on separate cores; the output
+    // is the same as in real time.
+    engine_.setPipelined(processSetup.processMode == kOffline && std::thread::hardware_concurrency() > 1);
+    const bool fixedRate = fixedRate_.load();
+    if (engine_.sampleRate() != processSetup.sampleRate || engine_.maxBlockSize() != processSetup.maxSamplesPerBlock ||
+        engine_.fixedInternalRate() != fixedRate) {
+      engine_.setFixedInternalRate(fixedRate);
+      engine_.configure(processSetup.sampleRate, processSetup.maxSamplesPerBlock);
+    }
+    else
+      engine_.reset();
+    // Arming a track mid-performance must not cost a dropout on its first block.
+    engine_.warmUp();
   }
-  return AudioEffect::setActive(state);
-}
 
-static float midFreqFromSwitch(int pos) {
-  switch (pos) {
-    case 0: return 220.0f;
-    case 1: return 450.0f;
-    case 2: return 800.0f;
-    case 3: return 1600.0f;
-    default:return 3000.0f;
+  if (dataExchange_) {
+    if (state)
+      dataExchange_->onActivate(processSetup);
+    else
+      dataExchange_->onDeactivate();
   }
+  return AudioEffect::setActive(state);
 }
 
-void Processor::updateFilters() {
-  const float sr = (float)sampleRate_;
-  auto mapDb = [](float norm, float maxAbsDb) { return (norm * 2.0f - 1.0f) * maxAbsDb; };
-  auto mapDbAsym = [](float norm, float maxPosDb, float maxNegDb) {
-    if (norm >= 0.5f)
-      return ((norm - 0.5f) / 0.5f) * maxPosDb;
-    return ((norm - 0.5f) / 0.5f) * maxNegDb;
-  };
-
-  const float bassDb = mapDb(pBass_,   12.0f);
-  const float midDb  = mapDbAsym(pMid_,    10.0f, 20.0f);
-  const float treDb  = mapDbAsym(pTreble_, 15.0f, 20.0f);
-
-  bassL_.setLowShelf(sr, 40.0f, bassDb, 0.707f);
-  bassR_.setLowShelf(sr, 40.0f, bassDb, 0.707f);
-
-  float mf = midFreqFromSwitch(pMidFreq_);
-  midL_.setPeaking(sr, mf, midDb, 0.9f);
-  midR_.setPeaking(sr, mf, midDb, 0.9f);
-
-  trebL_.setHighShelf(sr, 4000.0f, treDb, 0.707f);
-  trebR_.setHighShelf(sr, 4000.0f, treDb, 0.707f);
+tresult PLUGIN_API Processor::connect(IConnectionPoint* other) {
+  tresult res = AudioEffect::connect(other);
+  if (res != kResultTrue) return res;
 
-  cabHpL_.setHP(sr, 55.0f, 0.707f);
-  cabHpR_.setHP(sr, 55.0f, 0.707f);
-  cabLpL_.setLP(sr, 5200.0f, 0.707f);
-  cabLpR_.setLP(sr, 5200.0f, 0.707f);
-
-  cabResL_.setPeaking(sr, 90.0f, 3.0f, 0.9f);
-  cabResR_.setPeaking(sr, 90.0f, 3.0f, 0.9f);
-  cabMidL_.setPeaking(sr, 750.0f, -2.5f, 1.1f);
-  cabMidR_.setPeaking(sr, 750.0f, -2.5f, 1.1f);
-
-  const float ulDb = pUltraLow_  ? +2.0f : 0.0f;
-  const float ulCutDb = pUltraLow_ ? -10.0f : 0.0f;
-  const float uhDb = pUltraHigh_ ? +9.0f : 0.0f;
+  auto configure = [](DataExchangeHandler::Config& config, const ProcessSetup&) {
+    config.blockSize = kTelemetryBlockSize;
+    config.numBlocks = kTelemetryNumBlocks;
+    config.alignment = 32;
+    config.userContextID = 0;
+    return true;
+  };
+  dataExchange_ = std::make_unique<DataExchangeHandler>(this, configure);
+  dataExchange_->onConnect(other, getHostContext());
+  return res;
+}
 
-  ultraLowL_.setLowShelf(sr, 40.0f, ulDb, 0.707f);
-  ultraLowR_.setLowShelf(sr, 40.0f, ulDb, 0.707f);
-  ultraLowCutL_.setPeaking(sr, 500.0f, ulCutDb, 0.9f);
-  ultraLowCutR_.setPeaking(sr, 500.0f, ulCutDb, 0.9f);
+tresult PLUGIN_API Processor::disconnect(IConnectionPoint* other) {
+  if (dataExchange_) {
+    dataExchange_->onDisconnect(other);
+    dataExchange_.reset();
+  }
+  return AudioEffect::disconnect(other);
+}
 
-  ultraHighL_.setHighShelf(sr, 8000.0f, uhDb, 0.707f);
-  ultraHighR_.setHighShelf(sr, 8000.0f, uhDb, 0.707f);
+tresult PLUGIN_API Processor::notify(IMessage* message) {
+  if (!message)
+    return kInvalidArgument;
 
+  if (FIDStringsEqual(message->getMessageID(), kAnalyzerMessageID)) {
+    int64 enabled = 0;
+    if (auto* attrs = message->getAttributes())
+      attrs->getInt(kAnalyzerEnabledAttr, enabled);
+    engine_.setAnalyzerEnabled(enabled != 0);
+    return kResultOk;
+  }
+  if (FIDStringsEqual(message->getMessageID(), kInternalRateMessageID)) {
+    int64 fixed = 0;
+    if (auto* attrs = message->getAttributes())
+      attrs->getInt(kInternalRateAttr, fixed);
+    fixedRate_.store(fixed != 0);
+    return kResultOk;
+  }
+  return AudioEffect::notify(message);
 }
 
 void Processor::applyParameterChanges(IParameterChanges* changes) {
   if (!changes) return;
 
   int32 count = changes->getParameterCount();
-  bool needFilterUpdate = false;
 
   for (int32 i = 0; i < count; ++i) {
     IParamValueQueue* q = changes->getParameterData(i);
     if (!q) continue;
 
-    Steinberg::Vst::ParamID pid = q->getParameterId();
     int32 points = q->getPointCount();
     if (points <= 0) continue;
 
@@ -144,23 +117,11 @@ void Processor::applyParameterChanges(IParameterChanges* changes) {
     ParamValue value = 0.0;
     if (q->getPoint(points - 1, sampleOffset, value) != kResultOk) continue;
 
-    float v = (float)value;
-
-    switch (pid) {
-      case kParamInputGain: pInputGain_ = v; break;
-      case kParamBass:      pBass_      = v; needFilterUpdate = true; break;
-      case kParamMid:       pMid_       = v; needFilterUpdate = true; break;
-      case kParamTreble:    pTreble_    = v; needFilterUpdate = true; break;
-      case kParamMidFreq:   pMidFreq_   = (int)std::lround(v * 4.0f); needFilterUpdate = true; break;
-      case kParamDrive:     pDrive_     = v; break;
-      case kParamOutput:    pOutput_    = v; break;
-      case kParamUltraLow:  pUltraLow_  = (v >= 0.5f); needFilterUpdate = true; break;
-      case kParamUltraHigh: pUltraHigh_ = (v >= 0.5f); needFilterUpdate = true; break;
-      default: break;
-    }
+    if (q->getParameterId() == kParamInternalRate)
+      fixedRate_.store(value >= 0.5);
+    else
+      engine_.setParam((int)q->getParameterId(), value);
   }
-
-  if (needFilterUpdate) updateFilters();
 }
 
 tresult PLUGIN_API Processor::process(ProcessData& data) {
@@ -174,95 +135,92 @@ tresult PLUGIN_API Processor::process(ProcessData& data) {
   float** out = data.outputs[0].channelBuffers32;
   if (!in || !out) return kResultOk;
 
-  float inDb  = (pInputGain_ * 2.0f - 1.0f) * 24.0f;
-  float outDb = (pOutput_    * 2.0f - 1.0f) * 24.0f;
-  float inLinTarget  = DSP::dbToLin(inDb);
-  float outLinTarget = DSP::dbToLin(outDb);
+  engine_.process(in[0], in[1], out[0], out[1], data.numSamples);
+  writeTunerOutputs(data.outputParameterChanges);
+  sendTelemetry();
+  return kResultOk;
+}
+
+// Only the fixed internal rate adds any: the resamplers' delay. Reported for
+// the pending setting, which the next activation applies, so a host that
+// asks right after the controller's kLatencyChanged restart gets the new
+// value.
+uint32 PLUGIN_API Processor::getLatencySamples() {
+  return (uint32)Engine::latencyFor(processSetup.sampleRate, fixedRate_.load());
+}
 
-  float driveTarget = 1.0f + pDrive_ * 19.0f;
+// Newest tuner reading -> the read-only note/cents parameters, so the host
+// and controller see it like any other parameter change.
+void Processor::writeTunerOutputs(IParameterChanges* changes) {
+  svender_dsp_tuner t;
+  if (!engine_.popTuner(t) || !changes)
+    return;
+
+  const bool pitched = t.frequency_hz > 0.0f;
+  if (!pitched && !tunerShown_)
+    return;
+  tunerShown_ = pitched;
+
+  const ParamValue note = pitched ? std::clamp(t.note, 0, 127) / 127.0 : 0.0;
+  const ParamValue cents = pitched ? std::clamp((t.cents + 50.0) / 100.0, 0.0, 1.0) : 0.5;
+
+  int32 index = 0;
+  if (IParamValueQueue* q = changes->addParameterData(kParamTunerNote, index))
+    q->addPoint(0, note, index);
+  if (IParamValueQueue* q = changes->addParameterData(kParamTunerCents, index))
+    q->addPoint(0, cents, index);
+}
 
-  float envForDrive = DSP::clamp(lastEnv_ * 3.0f, 0.0f, 1.0f);
-  float dynamicDrive = 1.0f + 8.0f * envForDrive;
-  float driveEffectiveTarget = driveTarget * dynamicDrive;
+// Moves any meter frames the engine published during this block, and the
+// newest spectrum frame, into data-exchange blocks. Frames are dropped, never
+// waited on, when the host has no free block.
+void Processor::sendTelemetry() {
+  sendMeters();
+  sendSpectrum();
+}
 
-  float driveNorm = DSP::clamp((driveEffectiveTarget - 1.0f) / 12.0f, 0.0f, 1.0f);
-  float lowTightenDb = -3.0f * driveNorm;
-  float highSoftenDb = -4.0f * driveNorm;
+void Processor::sendMeters() {
+  svender_dsp_meters first;
+  if (!engine_.popMeters(first))
+    return;
+
+  DataExchangeBlock block = dataExchange_ ? dataExchange_->getCurrentOrNewBlock()
+                                          : DataExchangeBlock{nullptr, 0, InvalidDataExchangeBlockID};
+  if (block.blockID == InvalidDataExchangeBlockID || !block.data) {
+    svender_dsp_meters m;
+    while (engine_.popMeters(m)) {}
+    return;
+  }
 
-  postLowL_.setLowShelf((float)sampleRate_, 40.0f, lowTightenDb, 0.707f);
-  postLowR_.setLowShelf((float)sampleRate_, 40.0f, lowTightenDb, 0.707f);
-  postHighL_.setHighShelf((float)sampleRate_, 4000.0f, highSoftenDb, 0.707f);
-  postHighR_.setHighShelf((float)sampleRate_, 4000.0f, highSoftenDb, 0.707f);
+  auto* header = static_cast<TelemetryHeader*>(block.data);
+  auto* frames = reinterpret_cast<svender_dsp_meters*>(header + 1);
+  uint32 count = 0;
+  frames[count++] = first;
+  while (count < kTelemetryMaxMeterFrames && engine_.popMeters(frames[count]))
+    ++count;
 
-  float envSum = 0.0f;
+  header->kind = kTelemetryMeters;
+  header->count = count;
+  dataExchange_->sendCurrentBlock();
+}
 
-  auto satProcess = [](float x, DSP::Oversampler4x& os, float drive) {
-    float up[4] = {};
-    os.upsample(x, up);
-    for (int i = 0; i < 4; ++i)
-      up[i] = DSP::tubeSatMulti(up[i], drive);
-    return os.downsample(up);
-  };
+void Processor::sendSpectrum() {
+  if (!dataExchange_ || !engine_.analyzerEnabled())
+    return;
 
-  for (int32 n = 0; n < data.numSamples; ++n) {
-    float inG  = inGainSm_.process(inLinTarget);
-    float outG = outGainSm_.process(outLinTarget);
-    float drv  = driveSm_.process(driveEffectiveTarget);
-
-    float xL = in[0][n] * inG;
-    float xR = in[1][n] * inG;
-
-    xL = ultraLowL_.process(xL);
-    xL = ultraLowCutL_.process(xL);
-    xL = ultraHighL_.process(xL);
-
-    xL = bassL_.process(xL);
-    xL = midL_.process(xL);
-    xL = trebL_.process(xL);
-
-    xR = ultraLowR_.process(xR);
-    xR = ultraLowCutR_.process(xR);
-    xR = ultraHighR_.process(xR);
-
-    xR = bassR_.process(xR);
-    xR = midR_.process(xR);
-    xR = trebR_.process(xR);
-
-    float eL = envL_.process(xL);
-    float eR = envR_.process(xR);
-    envSum += 0.5f * (eL + eR);
-
-    float sagIn = 0.5f * (std::fabs(xL) + std::fabs(xR));
-    float sag = sagEnv_.process(sagIn);
-    float sagCtrl = DSP::clamp(sag * 2.5f, 0.0f, 1.0f);
-    float sagDrive = 1.0f - 0.35f * sagCtrl;
-    float sagGain = 1.0f - 0.20f * sagCtrl;
-
-    xL = satProcess(xL, osL_, drv * sagDrive);
-    xR = satProcess(xR, osR_, drv * sagDrive);
-    xL *= sagGain;
-    xR *= sagGain;
-
-    xL = postLowL_.process(xL);
-    xL = postHighL_.process(xL);
-    xR = postLowR_.process(xR);
-    xR = postHighR_.process(xR);
-
-    xL = cabHpL_.process(xL);
-    xL = cabResL_.process(xL);
-    xL = cabMidL_.process(xL);
-    xL = cabLpL_.process(xL);
-    xR = cabHpR_.process(xR);
-    xR = cabResR_.process(xR);
-    xR = cabMidR_.process(xR);
-    xR = cabLpR_.process(xR);
-
-    out[0][n] = xL * outG;
-    out[1][n] = xR * outG;
-  }
+  svender_dsp_spectrum spectrum;
+  if (!engine_.popSpectrum(spectrum))
+    return;
 
-  lastEnv_ = envSum / (float)std::max<int32>(1, data.numSamples);
-  return kResultOk;
+  DataExchangeBlock block = dataExchange_->getCurrentOrNewBlock();
+  if (block.blockID == InvalidDataExchangeBlockID || !block.data)
+    return;
+
+  auto* header = static_cast<TelemetryHeader*>(block.data);
+  *reinterpret_cast<svender_dsp_spectrum*>(header + 1) = spectrum;
+  header->kind = kTelemetrySpectrum;
+  header->count = 1;
+  dataExchange_->sendCurrentBlock();
 }
 
 } // namespace SvenderBass
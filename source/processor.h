@@ -1,8 +1,12 @@
 #pragma once
 #include "public.sdk/source/vst/vstaudioeffect.h"
 #include "pluginterfaces/vst/ivstparameterchanges.h"
+#include "public.sdk/source/vst/utility/dataexchange.h"
 #include "ids.h"
-#include "dsp.h"
+#include "engine.h"
+
+#include <atomic>
+#include <memory>
 
 namespace SvenderBass {
 
@@ -15,47 +19,27 @@ public:
   Steinberg::tresult PLUGIN_API setActive(Steinberg::TBool state) override;
   Steinberg::tresult PLUGIN_API setupProcessing(Steinberg::Vst::ProcessSetup& setup) override;
   Steinberg::tresult PLUGIN_API process(Steinberg::Vst::ProcessData& data) override;
+  Steinberg::uint32 PLUGIN_API getLatencySamples() override;
+
+  Steinberg::tresult PLUGIN_API connect(Steinberg::Vst::IConnectionPoint* other) override;
+  Steinberg::tresult PLUGIN_API disconnect(Steinberg::Vst::IConnectionPoint* other) override;
+  Steinberg::tresult PLUGIN_API notify(Steinberg::Vst::IMessage* message) override;
 
 private:
   void applyParameterChanges(Steinberg::Vst::IParameterChanges* changes);
-  void updateFilters();
-
-  double sampleRate_ = 44100.0;
-
-  float pInputGain_ = 0.5f;
-  float pBass_      = 0.5f;
-  float pMid_       = 0.5f;
-  float pTreble_    = 0.5f;
-  int   pMidFreq_   = 2;
-  float pDrive_     = 0.3f;
-  float pOutput_    = 0.7f;
-  bool pUltraLow_ = false;
-  bool pUltraHigh_ = false;
-
-
-  DSP::Smoother inGainSm_, outGainSm_, driveSm_;
-  DSP::EnvelopeFollower envL_, envR_;
-  DSP::AttackReleaseEnvelope sagEnv_;
-  float lastEnv_ = 0.0f;
-
-  DSP::Biquad bassL_, bassR_;
-  DSP::Biquad midL_, midR_;
-  DSP::Biquad trebL_, trebR_;
-
-  DSP::Biquad postLowL_, postLowR_;
-  DSP::Biquad postHighL_, postHighR_;
-
-  DSP::Biquad cabHpL_, cabHpR_;
-  DSP::Biquad cabLpL_, cabLpR_;
-  DSP::Biquad cabResL_, cabResR_;
-  DSP::Biquad cabMidL_, cabMidR_;
-
-  DSP::Biquad ultraLowL_, ultraLowR_;
-  DSP::Biquad ultraLowCutL_, ultraLowCutR_;
-  DSP::Biquad ultraHighL_, ultraHighR_;
-
-  DSP::Oversampler4x osL_, osR_;
-
+  void sendTelemetry();
+  void sendMeters();
+  void sendSpectrum();
+  void writeTunerOutputs(Steinberg::Vst::IParameterChanges* changes);
+
+  Engine engine_;
+  bool tunerShown_ = false; // last written outputs were a live reading
+  // kParamInternalRate, applied on activation. Set from notify() on the
+  // message thread and from process() on the audio thread.
+  std::atomic<bool> fixedRate_ { false };
+
+  // Meter and spectrum frames to the controller (telemetry.h). Null until connected.
+  std::unique_ptr<Steinberg::Vst::DataExchangeHandler> dataExchange_;
 };
 
 } // namespace SvenderBass
@@ -0,0 +1,217 @@
+#include "resampler.h"
+#include "dsp.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace SvenderBass::DSP {
+
+// Zeroth-order modified Bessel function, for the Kaiser window.
+static double besselI0(double x) {
+  double sum = 1.0, term = 1.0;
+  for (int k = 1; k < 64 && term > sum * 1e-12; ++k) {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+  }
+  return sum;
+}
+
+// Kaiser's estimate of the length; halfband lengths are 4K - 1.
+int Halfband::branchLength(double passband, double rejectionDb) {
+  const double transition = 0.5 - 2.0 * passband;
+  const int length = (int)std::ceil((rejectionDb - 7.95) / (14.36 * transition)) + 1;
+  return 2 * std::clamp((length + 4) / 4, 1, kMaxBranch / 2);
+}
+
+void Halfband::design(double passband, double rejectionDb) {
+  branch = branchLength(passband, rejectionDb);
+  const int k = branch / 2;
+  padded = (branch + 7) & ~7;
+  std::fill(taps, taps + kMaxBranch, 0.0f);
+
+  const double beta = 0.1102 * (rejectionDb - 8.7);
+  const double centre = 2 * k - 1;
+  double sum = 0.0;
+  for (int j = 0; j < branch; ++j) {
+    const double n = 2 * j - centre; // odd offsets from the centre tap
+    const double r = n / (centre + 1.0);
+    const double w = besselI0(beta * std::sqrt(1.0 - r * r)) / besselI0(beta);
+    const double h = std::sin(kPiD * n / 2.0) / (kPiD * n) * w;
+    taps[j] = (float)h;
+    sum += h;
+  }
+  // The branch and the centre tap each pass half of DC.
+  for (int j = 0; j < branch; ++j)
+    taps[j] = (float)(taps[j] * 0.5 / sum);
+}
+
+// Doubled ring: the newest len samples are always contiguous at [pos, pos + len).
+static inline void push(float* ring, int& pos, int len, float x) {
+  pos = (pos == 0 ? len : pos) - 1;
+  ring[pos] = ring[pos + len] = x;
+}
+
+// Eight partial sums, so the compiler keeps them in one vector register.
+// len is a multiple of 8; taps past the branch are zero.
+static inline float dot(const float* taps, const float* x, int len) {
+  float acc[8] = {};
+  for (int j = 0; j < len; j += 8)
+    for (int k = 0; k < 8; ++k)
+      acc[k] += taps[j + k] * x[j + k];
+  return ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+}
+
+void HalfbandDecimator::reset() {
+  std::memset(odd, 0, sizeof(odd));
+  std::memset(even, 0, sizeof(even));
+  pos = 0;
+  held = 0.0f;
+  holding = false;
+}
+
+int HalfbandDecimator::process(const float* in, int n, float* out) {
+  const int len = fir->branch;
+  const int centre = len / 2 - 1;
+  int m = 0;
+  for (int i = 0; i < n; ++i) {
+    if (!holding) {
+      held = in[i];
+      holding = true;
+      continue;
+    }
+    holding = false;
+    int evenPos = pos;
+    push(even, evenPos, len, held);
+    push(odd, pos, len, in[i]);
+    out[m++] = dot(fir->taps, odd + pos, fir->padded) + 0.5f * even[pos + centre];
+  }
+  return m;
+}
+
+void HalfbandInterpolator::reset() {
+  std::memset(hist, 0, sizeof(hist));
+  pos = 0;
+}
+
+void HalfbandInterpolator::process(const float* in, int n, float* out) {
+  const int len = fir->branch;
+  const int centre = len / 2 - 1;
+  for (int i = 0; i < n; ++i) {
+    push(hist, pos, len, in[i]);
+    out[2 * i] = 2.0f * dot(fir->taps, hist + pos, fir->padded);
+    out[2 * i + 1] = hist[pos + centre];
+  }
+}
+
+// Passband of stage s (0 at the host rate) in a cascade of the given length.
+static double stagePassband(int stages, int s) {
+  return 0.21 / (1 << (stages - 1 - s));
+}
+
+int RateConverter::latencyFor(int stages) {
+  stages = std::clamp(stages, 0, kMaxStages);
+  int latency = 0;
+  for (int s = 0; s < stages; ++s)
+    latency += (1 << s) * (2 * Halfband::branchLength(stagePassband(stages, s)) - 2);
+  return latency;
+}
+
+void RateConverter::configure(int stages, int maxBlockSize) {
+  stages_ = std::clamp(stages, 0, kMaxStages);
+  const int f = factor();
+
+  // Stage 0 runs at the host rate, stage stages_ - 1 next to the internal one.
+  for (int s = 0; s < stages_; ++s)
+    fir_[s].design(stagePassband(stages_, s));
+  latency_ = latencyFor(stages_);
+  for (int ch = 0; ch < kChannels; ++ch) {
+    for (int s = 0; s < stages_; ++s) {
+      dec_[ch][s].fir = &fir_[s];
+      interp_[ch][s].fir = &fir_[s];
+    }
+    internal_[ch].assign(maxBlockSize / 2 + 1, 0.0f); // decimated in place
+    queue_[ch].assign(maxBlockSize + 2 * f, 0.0f);
+  }
+  for (auto& w : work_)
+    w.assign(maxBlockSize + 2 * f, 0.0f);
+  reset();
+}
+
+void RateConverter::reset() {
+  for (int ch = 0; ch < kChannels; ++ch) {
+    for (int s = 0; s < stages_; ++s) {
+      dec_[ch][s].reset();
+      interp_[ch][s].reset();
+    }
+    // Primed so that every up() has its n samples: the internal count of a
+    // call can fall short of n / factor by a fraction.
+    std::fill(queue_[ch].begin(), queue_[ch].end(), 0.0f);
+    queued_[ch] = factor() - 1;
+  }
+}
+
+int RateConverter::down(int ch, const float* in, int n) {
+  float* x = internal_[ch].data();
+  int len = n;
+  for (int s = 0; s < stages_; ++s)
+    len = dec_[ch][s].process(s == 0 ? in : x, len, x);
+  return len;
+}
+
+void RateConverter::up(int ch, int m, float* out, int n) {
+  float* q = queue_[ch].data();
+  const float* x = internal_[ch].data();
+  int len = m;
+  for (int s = stages_ - 1; s >= 0; --s) {
+    float* y = s == 0 ? q + queued_[ch] : work_[s & 1].data();
+    interp_[ch][s].process(x, len, y);
+    x = y;
+    len *= 2;
+  }
+  const int avail = queued_[ch] + len;
+  std::copy(q, q + n, out);
+  std::copy(q + n, q + avail, q);
+  queued_[ch] = avail - n;
+}
+
+// Raw copies of the decimators and interpolators, their filter pointers
+// re-aimed at this converter's own stages on the way back.
+size_t RateConverter::stateSize() const {
+  size_t size = sizeof(dec_) + sizeof(interp_) + sizeof(queued_);
+  for (const auto& q : queue_)
+    size += q.size() * sizeof(float);
+  return size;
+}
+
+void RateConverter::saveState(unsigned char* dst) const {
+  auto put = [&](const void* p, size_t n) {
+    std::memcpy(dst, p, n);
+    dst += n;
+  };
+  put(dec_, sizeof(dec_));
+  put(interp_, sizeof(interp_));
+  put(queued_, sizeof(queued_));
+  for (const auto& q : queue_)
+    put(q.data(), q.size() * sizeof(float));
+}
+
+void RateConverter::restoreState(const unsigned char* src) {
+  auto get = [&](void* p, size_t n) {
+    std::memcpy(p, src, n);
+    src += n;
+  };
+  get(dec_, sizeof(dec_));
+  get(interp_, sizeof(interp_));
+  get(queued_, sizeof(queued_));
+  for (auto& q : queue_)
+    get(q.data(), q.size() * sizeof(float));
+  for (int ch = 0; ch < kChannels; ++ch) {
+    for (int s = 0; s < kMaxStages; ++s) {
+      dec_[ch][s].fir = s < stages_ ? &fir_[s] : nullptr;
+      interp_[ch][s].fir = s < stages_ ? &fir_[s] : nullptr;
+    }
+  }
+}
+
+} // namespace SvenderBass::DSP
@@ -0,0 +1,98 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace SvenderBass::DSP {
+
+// Linear-phase halfband lowpass for 2:1 rate changes, run in polyphase
+// form. Every other tap of a halfband filter is zero except the centre one
+// (0.5), so each direction costs one branch of 2K symmetric taps per
+// low-rate sample plus a plain delay. Kaiser-windowed sinc.
+struct Halfband {
+  static constexpr int kMaxBranch = 64;
+
+  int branch = 0; // 2K
+  int padded = 0; // branch rounded up to 8, zero taps past it
+  alignas(32) float taps[kMaxBranch] = {};
+
+  // passband: edge as a fraction of the high rate, below 0.25; the
+  // stopband starts at 0.5 - passband.
+  void design(double passband, double rejectionDb = 100.0);
+  // The branch length design() picks for the same arguments.
+  static int branchLength(double passband, double rejectionDb = 100.0);
+};
+
+// High rate in, half rate out. Takes any number of samples per call; an odd
+// one waits for its partner.
+struct HalfbandDecimator {
+  const Halfband* fir = nullptr;
+  float odd[2 * Halfband::kMaxBranch];  // odd-phase history, doubled ring
+  float even[2 * Halfband::kMaxBranch]; // even phase, for the centre tap
+  int pos = 0;
+  float held = 0.0f;
+  bool holding = false;
+
+  void reset();
+  // Returns the number of samples written. out may alias in.
+  int process(const float* in, int n, float* out);
+};
+
+// Half rate in, two samples out per input.
+struct HalfbandInterpolator {
+  const Halfband* fir = nullptr;
+  float hist[2 * Halfband::kMaxBranch];
+  int pos = 0;
+
+  void reset();
+  void process(const float* in, int n, float* out);
+};
+
+// Power-of-two rate conversion around a block process: the host rate down
+// to an internal rate through cascaded halfband decimators, and back up
+// through the mirrored interpolators. The stage next to the internal rate
+// keeps its band flat to 0.42 of that rate and rejects ~100 dB from the
+// internal Nyquist frequency up; earlier stages only guard what folds into
+// that band and are short. Every up() call returns exactly as many samples
+// as the matching down() call took, so a few samples are queued, and the
+// output lags the input by latency() host samples, a whole number.
+class RateConverter {
+public:
+  static constexpr int kMaxStages = 3;
+  static constexpr int kChannels = 2;
+
+  // Factor 2^stages, host blocks up to maxBlockSize. Not real-time safe.
+  void configure(int stages, int maxBlockSize);
+  void reset();
+
+  int factor() const { return 1 << stages_; }
+  int latency() const { return latency_; }
+  // latency() after configure(stages), without configuring.
+  static int latencyFor(int stages);
+
+  // Internal-rate buffer of one channel: down() writes it, up() reads it.
+  float* internal(int ch) { return internal_[ch].data(); }
+
+  // n host samples into internal(ch); returns the internal sample count.
+  int down(int ch, const float* in, int n);
+  // m internal samples from internal(ch) back to exactly n host samples.
+  void up(int ch, int m, float* out, int n);
+
+  // Filter histories and queued samples, for Engine checkpoints. Both sides
+  // must have the same configuration.
+  size_t stateSize() const;
+  void saveState(unsigned char* dst) const;
+  void restoreState(const unsigned char* src);
+
+private:
+  int stages_ = 0;
+  int latency_ = 0;
+  Halfband fir_[kMaxStages];
+  HalfbandDecimator dec_[kChannels][kMaxStages];
+  HalfbandInterpolator interp_[kChannels][kMaxStages];
+  std::vector<float> internal_[kChannels];
+  std::vector<float> queue_[kChannels];
+  int queued_[kChannels] = {};
+  std::vector<float> work_[2]; // intermediate rates on the way up
+};
+
+} // namespace SvenderBass::DSP
@@ -0,0 +1,44 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace SvenderBass::DSP {
+
+// Wait-free single-producer / single-consumer ring of trivially copyable
+// items. The audio thread is the producer; push() never blocks and drops the
+// item when the consumer has fallen behind. Capacity must be a power of two.
+template <class T, size_t Capacity>
+class SpscRing {
+  static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+  static_assert(std::is_trivially_copyable<T>::value, "items are copied by value");
+
+public:
+  bool push(const T& item) {
+    const size_t w = write_.load(std::memory_order_relaxed);
+    if (w - read_.load(std::memory_order_acquire) == Capacity)
+      return false;
+    items_[w & (Capacity - 1)] = item;
+    write_.store(w + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(T& item) {
+    const size_t r = read_.load(std::memory_order_relaxed);
+    if (r == write_.load(std::memory_order_acquire))
+      return false;
+    item = items_[r & (Capacity - 1)];
+    read_.store(r + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side: discards everything currently queued.
+  void clear() { read_.store(write_.load(std::memory_order_acquire), std::memory_order_release); }
+
+private:
+  alignas(64) std::atomic<size_t> write_ {0};
+  alignas(64) std::atomic<size_t> read_ {0};
+  alignas(64) T items_[Capacity];
+};
+
+} // namespace SvenderBass::DSP
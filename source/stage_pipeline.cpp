@@ -0,0 +1,101 @@
+#include "stage_pipeline.h"
+
+namespace SvenderBass {
+
+StagePipeline::~StagePipeline() {
+  stop();
+}
+
+void StagePipeline::start() {
+  if (running())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    quit_ = false;
+  }
+  for (int s = 1; s < kMaxStages; ++s)
+    workers_.emplace_back([this, s] { worker(s); });
+}
+
+void StagePipeline::stop() {
+  if (!running())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    quit_ = true;
+  }
+  cv_.notify_all();
+  for (auto& w : workers_)
+    w.join();
+  workers_.clear();
+}
+
+void StagePipeline::run(StageFn fn, void* ctx, const unsigned* deps, int numStages, const int* edges,
+                        int numChunks) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    job_ = Job { fn, ctx, deps, numStages, edges, numChunks };
+    for (auto& p : progress_)
+      p.chunks.store(0, std::memory_order_relaxed);
+    pending_.store((int)workers_.size(), std::memory_order_relaxed);
+    ++generation_;
+  }
+  cv_.notify_all();
+
+  runStage(0);
+  await([this] { return pending_.load(std::memory_order_seq_cst) == 0; });
+}
+
+void StagePipeline::worker(int stage) {
+  uint64_t seen = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [&] { return quit_ || generation_ != seen; });
+      if (quit_)
+        return;
+      seen = generation_;
+    }
+    runStage(stage);
+    pending_.fetch_sub(1, std::memory_order_seq_cst);
+    signal();
+  }
+}
+
+void StagePipeline::runStage(int stage) {
+  if (stage >= job_.numStages)
+    return;
+  const unsigned deps = job_.deps[stage];
+  for (int c = 0; c < job_.numChunks; ++c) {
+    for (int d = 0; d < kMaxStages; ++d)
+      if (deps & (1u << d))
+        await([&] { return progress_[d].chunks.load(std::memory_order_seq_cst) > c; });
+    job_.fn(job_.ctx, stage, job_.edges[c], job_.edges[c + 1]);
+    progress_[stage].chunks.store(c + 1, std::memory_order_seq_cst);
+    signal();
+  }
+}
+
+// A chunk takes tens of microseconds, so a short spin usually finds it done;
+// past that the waiter sleeps until the next signal().
+template <class Ready>
+void StagePipeline::await(Ready&& ready) {
+  for (int i = 0; i < 64; ++i) {
+    if (ready())
+      return;
+    std::this_thread::yield();
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  sleepers_.fetch_add(1, std::memory_order_seq_cst);
+  cv_.wait(lock, ready);
+  sleepers_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void StagePipeline::signal() {
+  if (sleepers_.load(std::memory_order_seq_cst) == 0)
+    return;
+  std::lock_guard<std::mutex> lock(mutex_);
+  cv_.notify_all();
+}
+
+} // namespace SvenderBass
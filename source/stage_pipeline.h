@@ -0,0 +1,71 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace SvenderBass {
+
+// Runs the stages of a processing chain concurrently over one buffer, each
+// on its own thread. A job is cut into chunks; stage s starts chunk c once
+// every stage it depends on has finished c, so each stage trails the ones
+// before it by a chunk and sees exactly the data the serial chain would.
+// Waits spin briefly, then block; meant for offline rendering, not for the
+// real-time path.
+class StagePipeline {
+public:
+  static constexpr int kMaxStages = 4;
+
+  // Processes [begin, end) of the current job for one stage.
+  using StageFn = void (*)(void* ctx, int stage, int begin, int end);
+
+  StagePipeline() = default;
+  ~StagePipeline();
+  StagePipeline(const StagePipeline&) = delete;
+  StagePipeline& operator=(const StagePipeline&) = delete;
+
+  // Not real-time safe: starts or joins the workers (one per stage after
+  // the first).
+  void start();
+  void stop();
+  bool running() const { return !workers_.empty(); }
+
+  // Runs stages [0, numStages) over the chunks [edges[c], edges[c + 1]) and
+  // returns once all of them are done. deps[s] is a bit mask of the stages
+  // stage s reads from. Stage 0 runs on the calling thread.
+  void run(StageFn fn, void* ctx, const unsigned* deps, int numStages, const int* edges, int numChunks);
+
+private:
+  void worker(int stage);
+  void runStage(int stage);
+  template <class Ready>
+  void await(Ready&& ready);
+  void signal();
+
+  struct Job {
+    StageFn fn = nullptr;
+    void* ctx = nullptr;
+    const unsigned* deps = nullptr;
+    int numStages = 0;
+    const int* edges = nullptr;
+    int numChunks = 0;
+  } job_;
+
+  // Chunks finished per stage.
+  struct alignas(64) Progress {
+    std::atomic<int> chunks {0};
+  };
+  Progress progress_[kMaxStages];
+  alignas(64) std::atomic<int> pending_ {0}; // workers still in the job
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::atomic<int> sleepers_ {0};
+  uint64_t generation_ = 0; // bumped per job, under mutex_
+  bool quit_ = false;
+  std::vector<std::thread> workers_;
+};
+
+} // namespace SvenderBass
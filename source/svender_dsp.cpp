@@ -0,0 +1,194 @@
+#include "svender_dsp.h"
+#include "engine.h"
+
+#include <algorithm>
+#include <exception>
+#include <new>
+#include <vector>
+
+using SvenderBass::Engine;
+
+struct svender_dsp {
+  Engine engine;
+  std::vector<float> scratch; // 2 * max block: deinterleave
+  bool configured = false;
+};
+
+namespace {
+
+bool validLayout(int numChannels, int numFrames) {
+  return (numChannels == 1 || numChannels == 2) && numFrames >= 0;
+}
+
+} // namespace
+
+extern "C" {
+
+unsigned svender_dsp_api_version(void) { return SVENDER_DSP_API_VERSION; }
+
+svender_dsp* svender_dsp_create(void) {
+  return new (std::nothrow) svender_dsp();
+}
+
+void svender_dsp_destroy(svender_dsp* fx) {
+  delete fx;
+}
+
+int svender_dsp_configure(svender_dsp* fx, double sample_rate, int max_block_size) {
+  if (!fx || !(sample_rate > 0.0) || max_block_size <= 0)
+    return SVENDER_DSP_ERR_ARGUMENT;
+  try {
+    fx->scratch.assign((size_t)max_block_size * 2, 0.0f);
+    fx->engine.configure(sample_rate, max_block_size);
+  } catch (const std::exception&) { // buffers or the tuner thread
+    fx->configured = false;
+    return SVENDER_DSP_ERR_OUT_OF_MEMORY;
+  }
+  fx->configured = true;
+  return SVENDER_DSP_OK;
+}
+
+int svender_dsp_reset(svender_dsp* fx) {
+  if (!fx) return SVENDER_DSP_ERR_ARGUMENT;
+  if (!fx->configured) return SVENDER_DSP_ERR_NOT_READY;
+  fx->engine.reset();
+  return SVENDER_DSP_OK;
+}
+
+int svender_dsp_set_param(svender_dsp* fx, int param, double normalized) {
+  if (!fx || param < 0 || param >= SVENDER_PARAM_COUNT || !(normalized == normalized))
+    return SVENDER_DSP_ERR_ARGUMENT;
+  fx->engine.setParam(param, normalized);
+  return SVENDER_DSP_OK;
+}
+
+double svender_dsp_get_param(const svender_dsp* fx, int param) {
+  if (!fx) return 0.0;
+  return fx->engine.getParam(param);
+}
+
+int svender_dsp_process_block(svender_dsp* fx, const float* const* in, float* const* out,
+                              int num_channels, int num_frames) {
+  if (!fx || !in || !out || !validLayout(num_channels, num_frames))
+    return SVENDER_DSP_ERR_ARGUMENT;
+  for (int c = 0; c < num_channels; ++c)
+    if (!in[c] || !out[c]) return SVENDER_DSP_ERR_ARGUMENT;
+  if (!fx->configured) return SVENDER_DSP_ERR_NOT_READY;
+
+  const int maxBlock = fx->engine.maxBlockSize();
+
+  for (int n = 0; n < num_frames; n += maxBlock) {
+    const int len = std::min(maxBlock, num_frames - n);
+    if (num_channels == 2)
+      fx->engine.process(in[0] + n, in[1] + n, out[0] + n, out[1] + n, len);
+    else
+      fx->engine.processMono(in[0] + n, out[0] + n, len);
+  }
+  return SVENDER_DSP_OK;
+}
+
+int svender_dsp_process_interleaved(svender_dsp* fx, const float* in, float* out,
+                                    int num_channels, int num_frames) {
+  if (!fx || !in || !out || !validLayout(num_channels, num_frames))
+    return SVENDER_DSP_ERR_ARGUMENT;
+  if (!fx->configured) return SVENDER_DSP_ERR_NOT_READY;
+
+  const int maxBlock = fx->engine.maxBlockSize();
+  float* l = fx->scratch.data();
+  float* r = l + maxBlock;
+
+  for (int n = 0; n < num_frames; n += maxBlock) {
+    const int len = std::min(maxBlock, num_frames - n);
+    const float* src = in + (size_t)n * num_channels;
+    float* dst = out + (size_t)n * num_channels;
+
+    if (num_channels == 2) {
+      for (int i = 0; i < len; ++i) { l[i] = src[2 * i]; r[i] = src[2 * i + 1]; }
+      fx->engine.process(l, r, l, r, len);
+      for (int i = 0; i < len; ++i) { dst[2 * i] = l[i]; dst[2 * i + 1] = r[i]; }
+    } else {
+      // Mono is already planar.
+      fx->engine.processMono(src, dst, len);
+    }
+  }
+  return SVENDER_DSP_OK;
+}
+
+int svender_dsp_read_meters(svender_dsp* fx, svender_dsp_meters* out, int max_frames) {
+  if (!fx || !out || max_frames < 0)
+    return SVENDER_DSP_ERR_ARGUMENT;
+  int n = 0;
+  while (n < max_frames && fx->engine.popMeters(out[n]))
+    ++n;
+  return n;
+}
+
+int svender_dsp_set_analyzer(svender_dsp* fx, int enabled) {
+  if (!fx)
+    return SVENDER_DSP_ERR_ARGUMENT;
+  fx->engine.setAnalyzerEnabled(enabled != 0);
+  return SVENDER_DSP_OK;
+}
+
+int svender_dsp_set_pipelined(svender_dsp* fx, int enabled) {
+  if (!fx)
+    return SVENDER_DSP_ERR_ARGUMENT;
+  try {
+    fx->engine.setPipelined(enabled != 0);
+  } catch (const std::exception&) { // buffers or worker threads
+    return SVENDER_DSP_ERR_OUT_OF_MEMORY;
+  }
+  return SVENDER_DSP_OK;
+}
+
+int svender_dsp_set_internal_rate(svender_dsp* fx, int fixed) {
+  if (!fx)
+    return SVENDER_DSP_ERR_ARGUMENT;
+  fx->engine.setFixedInternalRate(fixed != 0);
+  return SVENDER_DSP_OK;
+}
+
+int svender_dsp_get_latency(const svender_dsp* fx) {
+  if (!fx) return 0;
+  return fx->configured ? fx->engine.latencySamples() : 0;
+}
+
+int svender_dsp_warm_up(svender_dsp* fx) {
+  if (!fx) return SVENDER_DSP_ERR_ARGUMENT;
+  if (!fx->configured) return SVENDER_DSP_ERR_NOT_READY;
+  fx->engine.warmUp();
+  return SVENDER_DSP_OK;
+}
+
+size_t svender_dsp_snapshot_size(const svender_dsp* fx) {
+  if (!fx) return 0;
+  return fx->configured ? fx->engine.snapshotSize() : 0;
+}
+
+int svender_dsp_save_snapshot(const svender_dsp* fx, void* dst, size_t size) {
+  if (!fx || !dst)
+    return SVENDER_DSP_ERR_ARGUMENT;
+  if (!fx->configured) return SVENDER_DSP_ERR_NOT_READY;
+  return fx->engine.saveSnapshot(dst, size) ? SVENDER_DSP_OK : SVENDER_DSP_ERR_ARGUMENT;
+}
+
+int svender_dsp_restore_snapshot(svender_dsp* fx, const void* src, size_t size) {
+  if (!fx || !src)
+    return SVENDER_DSP_ERR_ARGUMENT;
+  if (!fx->configured) return SVENDER_DSP_ERR_NOT_READY;
+  return fx->engine.restoreSnapshot(src, size) ? SVENDER_DSP_OK : SVENDER_DSP_ERR_ARGUMENT;
+}
+
+int svender_dsp_read_spectrum(svender_dsp* fx, svender_dsp_spectrum* out) {
+  if (!fx || !out)
+    return SVENDER_DSP_ERR_ARGUMENT;
+  return fx->engine.popSpectrum(*out) ? 1 : 0;
+}
+
+int svender_dsp_read_tuner(svender_dsp* fx, svender_dsp_tuner* out) {
+  if (!fx || !out)
+    return SVENDER_DSP_ERR_ARGUMENT;
+  return fx->engine.popTuner(*out) ? 1 : 0;
+}
+
+} // extern "C"
@@ -0,0 +1,198 @@
+/*
+ * svender_dsp — the SvenderBass tone engine behind a plain C API.
+ *
+ * The same engine the VST3 processor wraps, usable without the SDK (render
+ * servers, test harnesses). An instance is not thread-safe: configure,
+ * set_param and process calls must come from one thread at a time, normally
+ * the audio thread between blocks.
+ *
+ * Typical use:
+ *   svender_dsp* fx = svender_dsp_create();
+ *   svender_dsp_configure(fx, 48000.0, 512);
+ *   svender_dsp_set_param(fx, SVENDER_PARAM_DRIVE, 0.6);
+ *   svender_dsp_process_block(fx, in, out, 2, n);
+ *   svender_dsp_destroy(fx);
+ */
+#ifndef SVENDER_DSP_H
+#define SVENDER_DSP_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(SVENDER_DSP_SHARED)
+  #if defined(_WIN32)
+    #if defined(SVENDER_DSP_BUILD)
+      #define SVENDER_DSP_API __declspec(dllexport)
+    #else
+      #define SVENDER_DSP_API __declspec(dllimport)
+    #endif
+  #else
+    #define SVENDER_DSP_API __attribute__((visibility("default")))
+  #endif
+#else
+  #define SVENDER_DSP_API
+#endif
+
+/* Bumped on any incompatible change to this header. */
+#define SVENDER_DSP_API_VERSION 1
+
+typedef struct svender_dsp svender_dsp;
+
+/* Parameter ids. Values are normalized [0, 1], as in the plugin. */
+enum svender_dsp_param {
+  SVENDER_PARAM_INPUT_GAIN = 0,
+  SVENDER_PARAM_BASS       = 1,
+  SVENDER_PARAM_MID        = 2,
+  SVENDER_PARAM_TREBLE     = 3,
+  SVENDER_PARAM_MID_FREQ   = 4, /* 5 steps: 220/450/800/1600/3000 Hz */
+  SVENDER_PARAM_DRIVE      = 5,
+  SVENDER_PARAM_OUTPUT     = 6,
+  SVENDER_PARAM_ULTRA_LOW  = 7, /* switch */
+  SVENDER_PARAM_ULTRA_HIGH = 8, /* switch */
+  SVENDER_PARAM_SAT_MODE   = 9, /* 5 steps: 4x / ADAA1 1x / ADAA1 2x / ADAA2 1x / ADAA2 2x */
+  SVENDER_PARAM_TUNER      = 10, /* switch: tuner mode, bypasses the tone chain */
+  SVENDER_PARAM_TUNER_MUTE = 11, /* switch: silence the output while tuning */
+  SVENDER_PARAM_CROSSOVER  = 12, /* 5 steps: full band (default) / 80 / 120 / 200 / 300 Hz; lows below stay clean */
+  SVENDER_PARAM_TONE_STACK = 13, /* switch: bass/mid/treble as the modeled passive tone stack */
+  SVENDER_PARAM_COUNT
+};
+
+enum svender_dsp_status {
+  SVENDER_DSP_OK              =  0,
+  SVENDER_DSP_ERR_ARGUMENT    = -1,
+  SVENDER_DSP_ERR_NOT_READY   = -2, /* process before configure */
+  SVENDER_DSP_ERR_OUT_OF_MEMORY = -3
+};
+
+/* Level and drive telemetry, one frame per ~20 ms of processed audio. Levels
+ * are linear, both channels combined. */
+typedef struct svender_dsp_meters {
+  float input_peak, input_rms;           /* raw input */
+  float saturation_peak, saturation_rms; /* drive stage output (clean lows included), before sag gain and post EQ */
+  float output_peak, output_rms;
+  float sag;                             /* 0..1, highest sag control in the frame */
+  float drive;                           /* mean effective saturator drive */
+  unsigned frames;                       /* samples covered */
+} svender_dsp_meters;
+
+/* Input vs output spectrum, log-spaced bands from min_hz to max_hz, both
+ * channels combined. Levels in dBFS (a full-scale sine reads ~0 dB in its
+ * band), floored at -120. */
+#define SVENDER_SPECTRUM_BINS 96
+
+typedef struct svender_dsp_spectrum {
+  float min_hz, max_hz;
+  float input_db[SVENDER_SPECTRUM_BINS];
+  float output_db[SVENDER_SPECTRUM_BINS];
+  unsigned sequence;                     /* increments per analyzed frame */
+} svender_dsp_spectrum;
+
+SVENDER_DSP_API unsigned svender_dsp_api_version(void);
+
+SVENDER_DSP_API svender_dsp* svender_dsp_create(void);
+SVENDER_DSP_API void svender_dsp_destroy(svender_dsp* fx);
+
+/* Sets the sample rate and the largest block that will be passed to the
+ * process calls, allocates scratch memory and resets the DSP state. Returns
+ * SVENDER_DSP_ERR_OUT_OF_MEMORY if memory or the tuner's worker thread cannot
+ * be obtained. Not real-time safe. */
+SVENDER_DSP_API int svender_dsp_configure(svender_dsp* fx, double sample_rate, int max_block_size);
+
+/* Clears all filter and envelope state (as on transport restart). */
+SVENDER_DSP_API int svender_dsp_reset(svender_dsp* fx);
+
+SVENDER_DSP_API int svender_dsp_set_param(svender_dsp* fx, int param, double normalized);
+SVENDER_DSP_API double svender_dsp_get_param(const svender_dsp* fx, int param);
+
+/* Planar float buffers, 1 or 2 channels. Mono runs a single-channel chain
+ * whose output matches the stereo engine fed the same input on both sides.
+ * In-place processing (in == out) is allowed. Blocks longer than max_block_size are
+ * split internally. */
+SVENDER_DSP_API int svender_dsp_process_block(svender_dsp* fx, const float* const* in, float* const* out,
+                                              int num_channels, int num_frames);
+
+/* Interleaved float frames, 1 or 2 channels. */
+SVENDER_DSP_API int svender_dsp_process_interleaved(svender_dsp* fx, const float* in, float* out,
+                                                    int num_channels, int num_frames);
+
+/* Pops up to max_frames queued meter frames, oldest first, and returns how
+ * many were written. Wait-free. May run on another thread than the process
+ * calls, as long as only one thread reads. Frames that are not read in time
+ * are dropped. */
+SVENDER_DSP_API int svender_dsp_read_meters(svender_dsp* fx, svender_dsp_meters* out, int max_frames);
+
+/* Tuner reading. frequency_hz is 0 when no pitch is detected (silence, or
+ * the tuner is off); note is the nearest MIDI note (A4 = 440 Hz = 69) and
+ * cents the offset from it, -50..+50. */
+typedef struct svender_dsp_tuner {
+  float frequency_hz;
+  float cents;
+  int note;
+  float clarity;                         /* 0..1, YIN periodicity */
+  unsigned sequence;                     /* increments per reading */
+} svender_dsp_tuner;
+
+/* Starts or stops the spectrum analyzer (off by default). While off the
+ * process calls do no analyzer work at all; while on they copy samples to a
+ * background thread, which produces ~20 frames per second. Not real-time
+ * safe; call from the thread that configures. */
+SVENDER_DSP_API int svender_dsp_set_analyzer(svender_dsp* fx, int enabled);
+
+/* Offline rendering: runs the tone chain's stages (EQ and detectors, one
+ * saturator per channel, post/cab) on their own threads within each process
+ * call of at least 512 frames, so one instance uses up to four cores. The
+ * output is bit-identical to the serial engine and no latency is added.
+ * Off by default; worth it for long blocks, not for real-time use. Not
+ * real-time safe; call from the thread that configures. */
+SVENDER_DSP_API int svender_dsp_set_pipelined(svender_dsp* fx, int enabled);
+
+/* High sample rates: runs the tone chain at 44.1 or 48 kHz when the sample
+ * rate is a power-of-two multiple of one of them (88.2 kHz and up), with
+ * halfband resampling on the way in and out. Costs about the rate ratio
+ * less and sounds like the base rate, for svender_dsp_get_latency() frames
+ * of delay. Off by default; applied by the next svender_dsp_configure. */
+SVENDER_DSP_API int svender_dsp_set_internal_rate(svender_dsp* fx, int fixed);
+
+/* Frames the output lags the input by at the current configuration: 0
+ * unless the fixed internal rate is in use. */
+SVENDER_DSP_API int svender_dsp_get_latency(const svender_dsp* fx);
+
+/* Runs a dummy block through the chain and restores the state, so the first
+ * real process call does not pay page faults and cold caches. Output is
+ * unaffected. Not real-time safe; call after configure or reset, before
+ * audio starts. */
+SVENDER_DSP_API int svender_dsp_warm_up(svender_dsp* fx);
+
+/* Checkpoints for long offline renders: the complete DSP state, parameters
+ * included, as an opaque versioned blob. Restored into an instance of the
+ * same library build and configuration (sample rate, max block, internal
+ * rate), processing continues bit-identically to a render that never
+ * stopped, so a failed render can resume mid-file and a long one can be
+ * split at checkpoints across instances. Analyzer, tuner and unread meter
+ * frames are not included. Not real-time safe.
+ * snapshot_size returns 0 before configure. save needs size >= that;
+ * restore returns SVENDER_DSP_ERR_ARGUMENT for a blob from another version
+ * or configuration. */
+SVENDER_DSP_API size_t svender_dsp_snapshot_size(const svender_dsp* fx);
+SVENDER_DSP_API int svender_dsp_save_snapshot(const svender_dsp* fx, void* dst, size_t size);
+SVENDER_DSP_API int svender_dsp_restore_snapshot(svender_dsp* fx, const void* src, size_t size);
+
+/* Writes the newest spectrum frame and returns 1 if one was produced since
+ * the last call, else 0. Same threading rules as svender_dsp_read_meters. */
+SVENDER_DSP_API int svender_dsp_read_spectrum(svender_dsp* fx, svender_dsp_spectrum* out);
+
+/* Writes the newest tuner reading and returns 1 if one was produced since
+ * the last call, else 0. Readings arrive ~40 times per second while
+ * SVENDER_PARAM_TUNER is on (detection runs on a background thread that
+ * configure starts), plus one final "no pitch" reading when it turns off.
+ * Same threading rules as svender_dsp_read_meters. */
+SVENDER_DSP_API int svender_dsp_read_tuner(svender_dsp* fx, svender_dsp_tuner* out);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* SVENDER_DSP_H */
@@ -0,0 +1,40 @@
+#pragma once
+#include "svender_dsp.h"
+
+#include <cstdint>
+
+namespace SvenderBass {
+
+// Layout of the data-exchange blocks the Processor streams to the
+// Controller: a header followed by `count` payload records of `kind`.
+enum TelemetryKind : uint32_t {
+  kTelemetryMeters = 1,   // svender_dsp_meters[count]
+  kTelemetrySpectrum = 2, // svender_dsp_spectrum[1]
+};
+
+struct TelemetryHeader {
+  uint32_t kind;
+  uint32_t count;
+};
+
+constexpr uint32_t kTelemetryMaxMeterFrames = 8;
+
+constexpr uint32_t kTelemetryMeterBytes = kTelemetryMaxMeterFrames * sizeof(svender_dsp_meters);
+constexpr uint32_t kTelemetrySpectrumBytes = sizeof(svender_dsp_spectrum);
+
+constexpr uint32_t kTelemetryBlockSize = sizeof(TelemetryHeader) +
+  (kTelemetryMeterBytes > kTelemetrySpectrumBytes ? kTelemetryMeterBytes : kTelemetrySpectrumBytes);
+
+constexpr uint32_t kTelemetryNumBlocks = 8;
+
+// Controller -> Processor message toggling the spectrum analyzer, so it only
+// runs while an editor is open. Attribute: int64 "enabled".
+constexpr const char* kAnalyzerMessageID = "SvenderAnalyzer";
+constexpr const char* kAnalyzerEnabledAttr = "enabled";
+
+// Controller -> Processor: kParamInternalRate changed, ahead of the restart
+// that reactivates the processor with it. Attribute: int64 "fixed".
+constexpr const char* kInternalRateMessageID = "SvenderInternalRate";
+constexpr const char* kInternalRateAttr = "fixed";
+
+} // namespace SvenderBass
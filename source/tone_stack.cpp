@@ -0,0 +1,265 @@
+#include "tone_stack.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <utility>
+#include <vector>
+
+namespace SvenderBass::DSP {
+
+namespace {
+
+// Bassman 5F6-A network: treble cap C1 and pot R1, bass pot R2 (audio
+// taper), mid pot R3, slope resistor R4; C2 and C3 couple the slope
+// resistor to the bass and mid pots. The Mid Freq steps switch the mid cap
+// C3, which moves the scoop (220, 450, 800, 1600, 3000 Hz with the knobs at
+// noon); the top step also needs smaller C1 and C2.
+constexpr double kR1 = 250e3, kR2 = 1e6, kR3 = 25e3, kR4 = 56e3;
+struct Caps {
+  double c1, c2, c3;
+};
+constexpr Caps kVoicingCaps[ToneStack::kVoicings] = {
+  { 250e-12, 20e-9, 470e-9 },
+  { 250e-12, 20e-9, 68e-9 },
+  { 250e-12, 20e-9, 18e-9 },
+  { 250e-12, 20e-9, 4.7e-9 },
+  { 150e-12, 12e-9, 2.2e-9 },
+};
+
+constexpr int kPoints = ToneStack::kGrid * ToneStack::kGrid * ToneStack::kGrid;
+
+// Audio-taper pot: 10% of the track at mid rotation.
+double audioTaper(double x) {
+  constexpr double k = 4.394449154672439; // 2 ln 9
+  return (std::exp(k * x) - 1.0) / (std::exp(k) - 1.0);
+}
+
+// Determinant by Gaussian elimination with partial pivoting; destroys a.
+template <int N>
+double determinant(double (&a)[N][N]) {
+  double det = 1.0;
+  for (int c = 0; c < N; ++c) {
+    int p = c;
+    for (int r = c + 1; r < N; ++r)
+      if (std::fabs(a[r][c]) > std::fabs(a[p][c])) p = r;
+    if (a[p][c] == 0.0)
+      return 0.0;
+    if (p != c) {
+      std::swap(a[p], a[c]);
+      det = -det;
+    }
+    det *= a[c][c];
+    for (int r = c + 1; r < N; ++r) {
+      const double f = a[r][c] / a[c][c];
+      for (int k = c; k < N; ++k)
+        a[r][k] -= f * a[c][k];
+    }
+  }
+  return det;
+}
+
+// Coefficients of the cubic through (x[k], y[k]), lowest order first.
+void fitCubic(const double (&x)[4], const double (&y)[4], double (&coef)[4]) {
+  double a[4][5];
+  for (int r = 0; r < 4; ++r) {
+    for (int k = 0; k < 4; ++k)
+      a[r][k] = std::pow(x[r], k);
+    a[r][4] = y[r];
+  }
+  for (int c = 0; c < 4; ++c) {
+    int p = c;
+    for (int r = c + 1; r < 4; ++r)
+      if (std::fabs(a[r][c]) > std::fabs(a[p][c])) p = r;
+    std::swap(a[p], a[c]);
+    for (int r = 0; r < 4; ++r) {
+      if (r == c) continue;
+      const double f = a[r][c] / a[c][c];
+      for (int k = c; k < 5; ++k)
+        a[r][k] -= f * a[c][k];
+    }
+  }
+  for (int k = 0; k < 4; ++k)
+    coef[k] = a[k][4] / a[k][k];
+}
+
+// Gain of the sections at f Hz.
+double magnitude(const ToneStack::Sections& s, double hz) {
+  const std::complex<double> x(0.0, 2.0 * kPiD * hz / ToneStack::kRefRadPerSec);
+  const double p1 = std::exp(s.logP1), q0 = std::exp(s.logQ0), q1 = std::exp(s.logQ1);
+  const double n1 = std::exp(s.logN1), n2 = std::exp(s.logN2), n3 = std::exp(s.logN3);
+  return std::abs(x / (x + p1) * (n1 + x * (n2 + x * n3)) / (q0 + x * (q1 + x)));
+}
+
+// Grid points sit at squares of even steps, denser towards zero, where
+// every pot's end dominates the network and the response moves fastest.
+double knobAt(int i) {
+  const double x = i / (ToneStack::kGrid - 1.0);
+  return x * x;
+}
+
+std::vector<ToneStack::Sections> buildGrid() {
+  constexpr int g = ToneStack::kGrid;
+  std::vector<ToneStack::Sections> grid((size_t)ToneStack::kVoicings * kPoints);
+  for (int v = 0; v < ToneStack::kVoicings; ++v) {
+    ToneStack::Sections* t = &grid[(size_t)v * kPoints];
+    for (int b = 0; b < g; ++b)
+      for (int m = 0; m < g; ++m)
+        for (int tr = 0; tr < g; ++tr)
+          t[(b * g + m) * g + tr] = ToneStack::solve(v, knobAt(b), knobAt(m), knobAt(tr));
+
+    // Make-up gain: the stack with every knob at noon peaks at 0 dB.
+    const ToneStack::Sections noon = ToneStack::solve(v, 0.5, 0.5, 0.5);
+    double peak = 0.0;
+    for (double hz = 20.0; hz < 12000.0; hz *= 1.02)
+      peak = std::max(peak, magnitude(noon, hz));
+    const float makeup = (float)-std::log(peak);
+    for (int i = 0; i < kPoints; ++i) {
+      t[i].logN1 += makeup;
+      t[i].logN2 += makeup;
+      t[i].logN3 += makeup;
+    }
+  }
+  return grid;
+}
+
+// Built by prepare(); concurrent first calls wait for the one building it.
+const std::vector<ToneStack::Sections>& grid() {
+  static const std::vector<ToneStack::Sections> table = buildGrid();
+  return table;
+}
+
+} // namespace
+
+ToneStack::Sections ToneStack::solve(int voicing, double bass, double mid, double treble) {
+  // Pots never quite reach their ends, which keeps every node connected.
+  constexpr double kEnd = 1e-3;
+  const double t = std::clamp(treble, kEnd, 1.0 - kEnd);
+  const double m = std::max(mid, kEnd);
+  const double l = std::max(audioTaper(std::clamp(bass, 0.0, 1.0)), kEnd);
+  const Caps& caps = kVoicingCaps[std::clamp(voicing, 0, kVoicings - 1)];
+  const double c1 = caps.c1, c2 = caps.c2, c3 = caps.c3;
+
+  // Nodes: treble pot top, output (treble wiper), treble pot bottom / bass
+  // pot top, slope resistor end, mid pot top. The input is an ideal source.
+  enum { kTop, kOut, kBass, kSlope, kMid, kNodes };
+  double dens[4], nums[4];
+  constexpr double kFit[4] = { 0.5, 1.0, 2.0, 4.0 }; // s / kRefRadPerSec
+  for (int k = 0; k < 4; ++k) {
+    const double s = kFit[k] * kRefRadPerSec;
+    double y[kNodes][kNodes] = {};
+    double in[kNodes] = {};
+    auto branch = [&](int a, int b, double adm) {
+      y[a][a] += adm;
+      if (b < 0) return;
+      y[b][b] += adm;
+      y[a][b] -= adm;
+      y[b][a] -= adm;
+    };
+    auto fromInput = [&](int a, double adm) {
+      y[a][a] += adm;
+      in[a] += adm;
+    };
+    fromInput(kTop, s * c1);
+    fromInput(kSlope, 1.0 / kR4);
+    branch(kTop, kOut, 1.0 / ((1.0 - t) * kR1));
+    branch(kOut, kBass, 1.0 / (t * kR1));
+    branch(kSlope, kBass, s * c2);
+    branch(kSlope, kMid, s * c3);
+    branch(kBass, kMid, 1.0 / (l * kR2));
+    branch(kMid, -1, 1.0 / (m * kR3));
+
+    // Cramer's rule for the output node; both determinants are cubics in s.
+    double yo[kNodes][kNodes];
+    for (int r = 0; r < kNodes; ++r)
+      for (int c = 0; c < kNodes; ++c)
+        yo[r][c] = c == kOut ? in[r] : y[r][c];
+    dens[k] = determinant(y);
+    nums[k] = determinant(yo);
+  }
+  double d[4], n[4];
+  fitCubic(kFit, dens, d);
+  fitCubic(kFit, nums, n);
+
+  // Monic denominator. Its roots are real and negative (a passive RC
+  // network), so Newton from s = 0 walks straight to the lowest pole.
+  const double a2 = d[2] / d[3], a1 = d[1] / d[3], a0 = d[0] / d[3];
+  double x = 0.0;
+  for (int i = 0; i < 100; ++i) {
+    const double f = ((x + a2) * x + a1) * x + a0;
+    const double df = (3.0 * x + 2.0 * a2) * x + a1;
+    const double step = f / df;
+    x -= step;
+    if (std::fabs(step) <= 1e-13 * std::max(1.0, std::fabs(x)))
+      break;
+  }
+  const double p1 = -x;
+  const double q1 = a2 - p1;
+  const double q0 = a1 - p1 * q1;
+
+  // n[0] is the zero at DC, left out.
+  Sections out;
+  out.logP1 = (float)std::log(p1);
+  out.logN1 = (float)std::log(n[1] / d[3]);
+  out.logN2 = (float)std::log(n[2] / d[3]);
+  out.logN3 = (float)std::log(n[3] / d[3]);
+  out.logQ0 = (float)std::log(q0);
+  out.logQ1 = (float)std::log(q1);
+  return out;
+}
+
+void ToneStack::prepare() {
+  grid();
+}
+
+void ToneStack::setup(float sampleRate, int voicing) {
+  voicing_ = std::clamp(voicing, 0, kVoicings - 1);
+  c_ = (float)(2.0 * sampleRate / kRefRadPerSec);
+}
+
+void ToneStack::design(Biquad& lowCut, Biquad& body, float bass, float mid, float treble) const {
+  auto cell = [](float knob, int& i, float& f) {
+    const float x = std::sqrt(clamp(knob, 0.0f, 1.0f)) * (kGrid - 1);
+    i = std::min((int)x, kGrid - 2);
+    f = x - (float)i;
+  };
+  int ib, im, it;
+  float fb, fm, ft;
+  cell(bass, ib, fb);
+  cell(mid, im, fm);
+  cell(treble, it, ft);
+
+  const Sections* table = &grid()[(size_t)voicing_ * kPoints];
+  Sections s {};
+  for (int corner = 0; corner < 8; ++corner) {
+    const int db = corner >> 2, dm = (corner >> 1) & 1, dt = corner & 1;
+    const float w = (db ? fb : 1.0f - fb) * (dm ? fm : 1.0f - fm) * (dt ? ft : 1.0f - ft);
+    const Sections& p = table[((ib + db) * kGrid + im + dm) * kGrid + it + dt];
+    s.logP1 += w * p.logP1;
+    s.logN1 += w * p.logN1;
+    s.logN2 += w * p.logN2;
+    s.logN3 += w * p.logN3;
+    s.logQ0 += w * p.logQ0;
+    s.logQ1 += w * p.logQ1;
+  }
+
+  // Bilinear transform, s = c (1 - z^-1) / (1 + z^-1).
+  const float c = c_, cc = c * c;
+  const float p1 = std::exp(s.logP1);
+  lowCut.b0 = c / (c + p1);
+  lowCut.b1 = -lowCut.b0;
+  lowCut.b2 = 0.0f;
+  lowCut.a1 = (p1 - c) / (c + p1);
+  lowCut.a2 = 0.0f;
+
+  const float n1 = std::exp(s.logN1), n2 = std::exp(s.logN2), n3 = std::exp(s.logN3);
+  const float q0 = std::exp(s.logQ0), q1 = std::exp(s.logQ1);
+  const float a0 = q0 + q1 * c + cc;
+  body.b0 = (n1 + n2 * c + n3 * cc) / a0;
+  body.b1 = 2.0f * (n1 - n3 * cc) / a0;
+  body.b2 = (n1 - n2 * c + n3 * cc) / a0;
+  body.a1 = 2.0f * (q0 - cc) / a0;
+  body.a2 = (q0 - q1 * c + cc) / a0;
+}
+
+} // namespace SvenderBass::DSP
@@ -0,0 +1,53 @@
+#pragma once
+#include "dsp.h"
+
+namespace SvenderBass::DSP {
+
+// Passive tone stack of the classic bass amp (the Bassman-style network:
+// treble cap and pot, bass and mid pots, slope resistor), in which the
+// three knobs interact. The network is 3rd order, with a zero at DC; it runs
+// as a first-order high-pass (that zero and the lowest pole) followed by one
+// biquad, which is cheaper than three separate EQ sections.
+//
+// Nodal analysis of the circuit happens once per process, on a grid over
+// the three knobs for every Mid Freq position. Each grid point keeps the
+// transfer function already split into those two sections. design() only
+// interpolates between the eight grid points around the knobs and applies
+// the bilinear transform. All coefficients are positive and interpolated
+// as logs, which tracks the knobs' exponential effect and keeps every
+// interpolated filter stable.
+class ToneStack {
+public:
+  static constexpr int kGrid = 9;     // knob positions per axis
+  static constexpr int kVoicings = 5; // SVENDER_PARAM_MID_FREQ steps
+
+  // Builds the grid, once per process (a few ms); later calls return at
+  // once. Not real-time safe. Must have returned before setup() and
+  // design(), which only read the grid and are real-time safe.
+  static void prepare();
+
+  void setup(float sampleRate, int voicing);
+
+  // Knobs are normalized [0, 1]. Writes the high-pass to lowCut and the
+  // second-order section to body.
+  void design(Biquad& lowCut, Biquad& body, float bass, float mid, float treble) const;
+
+  // One section pair in the s domain, with s normalized to kRefRadPerSec:
+  //   s / (s + p1)  *  (n1 + n2 s + n3 s^2) / (q0 + q1 s + s^2)
+  struct Sections {
+    float logP1, logN1, logN2, logN3, logQ0, logQ1;
+  };
+  static constexpr double kRefRadPerSec = 6283.185307179586; // 1 kHz
+
+  // The exact sections at knob positions (bass, mid, treble), as stored in
+  // the grid, before make-up gain. Not real-time safe.
+  static Sections solve(int voicing, double bass, double mid, double treble);
+
+private:
+  // No pointers, so a copy stays valid in another process (Engine
+  // checkpoints).
+  int voicing_ = 0;
+  float c_ = 1.0f; // bilinear: s = c (1 - z^-1) / (1 + z^-1)
+};
+
+} // namespace SvenderBass::DSP
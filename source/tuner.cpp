@@ -0,0 +1,268 @@
+#include "tuner.h"
+#include "kernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace SvenderBass {
+
+namespace {
+
+constexpr double kTargetRate = 4000.0;
+constexpr float kMinHz = 25.0f;      // below a detuned low B
+constexpr float kMaxHz = 450.0f;
+constexpr float kWindowSec = 0.08f;  // YIN integration window
+constexpr float kHopSec = 0.025f;
+constexpr float kThreshold = 0.15f;  // YIN absolute threshold
+constexpr float kGateRms = 1e-3f;    // ~-60 dBFS: report no pitch below this
+
+} // namespace
+
+// The detection thread shared by all tuners. It runs while at least one
+// tuner is configured; add and remove are serialized, so the last remove
+// can join it without racing a new start.
+class Tuner::Worker {
+public:
+  // Never destroyed: tuners in static storage may still unregister at exit.
+  static Worker& instance() {
+    static Worker* worker = new Worker;
+    return *worker;
+  }
+
+  void add(Tuner* t) {
+    std::lock_guard<std::mutex> life(lifecycle_);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tuners_.push_back(t);
+      if (running_)
+        return;
+      running_ = true;
+    }
+    try {
+      thread_ = std::thread([this] { run(); });
+    } catch (...) { // std::system_error: leave no worker marked running
+      std::lock_guard<std::mutex> lock(mutex_);
+      tuners_.erase(std::find(tuners_.begin(), tuners_.end(), t));
+      running_ = false;
+      throw;
+    }
+  }
+
+  void remove(Tuner* t) {
+    std::lock_guard<std::mutex> life(lifecycle_);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tuners_.erase(std::find(tuners_.begin(), tuners_.end(), t));
+      if (!tuners_.empty())
+        return;
+      running_ = false;
+    }
+    wake_.notify_all();
+    thread_.join();
+  }
+
+private:
+  // Drains as long as samples arrive, checks every 10 ms while a tuner is
+  // active and every 100 ms otherwise.
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+      bool got = false, anyActive = false;
+      for (Tuner* t : tuners_) {
+        got = t->poll() || got;
+        anyActive = anyActive || t->active();
+      }
+      if (got)
+        continue;
+      wake_.wait_for(lock, std::chrono::milliseconds(anyActive ? 10 : 100), [this] { return !running_; });
+    }
+  }
+
+  std::mutex lifecycle_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::vector<Tuner*> tuners_;
+  bool running_ = false;
+  std::thread thread_;
+};
+
+Tuner::~Tuner() {
+  stop();
+}
+
+void Tuner::configure(double sampleRate) {
+  stop();
+
+  sampleRate_ = sampleRate;
+  decimation_ = std::max(1, (int)(sampleRate / kTargetRate));
+  decimatedRate_ = (float)(sampleRate / decimation_);
+
+  const float sr = (float)sampleRate;
+  aa_[0].setHP(sr, 20.0f);
+  aa_[1].setLP(sr, 0.2f * decimatedRate_, 0.5412f);
+  aa_[2].setLP(sr, 0.2f * decimatedRate_, 1.3066f);
+  for (auto& bq : aa_) bq.reset();
+  phase_ = 0;
+
+  window_ = (int)(kWindowSec * decimatedRate_);
+  minLag_ = std::max(2, (int)(decimatedRate_ / kMaxHz));
+  maxLag_ = (int)std::ceil(decimatedRate_ / kMinHz);
+  hop_ = std::max(1, (int)(kHopSec * decimatedRate_));
+  history_.assign((size_t)(window_ + maxLag_ + 1), 0.0f);
+  diff_.assign((size_t)maxLag_ + 2, 0.0f);
+  norm_.assign((size_t)maxLag_ + 2, 0.0f);
+  filled_ = 0;
+  sinceHop_ = 0;
+  wasActive_ = false;
+
+  float x;
+  while (samples_.pop(x)) {}
+
+  Worker::instance().add(this);
+  registered_ = true;
+}
+
+void Tuner::stop() {
+  if (registered_)
+    Worker::instance().remove(this);
+  registered_ = false;
+}
+
+void Tuner::setActive(bool active) {
+  if (active && !this->active()) {
+    for (auto& bq : aa_) bq.reset();
+    phase_ = 0;
+  }
+  active_.store(active, std::memory_order_release);
+}
+
+void Tuner::capture(const float* l, const float* r, int n) {
+  if (!active())
+    return;
+
+  const DSP::KernelTable& k = DSP::kernels();
+  alignas(64) float buf[DSP::kControlInterval];
+
+  for (int pos = 0; pos < n; pos += DSP::kControlInterval) {
+    const int len = std::min(n - pos, DSP::kControlInterval);
+    for (int i = 0; i < len; ++i)
+      buf[i] = 0.5f * (l[pos + i] + r[pos + i]);
+    k.biquadCascade(aa_, kAaStages, buf, len);
+
+    for (int i = 0; i < len; ++i) {
+      if (++phase_ == decimation_) {
+        phase_ = 0;
+        samples_.push(buf[i]); // dropped if the worker is behind
+      }
+    }
+  }
+}
+
+bool Tuner::popResult(svender_dsp_tuner& out) {
+  bool any = false;
+  while (results_.pop(out))
+    any = true;
+  return any;
+}
+
+// One round on the worker: everything captured since the last one. Returns
+// whether there were samples.
+bool Tuner::poll() {
+  const size_t len = history_.size();
+  if (!active_.load(std::memory_order_acquire)) {
+    if (wasActive_) {
+      svender_dsp_tuner none {};
+      none.sequence = ++sequence_;
+      results_.push(none);
+    }
+    wasActive_ = false;
+    float x;
+    while (samples_.pop(x)) {}
+    filled_ = 0;
+    sinceHop_ = 0;
+    return false;
+  }
+  wasActive_ = true;
+
+  float x;
+  bool got = false;
+  while (samples_.pop(x)) {
+    got = true;
+    // Shift-register history, oldest first; short enough that the move
+    // is cheaper than the detector.
+    std::move(history_.begin() + 1, history_.end(), history_.begin());
+    history_[len - 1] = x;
+    filled_ = std::min(filled_ + 1, len);
+
+    if (++sinceHop_ >= hop_ && filled_ == len) {
+      sinceHop_ = 0;
+      svender_dsp_tuner t {};
+      float hz = 0.0f, clarity = 0.0f;
+      if (detect(history_.data(), hz, clarity)) {
+        const float midi = 69.0f + 12.0f * std::log2(hz / 440.0f);
+        t.frequency_hz = hz;
+        t.note = (int)std::lround(midi);
+        t.cents = 100.0f * (midi - (float)t.note);
+        t.clarity = clarity;
+      }
+      t.sequence = ++sequence_;
+      results_.push(t);
+    }
+  }
+  return got;
+}
+
+// YIN (de Cheveigné & Kawahara): cumulative-mean-normalized difference,
+// first dip under the threshold, parabolic refinement.
+bool Tuner::detect(const float* x, float& hz, float& clarity) {
+  float energy = 0.0f;
+  for (int j = 0; j < window_; ++j) energy += x[j] * x[j];
+  if (energy < kGateRms * kGateRms * (float)window_)
+    return false;
+
+  // Raw difference function; the normalized one is derived on the fly.
+  float* raw = diff_.data();
+  raw[0] = 0.0f;
+  for (int tau = 1; tau <= maxLag_ + 1; ++tau) {
+    float s = 0.0f;
+    for (int j = 0; j < window_; ++j) {
+      const float e = x[j] - x[j + tau];
+      s += e * e;
+    }
+    raw[tau] = s;
+  }
+  float* d = norm_.data();
+  d[0] = 1.0f;
+  float running = 0.0f;
+  for (int tau = 1; tau <= maxLag_ + 1; ++tau) {
+    running += raw[tau];
+    d[tau] = running > 0.0f ? raw[tau] * (float)tau / running : 1.0f;
+  }
+
+  int best = -1;
+  for (int tau = minLag_; tau <= maxLag_; ++tau) {
+    if (d[tau] < kThreshold) {
+      while (tau + 1 <= maxLag_ && d[tau + 1] < d[tau]) ++tau;
+      best = tau;
+      break;
+    }
+  }
+  if (best < 0)
+    return false;
+
+  float shift = 0.0f;
+  const float a = raw[best - 1], b = raw[best], c = raw[best + 1];
+  const float den = a - 2.0f * b + c;
+  if (den > 0.0f)
+    shift = 0.5f * (a - c) / den;
+
+  hz = decimatedRate_ / ((float)best + shift);
+  clarity = DSP::clamp(1.0f - d[best], 0.0f, 1.0f);
+  return hz >= kMinHz && hz <= kMaxHz;
+}
+
+} // namespace SvenderBass
@@ -0,0 +1,71 @@
+#pragma once
+#include "dsp.h"
+#include "spsc_ring.h"
+#include "svender_dsp.h"
+
+#include <atomic>
+#include <vector>
+
+namespace SvenderBass {
+
+// Bass tuner. The audio thread band-limits the mono input and keeps every
+// decimation_-th sample (~4 kHz, plenty for fundamentals under 400 Hz); a
+// worker thread runs YIN pitch detection on that stream and queues results.
+// One worker serves every configured tuner in the process and only polls
+// slowly while none is active, so many instances do not mean many threads.
+class Tuner {
+public:
+  Tuner() = default;
+  ~Tuner();
+  Tuner(const Tuner&) = delete;
+  Tuner& operator=(const Tuner&) = delete;
+
+  // Not real-time safe: designs the decimator and registers with the worker.
+  void configure(double sampleRate);
+
+  // Audio thread. Activation clears the decimator; the worker drops its
+  // history when it sees the tuner go inactive.
+  void setActive(bool active);
+  bool active() const { return active_.load(std::memory_order_relaxed); }
+  void capture(const float* l, const float* r, int n);
+
+  // Newest result since the last call, if any. Single consumer.
+  bool popResult(svender_dsp_tuner& out);
+
+private:
+  static constexpr int kAaStages = 3; // DC high-pass + 4th-order low-pass
+  static constexpr size_t kSampleRingSize = 4096;
+
+  class Worker;
+
+  void stop();
+  bool poll();
+  bool detect(const float* x, float& hz, float& clarity);
+
+  double sampleRate_ = 44100.0;
+  int decimation_ = 11;
+  float decimatedRate_ = 4009.0f;
+
+  // Audio-thread state.
+  DSP::Biquad aa_[kAaStages];
+  int phase_ = 0;
+
+  std::atomic<bool> active_ {false};
+  bool registered_ = false;
+
+  // Worker-only state: YIN over window_ samples for lags up to maxLag_.
+  size_t filled_ = 0;
+  int sinceHop_ = 0;
+  bool wasActive_ = false;
+  int window_ = 320;
+  int minLag_ = 8;
+  int maxLag_ = 160;
+  int hop_ = 100;
+  std::vector<float> history_, diff_, norm_;
+  unsigned sequence_ = 0;
+
+  DSP::SpscRing<float, kSampleRingSize> samples_;
+  DSP::SpscRing<svender_dsp_tuner, 8> results_;
+};
+
+} // namespace SvenderBass
@@ -0,0 +1,161 @@
+// The engine's output must not depend on how the host slices the stream.
+//
+// The same input, with the same parameter changes, is rendered at block
+// sizes 1, 7, 64, 512 and 4096 (and an irregular mix). Parameter changes
+// fall on the same samples in every render: like a host with sample-accurate
+// automation, the render splits its block at each change. Audio must match
+// the 4096-sample render bit for bit, for stereo, mono, every saturation
+// mode, the crossover, the tone stack, the fixed internal rate and the
+// pipelined chain. Meter frames must fall on the same samples with the same
+// peaks, sag and drive. The RMS fields are summed in float, in SIMD lanes
+// over each pass, so they only have to agree to 1e-4.
+
+#include "engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace SvenderBass;
+
+namespace {
+
+constexpr int kMaxBlock = 4096;
+constexpr int kChangeEvery = 9000; // samples between parameter changes
+
+struct Case {
+  const char* name;
+  double sampleRate;
+  bool stereo;
+  int satMode;
+  int crossover;
+  bool toneStack;
+  bool fixedRate;
+  bool pipelined;
+};
+
+constexpr Case kCases[] = {
+  { "stereo-os4x",        48000.0, true,  0, 0, false, false, false },
+  { "mono-os4x",          48000.0, false, 0, 0, false, false, false },
+  { "stereo-adaa1-1x",    48000.0, true,  1, 0, false, false, false },
+  { "stereo-adaa1-2x",    44100.0, true,  2, 0, false, false, false },
+  { "mono-adaa2-1x",      48000.0, false, 3, 0, false, false, false },
+  { "stereo-adaa2-2x",    48000.0, true,  4, 0, false, false, false },
+  { "stereo-crossover",   48000.0, true,  0, 2, false, false, false },
+  { "stereo-tone-stack",  48000.0, true,  0, 0, true,  false, false },
+  { "stereo-fixed-rate",  96000.0, true,  0, 0, false, true,  false },
+  { "stereo-pipelined",   48000.0, true,  0, 1, false, false, true  },
+};
+
+struct Render {
+  std::vector<float> l, r;
+  std::vector<svender_dsp_meters> meters;
+};
+
+// Steps every few parameters at each change point.
+void automate(Engine& e, int change) {
+  e.setParam(SVENDER_PARAM_DRIVE, 0.2 + 0.15 * (change % 5));
+  e.setParam(SVENDER_PARAM_BASS, 0.3 + 0.1 * (change % 4));
+  e.setParam(SVENDER_PARAM_MID, 0.7 - 0.15 * (change % 3));
+  e.setParam(SVENDER_PARAM_TREBLE, 0.4 + 0.1 * (change % 3));
+  e.setParam(SVENDER_PARAM_OUTPUT, 0.6 + 0.05 * (change % 2));
+}
+
+// blockSize 0 picks an irregular sequence of sizes.
+Render render(const Case& c, const std::vector<float>& inL, const std::vector<float>& inR, int blockSize) {
+  Engine e;
+  e.setPipelined(c.pipelined);
+  e.setFixedInternalRate(c.fixedRate);
+  e.configure(c.sampleRate, kMaxBlock);
+  e.setParam(SVENDER_PARAM_SAT_MODE, c.satMode / 4.0);
+  e.setParam(SVENDER_PARAM_CROSSOVER, c.crossover / 4.0);
+  e.setParam(SVENDER_PARAM_TONE_STACK, c.toneStack ? 1.0 : 0.0);
+
+  const int frames = (int)inL.size();
+  Render out;
+  out.l.resize(frames);
+  out.r.resize(c.stereo ? frames : 0);
+  unsigned irregular = 1;
+  for (int n = 0; n < frames;) {
+    if (n % kChangeEvery == 0)
+      automate(e, n / kChangeEvery);
+    int len = blockSize;
+    if (blockSize == 0) {
+      irregular = irregular * 1103515245u + 12345u;
+      len = 1 + (int)((irregular >> 16) % kMaxBlock);
+    }
+    len = std::min({ len, frames - n, kChangeEvery - n % kChangeEvery });
+    if (c.stereo)
+      e.process(&inL[n], &inR[n], &out.l[n], &out.r[n], len);
+    else
+      e.processMono(&inL[n], &out.l[n], len);
+    svender_dsp_meters m;
+    while (e.popMeters(m))
+      out.meters.push_back(m);
+    n += len;
+  }
+  return out;
+}
+
+bool closeRms(float a, float b) { return std::fabs(a - b) <= 1e-4f * std::max(std::fabs(a), std::fabs(b)); }
+
+bool sameMeters(const std::vector<svender_dsp_meters>& a, const std::vector<svender_dsp_meters>& b) {
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    const svender_dsp_meters& x = a[i];
+    const svender_dsp_meters& y = b[i];
+    if (x.frames != y.frames || x.input_peak != y.input_peak || x.saturation_peak != y.saturation_peak ||
+        x.output_peak != y.output_peak || x.sag != y.sag || x.drive != y.drive ||
+        !closeRms(x.input_rms, y.input_rms) || !closeRms(x.saturation_rms, y.saturation_rms) ||
+        !closeRms(x.output_rms, y.output_rms))
+      return false;
+  }
+  return true;
+}
+
+// First differing sample, or -1.
+int firstDifference(const std::vector<float>& a, const std::vector<float>& b) {
+  for (size_t i = 0; i < a.size(); ++i)
+    if (std::memcmp(&a[i], &b[i], sizeof(float)) != 0)
+      return (int)i;
+  return -1;
+}
+
+} // namespace
+
+int main() {
+  const int blockSizes[] = { 1, 7, 64, 512, 0 };
+  int failed = 0;
+  for (const Case& c : kCases) {
+    // Plucked bass notes, decaying into silence between them.
+    const int frames = (int)(1.5 * c.sampleRate);
+    std::vector<float> inL(frames), inR(frames);
+    const double noteLen = 0.3 * c.sampleRate;
+    for (int i = 0; i < frames; ++i) {
+      const int note = (int)(i / noteLen);
+      const double t = (i - note * noteLen) / c.sampleRate;
+      const double hz = 41.2 * std::pow(2.0, (note * 7 % 12) / 12.0);
+      const double env = std::exp(-t * 8.0);
+      inL[i] = (float)(0.7 * env * std::sin(2.0 * DSP::kPiD * hz * t));
+      inR[i] = (float)(0.5 * env * std::sin(2.0 * DSP::kPiD * hz * t + 0.4));
+    }
+
+    const Render reference = render(c, inL, inR, kMaxBlock);
+    for (int bs : blockSizes) {
+      const Render r = render(c, inL, inR, bs);
+      const int diffL = firstDifference(reference.l, r.l);
+      const int diffR = firstDifference(reference.r, r.r);
+      const bool metersSame = sameMeters(r.meters, reference.meters);
+      if (diffL < 0 && diffR < 0 && metersSame)
+        continue;
+      ++failed;
+      std::printf("FAIL %s block %d: first difference L %d R %d, meter frames %zu vs %zu%s\n", c.name, bs, diffL,
+                  diffR, r.meters.size(), reference.meters.size(), metersSame ? "" : " (differ)");
+    }
+  }
+  std::printf("%s\n", failed ? "FAILED" : "ok");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+// Editor model (editor_model.h), headless.
+//
+// A knob animation must stop once every indicator has reached its target,
+// and produce no further frames or repaints. A single knob change must
+// dirty exactly that indicator's old and new bounds. Overlapping dirty
+// rectangles must merge, including through a rectangle that bridges two
+// earlier ones.
+
+#include "editor_model.h"
+
+#include <cstdio>
+#include <initializer_list>
+
+using namespace SvenderBass::UI;
+
+namespace {
+
+int failed = 0;
+
+void check(bool ok, const char* what) {
+  if (ok)
+    return;
+  ++failed;
+  std::printf("FAIL %s\n", what);
+}
+
+bool sameRect(const Rect& a, const Rect& b) {
+  return a.left == b.left && a.top == b.top && a.right == b.right && a.bottom == b.bottom;
+}
+
+bool within(const Rect& inner, const Rect& outer) {
+  return inner.left >= outer.left && inner.top >= outer.top && inner.right <= outer.right &&
+         inner.bottom <= outer.bottom;
+}
+
+void testSettling(const Layout& layout) {
+  KnobAnimator anim;
+  for (int k = 0; k < kKnobCount; ++k)
+    anim.reset(k, 0.5f);
+  check(!anim.animating(), "reset does not animate");
+  check(!anim.setTarget(1, 0.5f), "unchanged value needs no frames");
+
+  check(anim.setTarget(1, 1.0f) && anim.setTarget(4, 0.0f), "new targets need frames");
+  int frames = 0;
+  DirtyRegion dirty;
+  while (frames < 1000 && anim.tick(layout, dirty)) {
+    dirty.clear();
+    ++frames;
+  }
+  check(frames < 100, "animation settles");
+  check(!anim.animating() && anim.value(1) == 1.0f && anim.value(4) == 0.0f, "knobs land on their targets");
+
+  // Settled: ticks report nothing to do and repaint nothing.
+  for (int i = 0; i < 3; ++i) {
+    dirty.clear();
+    check(!anim.tick(layout, dirty) && dirty.count == 0, "no frames after settling");
+  }
+}
+
+void testSingleKnobDirty(const Layout& layout) {
+  for (int knob = 0; knob < kKnobCount; ++knob) {
+    KnobAnimator anim;
+    for (int k = 0; k < kKnobCount; ++k)
+      anim.reset(k, 0.3f);
+    anim.setTarget(knob, 0.9f);
+
+    bool exact = true, local = true;
+    while (anim.animating()) {
+      const float before = anim.value(knob);
+      DirtyRegion dirty;
+      anim.tick(layout, dirty);
+      const Rect expected = unite(layout.indicatorBounds(knob, before), layout.indicatorBounds(knob, anim.value(knob)));
+      exact = exact && dirty.count == 1 && sameRect(dirty.rects[0], expected);
+      for (int other = 0; other < kKnobCount; ++other)
+        if (other != knob && dirty.count > 0 && dirty.rects[0].intersects(layout.indicatorBounds(other, 0.3f)))
+          local = false;
+    }
+    check(exact, "a knob change dirties its old and new indicator bounds only");
+    check(local, "a knob change does not touch other indicators");
+  }
+}
+
+void testMerge() {
+  DirtyRegion d;
+  d.add(Rect { 0, 0, 10, 10 });
+  d.add(Rect { 5, 5, 20, 20 });
+  check(d.count == 1 && sameRect(d.rects[0], Rect { 0, 0, 20, 20 }), "overlapping rects merge");
+
+  d.add(Rect { 30, 30, 40, 40 });
+  check(d.count == 2, "disjoint rects stay apart");
+  d.add(Rect { 15, 15, 35, 35 });
+  check(d.count == 1 && sameRect(d.rects[0], Rect { 0, 0, 40, 40 }), "a bridging rect merges both");
+
+  d.add(Rect { 2, 2, 4, 4 });
+  check(d.count == 1 && sameRect(d.rects[0], Rect { 0, 0, 40, 40 }), "a contained rect adds nothing");
+  d.add(Rect {});
+  check(d.count == 1, "empty rects are ignored");
+
+  // More disjoint rects than slots: the overflow is folded into the last
+  // one, and everything added stays covered.
+  DirtyRegion full;
+  for (int i = 0; i <= DirtyRegion::kMaxRects; ++i)
+    full.add(Rect { i * 20, 0, i * 20 + 10, 10 });
+  bool covered = true;
+  for (int i = 0; i <= DirtyRegion::kMaxRects; ++i) {
+    bool any = false;
+    for (int j = 0; j < full.count; ++j)
+      any = any || within(Rect { i * 20, 0, i * 20 + 10, 10 }, full.rects[j]);
+    covered = covered && any;
+  }
+  check(full.count == DirtyRegion::kMaxRects && covered, "overflow stays covered");
+}
+
+} // namespace
+
+int main() {
+  // The design size and a 1.5x window.
+  for (int scale2 : { 2, 3 }) {
+    Layout layout;
+    layout.setClientSize(kDesignWidth * scale2 / 2, kDesignHeight * scale2 / 2);
+    testSettling(layout);
+    testSingleKnobDirty(layout);
+  }
+  testMerge();
+  std::printf("%s\n", failed ? "FAILED" : "ok");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,340 @@
+// Faceplate decoding and scaling (image.h).
+//
+// Both shipped faceplates must decode to the checked-in checksums (FNV-1a
+// over the premultiplied pixels, computed with an independent decoder).
+// Truncated and corrupted copies must be rejected, a hand-built PNG whose
+// zlib stream is made of stored blocks must decode exactly, a dynamic block
+// with out-of-range code counts must be rejected, and resample()
+// must copy at 1x and stay within the source's local range (and keep its
+// mean) at 1.5x and 2x, enlarging the 1x art and shrinking the 2x art.
+//
+//   image_test <resource dir>
+
+#include "image.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace SvenderBass::UI;
+
+namespace {
+
+int failed = 0;
+
+void check(bool ok, const char* what) {
+  if (ok)
+    return;
+  ++failed;
+  std::printf("FAIL %s\n", what);
+}
+
+std::vector<uint8_t> readFile(const std::string& path) {
+  std::vector<uint8_t> data;
+  if (FILE* f = std::fopen(path.c_str(), "rb")) {
+    uint8_t buf[65536];
+    for (size_t n; (n = std::fread(buf, 1, sizeof(buf), f)) > 0;)
+      data.insert(data.end(), buf, buf + n);
+    std::fclose(f);
+  }
+  return data;
+}
+
+uint64_t fnv1a(const Image& img) {
+  uint64_t h = 0xcbf29ce484222325ull;
+  for (uint32_t p : img.pixels) {
+    for (int b = 0; b < 4; ++b) {
+      h ^= (p >> (8 * b)) & 0xff;
+      h *= 0x100000001b3ull;
+    }
+  }
+  return h;
+}
+
+bool decode(const std::vector<uint8_t>& data, Image& out) { return decodePng(data.data(), data.size(), out); }
+
+uint32_t be32(const uint8_t* p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+// Offset and length of every IDAT chunk's data.
+std::vector<std::pair<size_t, size_t>> idatChunks(const std::vector<uint8_t>& png) {
+  std::vector<std::pair<size_t, size_t>> chunks;
+  for (size_t pos = 8; pos + 12 <= png.size();) {
+    const uint32_t len = be32(&png[pos]);
+    if (std::string((const char*)&png[pos + 4], 4) == "IDAT")
+      chunks.emplace_back(pos + 8, len);
+    pos += 12 + len;
+  }
+  return chunks;
+}
+
+// --- Building a PNG by hand -------------------------------------------------
+
+uint32_t crc32(const uint8_t* p, size_t n) {
+  uint32_t c = 0xffffffffu;
+  for (size_t i = 0; i < n; ++i) {
+    c ^= p[i];
+    for (int k = 0; k < 8; ++k)
+      c = (c >> 1) ^ (0xedb88320u & (0u - (c & 1)));
+  }
+  return ~c;
+}
+
+void putBe32(std::vector<uint8_t>& v, uint32_t x) {
+  for (int s = 24; s >= 0; s -= 8)
+    v.push_back((uint8_t)(x >> s));
+}
+
+void putChunk(std::vector<uint8_t>& png, const char* type, const std::vector<uint8_t>& body) {
+  putBe32(png, (uint32_t)body.size());
+  const size_t start = png.size();
+  png.insert(png.end(), type, type + 4);
+  png.insert(png.end(), body.begin(), body.end());
+  putBe32(png, crc32(&png[start], png.size() - start));
+}
+
+// 8-bit RGBA PNG around a zlib stream.
+std::vector<uint8_t> rgbaPng(int width, int height, const std::vector<uint8_t>& z) {
+  std::vector<uint8_t> png = { 0x89, 'P', 'N', 'G', 0x0d, 0x0a, 0x1a, 0x0a };
+  std::vector<uint8_t> ihdr;
+  putBe32(ihdr, (uint32_t)width);
+  putBe32(ihdr, (uint32_t)height);
+  ihdr.insert(ihdr.end(), { 8, 6, 0, 0, 0 });
+  putChunk(png, "IHDR", ihdr);
+  putChunk(png, "IDAT", z);
+  putChunk(png, "IEND", {});
+  return png;
+}
+
+// PNG whose zlib stream stores raw (filtered) scanlines in uncompressed
+// deflate blocks of at most blockSize bytes.
+std::vector<uint8_t> storedPng(int width, int height, const std::vector<uint8_t>& raw, size_t blockSize) {
+  std::vector<uint8_t> z = { 0x78, 0x01 };
+  for (size_t pos = 0; pos < raw.size();) {
+    const size_t len = std::min(blockSize, raw.size() - pos);
+    z.push_back(pos + len == raw.size() ? 1 : 0); // BFINAL, BTYPE 00
+    z.insert(z.end(), { (uint8_t)len, (uint8_t)(len >> 8), (uint8_t)~len, (uint8_t)(~len >> 8) });
+    z.insert(z.end(), raw.begin() + (long)pos, raw.begin() + (long)(pos + len));
+    pos += len;
+  }
+  uint32_t a = 1, b = 0;
+  for (uint8_t x : raw) {
+    a = (a + x) % 65521;
+    b = (b + a) % 65521;
+  }
+  putBe32(z, (b << 16) | a);
+  return rgbaPng(width, height, z);
+}
+
+// Deflate bits, least significant first.
+struct BitWriter {
+  std::vector<uint8_t> bytes;
+  int used = 8;
+
+  void put(uint32_t value, int n) {
+    for (int i = 0; i < n; ++i, ++used) {
+      if (used == 8) {
+        bytes.push_back(0);
+        used = 0;
+      }
+      bytes.back() |= (uint8_t)(((value >> i) & 1) << used);
+    }
+  }
+};
+
+// --- Resampling -------------------------------------------------------------
+
+int channel(uint32_t p, int c) { return (int)(p >> (24 - 8 * c)) & 0xff; }
+
+double mean(const Image& img, int c) {
+  double sum = 0.0;
+  for (uint32_t p : img.pixels)
+    sum += channel(p, c);
+  return sum / (double)img.pixels.size();
+}
+
+// Source index range [lo, hi] that output index i of n (from srcN) may read.
+void footprint(int i, int n, int srcN, int& lo, int& hi) {
+  const double r = (double)srcN / n;
+  if (n <= srcN) {
+    lo = (int)std::floor(i * r);
+    hi = std::min(srcN - 1, (int)std::ceil((i + 1) * r) - 1);
+  } else {
+    const double s = std::clamp((i + 0.5) * r - 0.5, 0.0, (double)(srcN - 1));
+    lo = (int)std::floor(s);
+    hi = std::min(srcN - 1, lo + 1);
+  }
+}
+
+// Every output channel lies within its footprint's range (both filters are
+// convex combinations, up to rounding) and the mean is kept.
+bool resamplesWithinRange(const Image& src, const Image& out) {
+  for (int y = 0; y < out.height; ++y) {
+    int y0, y1;
+    footprint(y, out.height, src.height, y0, y1);
+    for (int x = 0; x < out.width; ++x) {
+      int x0, x1;
+      footprint(x, out.width, src.width, x0, x1);
+      for (int c = 0; c < 4; ++c) {
+        int lo = 255, hi = 0;
+        for (int sy = y0; sy <= y1; ++sy)
+          for (int sx = x0; sx <= x1; ++sx) {
+            const int v = channel(src.pixels[(size_t)sy * src.width + sx], c);
+            lo = std::min(lo, v);
+            hi = std::max(hi, v);
+          }
+        const int v = channel(out.pixels[(size_t)y * out.width + x], c);
+        if (v < lo - 1 || v > hi + 1)
+          return false;
+      }
+    }
+  }
+  for (int c = 0; c < 4; ++c)
+    if (std::fabs(mean(src, c) - mean(out, c)) > 1.0)
+      return false;
+  return true;
+}
+
+void testFaceplates(const std::string& dir, Image& face1x, Image& face2x) {
+  struct Reference {
+    const char* file;
+    int width, height;
+    uint64_t checksum;
+    Image* image;
+  };
+  const Reference refs[] = {
+    { "faceplate.png",    1200, 450, 0x8ed9bf74ea3e6e31ull, &face1x },
+    { "faceplate@2x.png", 2400, 900, 0xed9e4e596d967a70ull, &face2x },
+  };
+  for (const Reference& r : refs) {
+    const std::vector<uint8_t> png = readFile(dir + "/" + r.file);
+    Image& img = *r.image;
+    const bool ok = !png.empty() && decode(png, img);
+    if (!ok || img.width != r.width || img.height != r.height || fnv1a(img) != r.checksum) {
+      ++failed;
+      std::printf("FAIL %s: decoded %d, %dx%d, checksum %016llx\n", r.file, ok, img.width, img.height,
+                  (unsigned long long)fnv1a(img));
+      continue;
+    }
+
+    // Truncated: header only, mid-stream, and inside the last IDAT chunk.
+    const size_t lastIdatEnd = idatChunks(png).back().first + idatChunks(png).back().second;
+    for (size_t cut : { (size_t)8, (size_t)33, png.size() / 4, png.size() / 2, lastIdatEnd - 4 }) {
+      const std::vector<uint8_t> part(png.begin(), png.begin() + (long)cut);
+      Image t;
+      check(!decode(part, t) && t.empty(), "truncated faceplate rejected");
+    }
+
+    // Corrupted: the zlib header, and single bytes in the compressed data.
+    const auto idat = idatChunks(png);
+    std::vector<size_t> flips = { idat.front().first };
+    for (const auto& chunk : { idat.front(), idat.back() })
+      flips.push_back(chunk.first + chunk.second / 2);
+    for (size_t at : flips) {
+      std::vector<uint8_t> bad = png;
+      bad[at] ^= 0x5a;
+      Image t;
+      check(!decode(bad, t) && t.empty(), "corrupted faceplate rejected");
+    }
+  }
+}
+
+void testStoredBlocks() {
+  // 3x2 RGBA: an opaque row with no filter, a translucent row with the Up
+  // filter (bytes are deltas from the row above).
+  const std::vector<uint8_t> raw = {
+    0, 255, 0, 0, 255,   0, 255, 0, 255,   0, 0, 255, 255,
+    2, 0, 0, 0, 129,     0, 0, 0, 0,       0, 0, 1, 1,
+  };
+  const uint32_t expected[6] = {
+    0xffff0000u, 0xff00ff00u, 0xff0000ffu,
+    0x80800000u, 0xff00ff00u, 0x00000000u,
+  };
+  // One block, and the same stream split into three.
+  for (size_t blockSize : { raw.size(), (size_t)10 }) {
+    Image img;
+    const bool ok = decode(storedPng(3, 2, raw, blockSize), img);
+    check(ok && img.width == 3 && img.height == 2 && std::equal(img.pixels.begin(), img.pixels.end(), expected),
+          blockSize == raw.size() ? "stored block decodes" : "split stored blocks decode");
+  }
+
+  // A stored block whose LEN/NLEN disagree.
+  std::vector<uint8_t> bad = storedPng(3, 2, raw, raw.size());
+  bad[idatChunks(bad).front().first + 5] ^= 0x01; // NLEN low byte
+  Image img;
+  check(!decode(bad, img) && img.empty(), "stored block with bad NLEN rejected");
+}
+
+void testMalformedDynamicBlock() {
+  // HLIT = 288 and HDIST = 32, past the 286 and 30 deflate allows, then
+  // code-length runs that fill all 320: 138 + 138 + 44 zeros (symbol 18, the
+  // only code-length code, one bit long).
+  BitWriter bw;
+  bw.put(1, 1);  // BFINAL
+  bw.put(2, 2);  // dynamic Huffman
+  bw.put(31, 5); // HLIT - 257
+  bw.put(31, 5); // HDIST - 1
+  bw.put(0, 4);  // HCLEN - 4: lengths for 16, 17, 18, 0
+  bw.put(0, 3);
+  bw.put(0, 3);
+  bw.put(1, 3);
+  bw.put(0, 3);
+  for (int rep : { 138, 138, 44 }) {
+    bw.put(0, 1);        // symbol 18
+    bw.put(rep - 11, 7); // run length
+  }
+  std::vector<uint8_t> z = { 0x78, 0x01 };
+  z.insert(z.end(), bw.bytes.begin(), bw.bytes.end());
+  z.insert(z.end(), { 0, 0, 0, 1 });
+  Image img;
+  check(!decode(rgbaPng(1, 1, z), img) && img.empty(), "dynamic block with HLIT 288 / HDIST 32 rejected");
+}
+
+void testResample(const Image& face1x, const Image& face2x) {
+  if (face1x.empty() || face2x.empty())
+    return;
+
+  const Image same = resample(face1x, face1x.width, face1x.height);
+  check(same.width == face1x.width && same.height == face1x.height && same.pixels == face1x.pixels,
+        "resample 1x copies");
+
+  // Enlarging the 1x art (bilinear), and shrinking the 2x art to 1.5x (area
+  // average), as the cache does around the design size.
+  const Image up15 = resample(face1x, face1x.width * 3 / 2, face1x.height * 3 / 2);
+  const Image up2 = resample(face1x, face1x.width * 2, face1x.height * 2);
+  const Image down15 = resample(face2x, face1x.width * 3 / 2, face1x.height * 3 / 2);
+  check(up15.width == 1800 && up15.height == 675 && resamplesWithinRange(face1x, up15), "resample 1x art to 1.5x");
+  check(up2.width == 2400 && up2.height == 900 && resamplesWithinRange(face1x, up2), "resample 1x art to 2x");
+  check(down15.width == 1800 && down15.height == 675 && resamplesWithinRange(face2x, down15),
+        "resample 2x art to 1.5x");
+
+  // A flat image stays exactly flat at every factor.
+  Image flat;
+  flat.width = 40;
+  flat.height = 30;
+  flat.pixels.assign(40 * 30, 0x80402010u);
+  for (double scale : { 1.0, 1.5, 2.0, 0.75 }) {
+    const Image r = resample(flat, (int)(40 * scale), (int)(30 * scale));
+    check(std::all_of(r.pixels.begin(), r.pixels.end(), [](uint32_t p) { return p == 0x80402010u; }),
+          "flat image stays flat");
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::printf("usage: image_test <resource dir>\n");
+    return 2;
+  }
+  Image face1x, face2x;
+  testFaceplates(argv[1], face1x, face2x);
+  testStoredBlocks();
+  testMalformedDynamicBlock();
+  testResample(face1x, face2x);
+  std::printf("%s\n", failed ? "FAILED" : "ok");
+  return failed ? 1 : 0;
+}
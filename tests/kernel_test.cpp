@@ -0,0 +1,149 @@
+// The dispatched kernels must match the generic ones.
+//
+// Runs the active kernel table (kernels(), so SVENDER_DSP_ISA picks the
+// variant) and the generic table over the same input and checks the largest
+// absolute difference against a per-kernel tolerance. Block lengths other
+// than the control interval cover the vector tails. ctest runs this once per
+// ISA; a variant the CPU cannot run exits 77 (skipped).
+//
+// parallelBiquads is the cascade's partial-fraction form, checked against
+// the generic cascade on both channels, so its tolerance is the design
+// error, not the rounding.
+
+#include "kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace SvenderBass;
+
+namespace {
+
+constexpr int kLength = 1 << 14;
+
+struct Input {
+  std::vector<float> x;
+  std::vector<float> drive;
+};
+
+Input makeInput() {
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+  std::uniform_real_distribution<float> drv(1.0f, 40.0f);
+  Input in;
+  in.x.resize(kLength);
+  in.drive.resize(kLength);
+  for (int i = 0; i < kLength; ++i) {
+    in.x[i] = 0.6f * std::sin(0.013f * (float)i) + 0.1f * noise(rng);
+    in.drive[i] = drv(rng);
+  }
+  return in;
+}
+
+void makeCascade(DSP::Biquad* bq, float sr) {
+  bq[0].setLowShelf(sr, 40.0f, 2.0f);
+  bq[1].setPeaking(sr, 500.0f, -10.0f, 0.9f);
+  bq[2].setHighShelf(sr, 8000.0f, 9.0f);
+  bq[3].setLowShelf(sr, 40.0f, 6.0f);
+  bq[4].setPeaking(sr, 800.0f, 4.0f, 0.9f);
+  bq[5].setHighShelf(sr, 4000.0f, -3.0f);
+}
+
+std::vector<float> runCascade(const DSP::KernelTable& k, const Input& in, int block) {
+  DSP::Biquad bq[6];
+  makeCascade(bq, 48000.0f);
+  std::vector<float> y = in.x;
+  for (int i = 0; i < kLength; i += block)
+    k.biquadCascade(bq, 6, &y[i], std::min(block, kLength - i));
+  return y;
+}
+
+std::vector<float> runParallel(const DSP::KernelTable& k, const Input& in, int block) {
+  DSP::Biquad bq[6];
+  makeCascade(bq, 48000.0f);
+  DSP::ParallelBiquads pb;
+  if (!pb.design(bq, 6))
+    return {};
+  std::vector<float> l = in.x, r = in.x;
+  for (int i = 0; i < kLength; i += block)
+    k.parallelBiquads(pb, &l[i], &r[i], std::min(block, kLength - i));
+  l.insert(l.end(), r.begin(), r.end());
+  return l;
+}
+
+std::vector<float> runSaturate(const DSP::KernelTable& k, const Input& in, int block) {
+  DSP::Oversampler4x os;
+  os.setSampleRate(48000.0f);
+  std::vector<float> y = in.x;
+  for (int i = 0; i < kLength; i += block)
+    k.saturate4x(os, &y[i], &in.drive[i], std::min(block, kLength - i));
+  return y;
+}
+
+std::vector<float> runStats(const DSP::KernelTable& k, const Input& in, int block) {
+  std::vector<float> y;
+  for (int i = 0; i < kLength; i += block) {
+    float peak = 0.0f, sumSq = 0.0f;
+    k.peakSumSquares(&in.x[i], std::min(block, kLength - i), &peak, &sumSq);
+    y.push_back(peak);
+    y.push_back(sumSq);
+  }
+  return y;
+}
+
+double maxDiff(const std::vector<float>& a, const std::vector<float>& b) {
+  if (a.empty() || a.size() != b.size())
+    return INFINITY;
+  double m = 0.0;
+  for (size_t i = 0; i < a.size(); ++i)
+    m = std::max(m, (double)std::fabs(a[i] - b[i]));
+  return m;
+}
+
+} // namespace
+
+int main() {
+  const DSP::KernelTable& active = DSP::kernels();
+  if (const char* want = std::getenv("SVENDER_DSP_ISA")) {
+    if (std::strcmp(want, active.name) != 0) {
+      std::printf("%s not available on this CPU (active: %s), skipped\n", want, active.name);
+      return 77;
+    }
+  }
+
+  const Input in = makeInput();
+  const DSP::KernelTable& ref = *DSP::kernelsFor(DSP::Isa::Generic);
+  const int blocks[] = { DSP::kControlInterval, 1, 7, 13, 100 };
+  int failed = 0;
+  for (int block : blocks) {
+    const auto refCascade = runCascade(ref, in, block);
+    auto refPair = refCascade;
+    refPair.insert(refPair.end(), refCascade.begin(), refCascade.end());
+
+    struct Check {
+      const char* kernel;
+      double dev;
+      double tolerance;
+    };
+    const Check checks[] = {
+      { "biquadCascade",   maxDiff(refCascade, runCascade(active, in, block)),                      1e-5 },
+      { "parallelBiquads", maxDiff(refPair, runParallel(active, in, block)),                        2e-3 },
+      { "saturate4x",      maxDiff(runSaturate(ref, in, block), runSaturate(active, in, block)),    1e-4 },
+      { "peakSumSquares",  maxDiff(runStats(ref, in, block), runStats(active, in, block)),          1e-5 },
+    };
+    for (const Check& c : checks) {
+      if (c.dev <= c.tolerance)
+        continue;
+      ++failed;
+      std::printf("FAIL %s %s block %d: max abs dev %.3g > %.3g\n", active.name, c.kernel, block, c.dev,
+                  c.tolerance);
+    }
+  }
+  std::printf("%s: %s\n", active.name, failed ? "FAILED" : "ok");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,377 @@
+// Client for reampd.
+//
+//   reamp_client [--socket path] process <in.f32> <out.f32> [--rate Hz] [--mono] [name=value ...]
+//       Renders raw 32-bit float audio (interleaved stereo, or mono with
+//       --mono) through the daemon. Parameters are normalized, by name:
+//       input bass mid treble mid_freq drive output ultra_low ultra_high
+//       sat_mode tuner tuner_mute crossover tone_stack.
+//
+//   reamp_client [--socket path] load [--jobs N] [--concurrency C] [--seconds S] [--rate Hz]
+//       Load test: C connections at a time render N synthetic jobs of S
+//       seconds with random settings. Prints throughput in multiples of real
+//       time and the job latency distribution.
+
+#include "dsp.h"
+#include "reamp_protocol.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace SvenderBass::Reamp;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char* const kParamNames[SVENDER_PARAM_COUNT] = {
+  "input", "bass", "mid", "treble", "mid_freq", "drive", "output",
+  "ultra_low", "ultra_high", "sat_mode", "tuner", "tuner_mute", "crossover",
+  "tone_stack",
+};
+
+bool recvAll(int fd, void* data, size_t size) {
+  char* p = (char*)data;
+  while (size > 0) {
+    const ssize_t n = recv(fd, p, size, 0);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    p += n;
+    size -= (size_t)n;
+  }
+  return true;
+}
+
+// Fills a block, returns its frame count; 0 ends the input.
+using Source = std::function<int(Block&)>;
+using Sink = std::function<void(const Block&)>;
+
+struct Result {
+  bool ok = false;
+  bool warm = false;
+  uint64_t frames = 0;
+  double processSeconds = 0.0;
+  std::string error;
+};
+
+// One job: a fresh shared region, one connection, both rings serviced from
+// this thread until every block has come back.
+Result runJob(const std::string& socketPath, const JobRequest& req, const Source& source, const Sink& sink) {
+  Result res;
+  static std::atomic<unsigned> counter {0};
+  const std::string name = "/svender-reamp-" + std::to_string(getpid()) + "-" + std::to_string(counter++);
+  const int shmFd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (shmFd < 0) {
+    res.error = std::string("shm_open: ") + std::strerror(errno);
+    return res;
+  }
+  shm_unlink(name.c_str());
+  void* mem = nullptr;
+  if (ftruncate(shmFd, sizeof(SharedJob)) != 0 ||
+      (mem = mmap(nullptr, sizeof(SharedJob), PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0)) == MAP_FAILED) {
+    res.error = std::string("shared memory: ") + std::strerror(errno);
+    close(shmFd);
+    return res;
+  }
+  auto* shared = new (mem) SharedJob();
+  shared->magic = kMagic;
+  shared->version = kVersion;
+
+  const int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  sockaddr_un addr {};
+  addr.sun_family = AF_UNIX;
+  std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+
+  auto fail = [&](const std::string& what) {
+    res.error = what;
+    close(sock);
+    munmap(mem, sizeof(SharedJob));
+    close(shmFd);
+    return res;
+  };
+
+  if (sock < 0 || connect(sock, (sockaddr*)&addr, sizeof(addr)) != 0)
+    return fail("connect " + socketPath + ": " + std::strerror(errno));
+
+  char control[CMSG_SPACE(sizeof(int))] = {};
+  iovec iov { const_cast<JobRequest*>(&req), sizeof(req) };
+  msghdr msg {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  cmsghdr* c = CMSG_FIRSTHDR(&msg);
+  c->cmsg_level = SOL_SOCKET;
+  c->cmsg_type = SCM_RIGHTS;
+  c->cmsg_len = CMSG_LEN(sizeof(int));
+  std::memcpy(CMSG_DATA(c), &shmFd, sizeof(int));
+  if (sendmsg(sock, &msg, MSG_NOSIGNAL) != (ssize_t)sizeof(req))
+    return fail(std::string("send request: ") + std::strerror(errno));
+
+  JobReply reply {};
+  if (!recvAll(sock, &reply, sizeof(reply)))
+    return fail("no reply from daemon");
+  if (reply.status == kBusy)
+    return fail("daemon is shutting down");
+  if (reply.status != kOk)
+    return fail("daemon rejected the job (" + std::to_string(reply.status) + ")");
+  res.warm = reply.warm != 0;
+
+  BlockRing& in = shared->in;
+  BlockRing& out = shared->out;
+  uint64_t sent = 0, received = 0;
+  bool inputDone = false;
+  int idle = 0;
+  JobDone done {};
+  bool haveDone = false;
+  while (!inputDone || received < sent) {
+    bool progress = false;
+    while (!inputDone) {
+      Block* b = in.writable();
+      if (!b) break;
+      const int n = source(*b);
+      if (n <= 0) {
+        shared->inputDone.store(1, std::memory_order_release);
+        inputDone = true;
+        break;
+      }
+      b->frames = n;
+      in.commit();
+      sent += (uint64_t)n;
+      progress = true;
+    }
+    while (Block* b = out.readable()) {
+      sink(*b);
+      received += (uint64_t)b->frames;
+      out.release();
+      progress = true;
+    }
+    if (progress) {
+      idle = 0;
+      continue;
+    }
+    // Nothing to do: spin briefly, then sleep and watch for an early
+    // JobDone (the daemon gave up on the job).
+    if (++idle < 64) {
+      std::this_thread::yield();
+      continue;
+    }
+    pollfd pfd { sock, POLLIN, 0 };
+    if (poll(&pfd, 1, 0) > 0) {
+      haveDone = recvAll(sock, &done, sizeof(done));
+      if (!haveDone || done.status != kOk)
+        return fail("job aborted by daemon");
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+
+  if (!haveDone && !recvAll(sock, &done, sizeof(done)))
+    return fail("connection lost before completion");
+  if (done.status != kOk)
+    return fail("job failed (" + std::to_string(done.status) + ")");
+  res.ok = true;
+  res.frames = done.frames;
+  res.processSeconds = done.processSeconds;
+  close(sock);
+  munmap(mem, sizeof(SharedJob));
+  close(shmFd);
+  return res;
+}
+
+JobRequest makeRequest(double sampleRate, int channels) {
+  JobRequest req {};
+  req.magic = kMagic;
+  req.version = kVersion;
+  req.channels = (uint32_t)channels;
+  req.sampleRate = sampleRate;
+  return req;
+}
+
+bool setParam(JobRequest& req, const std::string& assignment) {
+  const size_t eq = assignment.find('=');
+  if (eq == std::string::npos) return false;
+  const std::string name = assignment.substr(0, eq);
+  for (int id = 0; id < SVENDER_PARAM_COUNT; ++id) {
+    if (name == kParamNames[id]) {
+      req.params[id] = std::clamp(std::atof(assignment.c_str() + eq + 1), 0.0, 1.0);
+      req.paramMask |= 1u << id;
+      return true;
+    }
+  }
+  return false;
+}
+
+int processFile(const std::string& socketPath, int argc, char** argv) {
+  if (argc < 2) return 2;
+  const std::string inPath = argv[0], outPath = argv[1];
+  double rate = 48000.0;
+  int channels = 2;
+  JobRequest req = makeRequest(rate, channels);
+  for (int i = 2; i < argc; ++i) {
+    const std::string a = argv[i];
+    if (a == "--rate" && i + 1 < argc) rate = std::atof(argv[++i]);
+    else if (a == "--mono") channels = 1;
+    else if (!setParam(req, a)) {
+      std::fprintf(stderr, "reamp_client: unknown argument %s\n", a.c_str());
+      return 2;
+    }
+  }
+  req.sampleRate = rate;
+  req.channels = (uint32_t)channels;
+
+  FILE* fin = std::fopen(inPath.c_str(), "rb");
+  FILE* fout = std::fopen(outPath.c_str(), "wb");
+  if (!fin || !fout) {
+    std::fprintf(stderr, "reamp_client: cannot open %s\n", !fin ? inPath.c_str() : outPath.c_str());
+    return 1;
+  }
+
+  std::vector<float> frame((size_t)kBlockFrames * channels);
+  const Source source = [&](Block& b) {
+    const int n = (int)std::fread(frame.data(), sizeof(float) * channels, kBlockFrames, fin);
+    for (int i = 0; i < n; ++i) {
+      b.l[i] = frame[(size_t)i * channels];
+      if (channels == 2) b.r[i] = frame[(size_t)i * 2 + 1];
+    }
+    return n;
+  };
+  std::vector<float> outFrame((size_t)kBlockFrames * channels);
+  bool writeOk = true;
+  const Sink sink = [&](const Block& b) {
+    for (int i = 0; i < b.frames; ++i) {
+      outFrame[(size_t)i * channels] = b.l[i];
+      if (channels == 2) outFrame[(size_t)i * 2 + 1] = b.r[i];
+    }
+    writeOk &= std::fwrite(outFrame.data(), sizeof(float) * channels, (size_t)b.frames, fout) == (size_t)b.frames;
+  };
+
+  const auto t0 = Clock::now();
+  const Result res = runJob(socketPath, req, source, sink);
+  const double wall = std::chrono::duration<double>(Clock::now() - t0).count();
+  std::fclose(fin);
+  writeOk &= std::fclose(fout) == 0;
+  if (!res.ok || !writeOk) {
+    std::fprintf(stderr, "reamp_client: %s\n", res.ok ? "write failed" : res.error.c_str());
+    return 1;
+  }
+  std::fprintf(stderr, "reamp_client: %llu frames in %.1f ms (%.1f ms processing, %s instance)\n",
+               (unsigned long long)res.frames, wall * 1e3, res.processSeconds * 1e3, res.warm ? "warm" : "cold");
+  return 0;
+}
+
+int loadTest(const std::string& socketPath, int argc, char** argv) {
+  int jobs = 64, concurrency = 8;
+  double seconds = 10.0, rate = 48000.0;
+  for (int i = 0; i + 1 < argc; i += 2) {
+    const std::string a = argv[i];
+    if (a == "--jobs") jobs = std::max(1, std::atoi(argv[i + 1]));
+    else if (a == "--concurrency") concurrency = std::max(1, std::atoi(argv[i + 1]));
+    else if (a == "--seconds") seconds = std::atof(argv[i + 1]);
+    else if (a == "--rate") rate = std::atof(argv[i + 1]);
+    else return 2;
+  }
+  const uint64_t framesPerJob = (uint64_t)(seconds * rate);
+
+  std::atomic<int> nextJob {0};
+  std::atomic<int> warm {0};
+  std::mutex mutex;
+  std::vector<double> latencies;
+  std::vector<std::string> errors;
+
+  const auto t0 = Clock::now();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < concurrency; ++t) {
+    threads.emplace_back([&] {
+      for (int j; (j = nextJob.fetch_add(1)) < jobs;) {
+        std::mt19937 rng((unsigned)j);
+        std::uniform_real_distribution<double> u(0.0, 1.0);
+        JobRequest req = makeRequest(rate, j % 4 == 3 ? 1 : 2);
+        for (int id = 0; id < SVENDER_PARAM_COUNT; ++id) {
+          if (id == SVENDER_PARAM_TUNER) continue;
+          req.params[id] = u(rng);
+          req.paramMask |= 1u << id;
+        }
+
+        // A plucked low E with a little upper content.
+        uint64_t pos = 0;
+        const double f = 41.2 * (1.0 + 0.5 * u(rng));
+        const Source source = [&](Block& b) {
+          const int n = (int)std::min<uint64_t>(kBlockFrames, framesPerJob - pos);
+          for (int i = 0; i < n; ++i, ++pos) {
+            const double t = (double)pos / rate;
+            const double env = std::exp(-2.0 * std::fmod(t, 1.5));
+            const double ph = 2.0 * SvenderBass::DSP::kPiD * f * t;
+            b.l[i] = b.r[i] = (float)(0.5 * env * (std::sin(ph) + 0.3 * std::sin(2.0 * ph) + 0.1 * std::sin(5.0 * ph)));
+          }
+          return n;
+        };
+        const Sink sink = [](const Block&) {};
+
+        const auto start = Clock::now();
+        const Result res = runJob(socketPath, req, source, sink);
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        std::lock_guard<std::mutex> lock(mutex);
+        if (res.ok && res.frames == framesPerJob) {
+          latencies.push_back(ms);
+          warm += res.warm;
+        } else {
+          errors.push_back(res.ok ? "short job" : res.error);
+        }
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  const double wall = std::chrono::duration<double>(Clock::now() - t0).count();
+
+  for (const auto& e : errors) std::fprintf(stderr, "reamp_client: %s\n", e.c_str());
+  if (latencies.empty()) return 1;
+  std::sort(latencies.begin(), latencies.end());
+  auto pct = [&](double p) { return latencies[std::min(latencies.size() - 1, (size_t)(p * (double)(latencies.size() - 1) + 0.5))]; };
+  const double audio = (double)latencies.size() * seconds;
+  std::printf("jobs,concurrency,seconds_each,wall_s,realtime_x,p50_ms,p99_ms,max_ms,warm,failed\n");
+  std::printf("%d,%d,%.2f,%.2f,%.1f,%.1f,%.1f,%.1f,%d,%zu\n", jobs, concurrency, seconds, wall, audio / wall,
+              pct(0.5), pct(0.99), latencies.back(), warm.load(), errors.size());
+  return errors.empty() ? 0 : 1;
+}
+
+int usage() {
+  std::fprintf(stderr,
+               "usage: reamp_client [--socket path] process <in.f32> <out.f32> [--rate Hz] [--mono] [name=value ...]\n"
+               "       reamp_client [--socket path] load [--jobs N] [--concurrency C] [--seconds S] [--rate Hz]\n");
+  return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  std::string socketPath = defaultSocketPath();
+  int i = 1;
+  if (i + 1 < argc && std::strcmp(argv[i], "--socket") == 0) {
+    socketPath = argv[i + 1];
+    i += 2;
+  }
+  if (i >= argc) return usage();
+  const std::string cmd = argv[i++];
+  int rc = 2;
+  if (cmd == "process") rc = processFile(socketPath, argc - i, argv + i);
+  else if (cmd == "load") rc = loadTest(socketPath, argc - i, argv + i);
+  return rc == 2 ? usage() : rc;
+}
@@ -0,0 +1,109 @@
+#pragma once
+// Wire format between reampd and its clients (POSIX only).
+//
+// A job is one connection to the daemon's UNIX socket. The client creates a
+// shared-memory region holding a SharedJob, sends a JobRequest with the
+// region's file descriptor attached (SCM_RIGHTS) and receives a JobReply.
+// Audio then moves through the two block rings in the region without any
+// further socket traffic: the client fills `in`, the daemon processes each
+// block straight from `in` into `out`. The client raises inputDone after its
+// last block; the daemon answers with a JobDone on the socket once `out`
+// holds every processed block.
+
+#include "svender_dsp.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+
+namespace SvenderBass::Reamp {
+
+constexpr uint32_t kMagic = 0x41525653; // "SVRA"
+constexpr uint32_t kVersion = 2;
+
+constexpr int kBlockFrames = 512;
+constexpr uint32_t kRingBlocks = 64; // power of two
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "ring indices are shared between processes");
+
+// Planar audio, frames <= kBlockFrames. Mono jobs use l only.
+struct Block {
+  int32_t frames;
+  float l[kBlockFrames];
+  float r[kBlockFrames];
+};
+
+// Single-producer / single-consumer ring over shared memory. Indices run
+// freely; the producer owns write, the consumer owns read.
+struct BlockRing {
+  alignas(64) std::atomic<uint32_t> write;
+  alignas(64) std::atomic<uint32_t> read;
+  alignas(64) Block blocks[kRingBlocks];
+
+  // Producer side: the next free block, or nullptr while full.
+  Block* writable() {
+    const uint32_t w = write.load(std::memory_order_relaxed);
+    return (w - read.load(std::memory_order_acquire) < kRingBlocks) ? &blocks[w & (kRingBlocks - 1)] : nullptr;
+  }
+  void commit() { write.store(write.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+  // Consumer side: the oldest filled block, or nullptr while empty.
+  Block* readable() {
+    const uint32_t r = read.load(std::memory_order_relaxed);
+    return (r != write.load(std::memory_order_acquire)) ? &blocks[r & (kRingBlocks - 1)] : nullptr;
+  }
+  void release() { read.store(read.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+  // Number of filled blocks; larger than kRingBlocks only if the other side
+  // wrote garbage into the indices.
+  uint32_t filled() const { return write.load(std::memory_order_acquire) - read.load(std::memory_order_acquire); }
+};
+
+struct SharedJob {
+  uint32_t magic;
+  uint32_t version;
+  std::atomic<uint32_t> inputDone;
+  BlockRing in, out;
+};
+
+enum : uint32_t { kParamsAll = (1u << SVENDER_PARAM_COUNT) - 1 };
+
+struct JobRequest {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t channels;  // 1 or 2
+  uint32_t paramMask; // bit per svender_dsp_param; unset ones use defaults
+  double sampleRate;
+  double params[SVENDER_PARAM_COUNT];
+};
+
+enum Status : int32_t {
+  kOk = 0,
+  kBadRequest = -1, // malformed request or shared region
+  kBusy = -2,       // daemon shutting down
+  kAborted = -3,    // ring indices corrupted
+};
+
+struct JobReply {
+  int32_t status;
+  uint32_t jobId;
+  uint32_t warm; // 1 if a pooled instance took the job
+};
+
+struct JobDone {
+  int32_t status;
+  uint32_t jobId;
+  uint64_t frames;
+  double processSeconds; // CPU time spent in Engine::process for this job
+};
+
+// $XDG_RUNTIME_DIR/svender-reampd.sock, else /tmp/svender-reampd-<uid>.sock.
+inline std::string defaultSocketPath() {
+  if (const char* dir = std::getenv("XDG_RUNTIME_DIR"); dir && *dir)
+    return std::string(dir) + "/svender-reampd.sock";
+  return "/tmp/svender-reampd-" + std::to_string((unsigned)getuid()) + ".sock";
+}
+
+} // namespace SvenderBass::Reamp
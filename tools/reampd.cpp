@@ -0,0 +1,523 @@
+// Reamp daemon: keeps warm Engine instances and renders jobs from local
+// clients (see reamp_protocol.h and reamp_client.cpp).
+//
+// Jobs arrive on a UNIX socket; their audio stays in the client's shared
+// memory. Each job is a task on a work-stealing pool: a worker processes up
+// to kQuantum blocks, then puts the job back on its own queue so long jobs
+// share the worker with their neighbours; idle workers steal from the far
+// end of the other queues. A job whose input ring is empty backs off instead
+// of blocking, so the audio path makes no syscall per block.
+//
+// The accept thread never blocks on a client: new connections wait in a
+// poll set until their request arrives (or kRequestTimeout passes), so a
+// stalled client cannot hold up the others. On SIGINT/SIGTERM, connections
+// still waiting are turned away with kBusy and queued jobs run to the end.
+//
+//   reampd [--socket path] [--threads N] [--warm N] [--rate Hz] [--verbose]
+
+#include "engine.h"
+#include "reamp_protocol.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace SvenderBass;
+using namespace SvenderBass::Reamp;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kQuantum = 8;               // blocks per turn
+constexpr int kStarvedBeforeSleep = 64;   // consecutive idle turns per worker
+constexpr int kLivenessInterval = 256;    // idle turns between client checks
+constexpr auto kRequestTimeout = std::chrono::seconds(2);
+
+std::atomic<bool> g_stop {false};
+bool g_verbose = false;
+
+// --- Warm instances ---------------------------------------------------------
+
+class EnginePool {
+public:
+  explicit EnginePool(size_t capacity) : capacity_(capacity) {
+    const Engine fresh {};
+    for (int id = 0; id < SVENDER_PARAM_COUNT; ++id)
+      defaults_[id] = fresh.getParam(id);
+  }
+
+  void prewarm(double sampleRate, int count) {
+    for (int i = 0; i < count; ++i)
+      release(create(sampleRate));
+  }
+
+  // A pooled instance at this rate if there is one, else a new one. Either
+  // way it comes back as freshly configured with the job's parameters.
+  std::unique_ptr<Engine> acquire(const JobRequest& req, bool& warm) {
+    std::unique_ptr<Engine> e;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = std::find_if(idle_.begin(), idle_.end(),
+                             [&](const auto& p) { return p->sampleRate() == req.sampleRate; });
+      if (it != idle_.end()) {
+        e = std::move(*it);
+        idle_.erase(it);
+      }
+    }
+    warm = (e != nullptr);
+    if (!e)
+      e = create(req.sampleRate);
+    for (int id = 0; id < SVENDER_PARAM_COUNT; ++id)
+      e->setParam(id, (req.paramMask & (1u << id)) ? req.params[id] : defaults_[id]);
+    e->resetToParams();
+    return e;
+  }
+
+  void release(std::unique_ptr<Engine> e) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idle_.size() < capacity_)
+      idle_.push_back(std::move(e));
+  }
+
+private:
+  static std::unique_ptr<Engine> create(double sampleRate) {
+    auto e = std::make_unique<Engine>();
+    e->configure(sampleRate, kBlockFrames);
+    return e;
+  }
+
+  size_t capacity_;
+  double defaults_[SVENDER_PARAM_COUNT] = {};
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<Engine>> idle_;
+};
+
+// --- Work-stealing pool -----------------------------------------------------
+
+enum class Step { Progressed, Starved, Done };
+
+struct Task {
+  virtual ~Task() = default;
+  virtual Step run() = 0;
+};
+
+// One queue per worker. The owner takes from the front and requeues at the
+// back (round robin over its jobs); thieves take from the back. Queued
+// counts only tasks waiting in a queue, so workers sleep while every job is
+// held by another worker.
+class WorkStealingPool {
+public:
+  explicit WorkStealingPool(int numThreads) : queues_(numThreads) {
+    for (int i = 0; i < numThreads; ++i)
+      threads_.emplace_back([this, i] { workerLoop(i); });
+  }
+
+  ~WorkStealingPool() { shutdown(); }
+
+  void submit(Task* t) {
+    const size_t w = next_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    push(w, t);
+    std::lock_guard<std::mutex> lock(idleMutex_);
+    idleCv_.notify_one();
+  }
+
+  // Runs every queued task to completion, then joins the workers.
+  void shutdown() {
+    {
+      std::lock_guard<std::mutex> lock(idleMutex_);
+      stopping_ = true;
+    }
+    idleCv_.notify_all();
+    for (auto& t : threads_)
+      if (t.joinable()) t.join();
+  }
+
+  // Jobs queued or running.
+  size_t pending() const { return queued_.load(std::memory_order_relaxed) + running_.load(std::memory_order_relaxed); }
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task*> tasks;
+  };
+
+  void push(size_t w, Task* t) {
+    {
+      std::lock_guard<std::mutex> lock(queues_[w].mutex);
+      queues_[w].tasks.push_back(t);
+    }
+    queued_.fetch_add(1, std::memory_order_release);
+  }
+
+  Task* popFront(size_t w) {
+    std::lock_guard<std::mutex> lock(queues_[w].mutex);
+    if (queues_[w].tasks.empty()) return nullptr;
+    Task* t = queues_[w].tasks.front();
+    queues_[w].tasks.pop_front();
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    return t;
+  }
+
+  Task* stealBack(size_t victim) {
+    std::unique_lock<std::mutex> lock(queues_[victim].mutex, std::try_to_lock);
+    if (!lock.owns_lock() || queues_[victim].tasks.empty()) return nullptr;
+    Task* t = queues_[victim].tasks.back();
+    queues_[victim].tasks.pop_back();
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    return t;
+  }
+
+  Task* find(size_t self) {
+    if (Task* t = popFront(self)) return t;
+    for (size_t i = 1; i < queues_.size(); ++i)
+      if (Task* t = stealBack((self + i) % queues_.size())) return t;
+    return nullptr;
+  }
+
+  void workerLoop(size_t self) {
+    int starvedRun = 0;
+    for (;;) {
+      Task* t = find(self);
+      if (!t) {
+        std::unique_lock<std::mutex> lock(idleMutex_);
+        if (stopping_ && queued_.load(std::memory_order_acquire) == 0)
+          return;
+        idleCv_.wait_for(lock, std::chrono::milliseconds(50),
+                         [&] { return stopping_ || queued_.load(std::memory_order_acquire) > 0; });
+        continue;
+      }
+
+      running_.fetch_add(1, std::memory_order_relaxed);
+      const Step s = t->run();
+      running_.fetch_sub(1, std::memory_order_relaxed);
+      if (s == Step::Done) {
+        delete t;
+        starvedRun = 0;
+        continue;
+      }
+      push(self, t);
+      if (s == Step::Progressed) {
+        starvedRun = 0;
+      } else if (++starvedRun >= kStarvedBeforeSleep) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        starvedRun = 0;
+      }
+    }
+  }
+
+  std::vector<Queue> queues_;
+  std::vector<std::thread> threads_;
+  std::atomic<size_t> next_ {0};
+  std::atomic<size_t> queued_ {0};
+  std::atomic<size_t> running_ {0};
+  std::mutex idleMutex_;
+  std::condition_variable idleCv_;
+  bool stopping_ = false;
+};
+
+// --- Jobs -------------------------------------------------------------------
+
+struct Stats {
+  std::atomic<uint64_t> jobs {0}, warm {0}, failed {0}, frames {0};
+};
+
+bool sendAll(int fd, const void* data, size_t size) {
+  const char* p = (const char*)data;
+  while (size > 0) {
+    const ssize_t n = send(fd, p, size, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    p += n;
+    size -= (size_t)n;
+  }
+  return true;
+}
+
+class Job : public Task {
+public:
+  Job(uint32_t id, int sock, SharedJob* shared, const JobRequest& req, EnginePool& pool, Stats& stats)
+      : id_(id), sock_(sock), shared_(shared), req_(req), pool_(pool), stats_(stats) {}
+
+  ~Job() override {
+    if (engine_) pool_.release(std::move(engine_));
+    munmap(shared_, sizeof(SharedJob));
+    close(sock_);
+  }
+
+  Step run() override {
+    if (!engine_) {
+      bool warm = false;
+      engine_ = pool_.acquire(req_, warm);
+      const JobReply reply { kOk, id_, warm ? 1u : 0u };
+      if (!sendAll(sock_, &reply, sizeof(reply)))
+        return finish(kAborted);
+      if (warm) stats_.warm.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    BlockRing& in = shared_->in;
+    BlockRing& out = shared_->out;
+    int done = 0;
+    double busy = 0.0;
+    while (done < kQuantum) {
+      if (in.filled() > kRingBlocks || out.filled() > kRingBlocks)
+        return finish(kAborted);
+      Block* src = in.readable();
+      Block* dst = src ? out.writable() : nullptr;
+      if (!dst) break;
+
+      const int n = std::clamp<int>(src->frames, 0, kBlockFrames);
+      const auto t0 = Clock::now();
+      if (req_.channels == 1)
+        engine_->processMono(src->l, dst->l, n);
+      else
+        engine_->process(src->l, src->r, dst->l, dst->r, n);
+      busy += std::chrono::duration<double>(Clock::now() - t0).count();
+      dst->frames = n;
+      out.commit();
+      in.release();
+      frames_ += (uint64_t)n;
+      ++done;
+    }
+    processSeconds_ += busy;
+
+    // Meters are not forwarded; keep the ring from filling.
+    svender_dsp_meters m;
+    while (engine_->popMeters(m)) {}
+
+    if (done > 0) {
+      idleTurns_ = 0;
+      return Step::Progressed;
+    }
+    if (shared_->inputDone.load(std::memory_order_acquire) && !in.readable())
+      return finish(kOk);
+    if (++idleTurns_ % kLivenessInterval == 0 && !clientAlive())
+      return finish(kAborted);
+    return Step::Starved;
+  }
+
+private:
+  bool clientAlive() const {
+    char c;
+    const ssize_t n = recv(sock_, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    return n > 0 || (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR));
+  }
+
+  Step finish(Status status) {
+    const JobDone msg { status, id_, frames_, processSeconds_ };
+    sendAll(sock_, &msg, sizeof(msg));
+    stats_.frames.fetch_add(frames_, std::memory_order_relaxed);
+    if (status != kOk) stats_.failed.fetch_add(1, std::memory_order_relaxed);
+    if (g_verbose)
+      std::fprintf(stderr, "reampd: job %u %s, %llu frames, %.1f ms processing\n", id_,
+                   status == kOk ? "done" : "aborted", (unsigned long long)frames_, processSeconds_ * 1e3);
+    return Step::Done;
+  }
+
+  uint32_t id_;
+  int sock_;
+  SharedJob* shared_;
+  JobRequest req_;
+  EnginePool& pool_;
+  Stats& stats_;
+  std::unique_ptr<Engine> engine_;
+  uint64_t frames_ = 0;
+  double processSeconds_ = 0.0;
+  unsigned idleTurns_ = 0;
+};
+
+// Reads the request and the attached shared-memory descriptor, without
+// waiting: the caller polls for it.
+bool receiveRequest(int sock, JobRequest& req, int& shmFd) {
+  char control[CMSG_SPACE(sizeof(int))] = {};
+  iovec iov { &req, sizeof(req) };
+  msghdr msg {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  shmFd = -1;
+  ssize_t n;
+  do n = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC | MSG_DONTWAIT); while (n < 0 && errno == EINTR);
+  for (cmsghdr* c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c))
+    if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_RIGHTS)
+      std::memcpy(&shmFd, CMSG_DATA(c), sizeof(int));
+  return n == (ssize_t)sizeof(req) && shmFd >= 0;
+}
+
+bool validRequest(const JobRequest& req) {
+  if (req.magic != kMagic || req.version != kVersion) return false;
+  if (req.channels != 1 && req.channels != 2) return false;
+  if (!(req.sampleRate >= 8000.0 && req.sampleRate <= 384000.0)) return false;
+  for (int id = 0; id < SVENDER_PARAM_COUNT; ++id)
+    if ((req.paramMask & (1u << id)) && !(req.params[id] >= 0.0 && req.params[id] <= 1.0)) return false;
+  return true;
+}
+
+SharedJob* mapShared(int fd) {
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(SharedJob)) return nullptr;
+  void* p = mmap(nullptr, sizeof(SharedJob), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (p == MAP_FAILED) return nullptr;
+  auto* shared = (SharedJob*)p;
+  if (shared->magic != kMagic || shared->version != kVersion) {
+    munmap(p, sizeof(SharedJob));
+    return nullptr;
+  }
+  return shared;
+}
+
+// Request and shared region of a connection that polled readable, or null.
+SharedJob* intake(int sock, JobRequest& req) {
+  int shmFd = -1;
+  const bool received = receiveRequest(sock, req, shmFd);
+  SharedJob* shared = (received && validRequest(req)) ? mapShared(shmFd) : nullptr;
+  if (shmFd >= 0) close(shmFd);
+  return shared;
+}
+
+void reject(int sock, Status status) {
+  const JobReply reply { status, 0, 0 };
+  sendAll(sock, &reply, sizeof(reply));
+  close(sock);
+}
+
+int listenOn(const std::string& path) {
+  sockaddr_un addr {};
+  if (path.size() >= sizeof(addr.sun_path)) {
+    std::fprintf(stderr, "reampd: socket path too long: %s\n", path.c_str());
+    return -1;
+  }
+  addr.sun_family = AF_UNIX;
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+  const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+  if (fd < 0) return -1;
+  unlink(path.c_str());
+  const mode_t old = umask(077); // owner only
+  const bool ok = bind(fd, (sockaddr*)&addr, sizeof(addr)) == 0 && listen(fd, 64) == 0;
+  umask(old);
+  if (!ok) {
+    std::fprintf(stderr, "reampd: cannot listen on %s: %s\n", path.c_str(), std::strerror(errno));
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+void onSignal(int) { g_stop.store(true); }
+
+} // namespace
+
+int main(int argc, char** argv) {
+  std::string socketPath = defaultSocketPath();
+  int threads = (int)std::max(1u, std::thread::hardware_concurrency());
+  int warm = 4;
+  double rate = 48000.0;
+  for (int i = 1; i < argc; ++i) {
+    const std::string a = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if (a == "--socket" && hasValue) socketPath = argv[++i];
+    else if (a == "--threads" && hasValue) threads = std::max(1, std::atoi(argv[++i]));
+    else if (a == "--warm" && hasValue) warm = std::max(0, std::atoi(argv[++i]));
+    else if (a == "--rate" && hasValue) rate = std::atof(argv[++i]);
+    else if (a == "--verbose") g_verbose = true;
+    else {
+      std::fprintf(stderr, "usage: reampd [--socket path] [--threads N] [--warm N] [--rate Hz] [--verbose]\n");
+      return 2;
+    }
+  }
+
+  struct sigaction sa {};
+  sa.sa_handler = onSignal;
+  sigaction(SIGINT, &sa, nullptr);
+  sigaction(SIGTERM, &sa, nullptr);
+
+  EnginePool engines((size_t)std::max(warm, threads) * 2);
+  engines.prewarm(rate, warm);
+
+  const int listenFd = listenOn(socketPath);
+  if (listenFd < 0) return 1;
+  std::fprintf(stderr, "reampd: %s, %d workers, %d warm instances at %.0f Hz\n", socketPath.c_str(), threads, warm,
+               rate);
+
+  Stats stats;
+  WorkStealingPool pool(threads);
+  uint32_t nextId = 1;
+
+  // Accepted connections whose request has not arrived yet.
+  struct Waiting {
+    int sock;
+    Clock::time_point deadline;
+  };
+  std::vector<Waiting> waiting;
+  std::vector<pollfd> fds;
+
+  while (!g_stop.load()) {
+    fds.assign(1, pollfd { listenFd, POLLIN, 0 });
+    for (const Waiting& w : waiting)
+      fds.push_back(pollfd { w.sock, POLLIN, 0 });
+    if (poll(fds.data(), fds.size(), 200) < 0) continue;
+    const auto now = Clock::now();
+
+    // Backwards, so the swap-remove only moves entries already handled.
+    for (size_t i = waiting.size(); i-- > 0;) {
+      const Waiting w = waiting[i];
+      const bool ready = fds[i + 1].revents != 0;
+      if (!ready && now < w.deadline) continue;
+      waiting[i] = waiting.back();
+      waiting.pop_back();
+
+      JobRequest req;
+      SharedJob* shared = ready ? intake(w.sock, req) : nullptr;
+      if (!shared) {
+        stats.failed.fetch_add(1, std::memory_order_relaxed);
+        reject(w.sock, kBadRequest);
+        continue;
+      }
+      // The job's own replies are small and may block.
+      fcntl(w.sock, F_SETFL, fcntl(w.sock, F_GETFL) & ~O_NONBLOCK);
+      stats.jobs.fetch_add(1, std::memory_order_relaxed);
+      pool.submit(new Job(nextId++, w.sock, shared, req, engines, stats));
+    }
+
+    if (fds[0].revents & POLLIN) {
+      for (int sock; (sock = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK)) >= 0;)
+        waiting.push_back(Waiting { sock, now + kRequestTimeout });
+    }
+  }
+
+  // Turn away everyone not yet running, including the listen backlog.
+  for (const Waiting& w : waiting)
+    reject(w.sock, kBusy);
+  for (int sock; (sock = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC)) >= 0;)
+    reject(sock, kBusy);
+  close(listenFd);
+  unlink(socketPath.c_str());
+  std::fprintf(stderr, "reampd: finishing %zu jobs\n", pool.pending());
+  pool.shutdown();
+  std::fprintf(stderr, "reampd: %llu jobs (%llu on warm instances, %llu failed), %llu frames\n",
+               (unsigned long long)stats.jobs.load(), (unsigned long long)stats.warm.load(),
+               (unsigned long long)stats.failed.load(), (unsigned long long)stats.frames.load());
+  return 0;
+}